@@ -29,6 +29,8 @@
 
 namespace jcvm {
 
+Context *Context::running_context = nullptr;
+
 /**
  * Default constructor
  *
@@ -36,9 +38,7 @@ namespace jcvm {
  */
 Context::Context(const japplet_ID_t appletID,
                  const jpackage_ID_t packageID) noexcept
-    : applet_ID(appletID), stack(), packagesID(), heap(appletID) {
-  this->packagesID.push_front(packageID);
-}
+    : applet_ID(appletID), stack(), packageID(packageID), heap(appletID) {}
 
 /**
  * Get current context ID.
@@ -46,7 +46,11 @@ Context::Context(const japplet_ID_t appletID,
  * @return current context ID
  */
 jpackage_ID_t Context::getCurrentPackageID() noexcept {
-  return *(this->packagesID.cbegin());
+  if (this->stack.empty()) {
+    return this->packageID;
+  }
+
+  return this->stack.getCurrentFrame().getPackageID();
 }
 
 /**
@@ -80,23 +84,44 @@ Package Context::getCurrentPackage() {
 }
 
 /**
- * Shift the context package ID. This function is call when an invoke
- * instruction is invoked. There, the security context ID does not change but
- * the executed package changed.
+ * Run the garbage collector on the context heap. The roots are taken from
+ * the context stack.
  *
- * @param[packageID] new executed package ID.
+ * @return reclaimed bytes.
  */
-void Context::changePackageID(const jpackage_ID_t packageID) noexcept {
-  this->packagesID.push_front(packageID);
+uint32_t Context::collectGarbage() { return this->heap.collect(this->stack); }
+
+/**
+ * Run the garbage collector if the allocation threshold is crossed. This
+ * function is called by the allocating bytecodes, before the allocation.
+ */
+void Context::collectGarbageIfRequired() {
+  if (this->heap.isCollectionRequired()) {
+    this->collectGarbage();
+  }
 }
 
 /**
- * Shift the context package ID to the caller one. This function is call when
- * a return instruction is executed. There, the security context ID does not
- * change but the executed package changed.
+ * Get the context executed by the interpretor. This context is used by the
+ * native methods which are called without context.
+ *
+ * @return the running context.
+ */
+Context &Context::getRunningContext() {
+  if (Context::running_context == nullptr) {
+    throw Exceptions::SecurityException;
+  }
+
+  return *Context::running_context;
+}
+
+/**
+ * Set the context executed by the interpretor.
+ *
+ * @param[context] the running context.
  */
-void Context::backToPreviousPackageID() noexcept {
-  this->packagesID.pop_front();
+void Context::setRunningContext(Context &context) noexcept {
+  Context::running_context = &context;
 }
 
 } // namespace jcvm
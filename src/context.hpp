@@ -31,7 +31,7 @@
 #include "heap.hpp"
 #include "jc_config.h"
 #include "jc_handlers/package.hpp"
-#include "jcvm_types/list.hpp"
+#include "jc_types/jc_array.hpp"
 #include "stack.hpp"
 #include "types.hpp"
 
@@ -43,12 +43,15 @@ private:
   japplet_ID_t applet_ID;
   /// Current Java Card stack.
   Stack stack;
-  /// Linked-list where the executed Packages ID is stored. The Head of the
-  /// linked-list is the current executed package ID.
-  List<jpackage_ID_t> packagesID;
+  /// Starting package ID. Once a method is invoked, the executed package ID
+  /// is stored in the current frame.
+  jpackage_ID_t packageID;
   /// Context's heap
   Heap heap;
 
+  /// Context executed by the interpretor.
+  static Context *running_context;
+
 public:
   /// Default constructor
   Context(const uint8_t appletID, const jpackage_ID_t packageID) noexcept;
@@ -62,10 +65,15 @@ public:
   Heap &getHeap() noexcept;
   /// Get current current package.
   Package getCurrentPackage();
-  /// Shift context package ID
-  void changePackageID(const uint8_t packageID) noexcept;
-  /// Back to the previous package ID.
-  void backToPreviousPackageID() noexcept;
+  /// Run the garbage collector on the context heap.
+  uint32_t collectGarbage();
+  /// Run the garbage collector if the allocation threshold is crossed.
+  void collectGarbageIfRequired();
+
+  /// Get the context executed by the interpretor.
+  static Context &getRunningContext();
+  /// Set the context executed by the interpretor.
+  static void setRunningContext(Context &context) noexcept;
 };
 
 } // namespace jcvm
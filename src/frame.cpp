@@ -158,6 +158,13 @@ jword_t *Frame::getEOS() const noexcept { return this->eos; }
  */
 pc_t &Frame::getPC() noexcept { return this->pc; }
 
+/**
+ * Return executed package ID.
+ *
+ * @return the package ID where the method is located.
+ */
+jpackage_ID_t Frame::getPackageID() const noexcept { return this->packageID; }
+
 /**
  * Set frame base pointer.
  *
@@ -194,14 +201,30 @@ void Frame::setEOS(jword_t *eos) noexcept { this->eos = eos; }
 void Frame::setPC(pc_t &pc) noexcept { this->pc = pc; }
 
 /**
- * Save PC value for jsr instruction.
+ * Save PC value for jsr instruction. When all the entries are taken, an
+ * entry already restored by a ret instruction is reused.
  *
  * @return the pc index.
  */
-uint8_t Frame::savePC() noexcept {
-  old_pc_t old_pc = {.isUsed = false, .pc = this->pc};
-  this->old_pcs.push_back(old_pc);
-  return (this->old_pcs.size() - 1);
+uint8_t Frame::savePC() {
+  uint8_t index = this->nb_saved_pcs;
+
+  if (index < JCVM_MAX_SAVED_PCS) {
+    this->nb_saved_pcs++;
+  } else {
+    for (index = 0; index < JCVM_MAX_SAVED_PCS; index++) {
+      if (this->saved_pcs[index].isUsed) {
+        break;
+      }
+    }
+
+    if (index == JCVM_MAX_SAVED_PCS) {
+      throw Exceptions::StackOverflowException;
+    }
+  }
+
+  this->saved_pcs[index] = {.isUsed = false, .pc = this->pc.getValue()};
+  return index;
 }
 
 /**
@@ -210,23 +233,31 @@ uint8_t Frame::savePC() noexcept {
  * @param[index] where the PC is located.
  * @return the saved PC.
  */
-pc_t &Frame::restorePC(const uint8_t index)
+pc_t Frame::restorePC(const uint8_t index)
 #if !defined(JCVM_FIREWALL_CHECKS) && !defined(JCVM_ARRAY_SIZE_CHECK)
     noexcept
 #endif
 {
-  old_pc_t &old_pc = this->old_pcs.at(index);
+#ifdef JCVM_ARRAY_SIZE_CHECK
+
+  if (index >= this->nb_saved_pcs) {
+    throw Exceptions::IndexOutOfBoundsException;
+  }
+
+#endif /* JCVM_ARRAY_SIZE_CHECK */
+
+  saved_pc_t &saved_pc = this->saved_pcs[index];
 
 #ifdef JCVM_FIREWALL_CHECKS
 
-  if (old_pc.isUsed) {
+  if (saved_pc.isUsed) {
     throw Exceptions::SecurityException;
   }
 
 #endif /* JCVM_FIREWALL_CHECKS */
 
-  old_pc.isUsed = true;
-  return old_pc.pc;
+  saved_pc.isUsed = true;
+  return pc_t(saved_pc.pc);
 }
 
 }; // namespace jcvm
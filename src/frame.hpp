@@ -30,7 +30,6 @@
 
 #include "exceptions.hpp"
 #include "jc_config.h"
-#include "jcvm_types/list.hpp"
 #include "jcvm_types/pc_t.hpp"
 #include "types.hpp"
 
@@ -38,23 +37,31 @@ namespace jcvm {
 
 class Frame {
 private:
-  struct old_pc_t {
+  struct saved_pc_t {
     bool isUsed;
-    pc_t &pc;
+    const uint8_t *pc;
   };
 
-  jword_t *fp;  // frame base pointer
-  jword_t *op;  // operand stack base pointer
-  jword_t *tos; // top of operand stack
-  jword_t *eos; // end of operand stack (= last operand stack word)
-  pc_t pc;      // method program counter
+  jword_t *fp;             // frame base pointer
+  jword_t *op;             // operand stack base pointer
+  jword_t *tos;            // top of operand stack
+  jword_t *eos;            // end of operand stack (= last operand stack word)
+  pc_t pc;                 // method program counter
+  jpackage_ID_t packageID; // executed package ID
 
-  List<old_pc_t> old_pcs;
+  saved_pc_t saved_pcs[JCVM_MAX_SAVED_PCS]; // jsr return addresses
+  uint8_t nb_saved_pcs;                     // number of saved_pcs entries
 
 public:
+  /// empty frame constructor
+  Frame() noexcept
+      : fp(nullptr), op(nullptr), tos(nullptr), eos(nullptr), pc(nullptr),
+        packageID(0), nb_saved_pcs(0) {}
   /// default constructor
-  Frame(jword_t *fp, jword_t *op, jword_t *tos, jword_t *eos, pc_t &pc) noexcept
-      : fp(fp), op(op), tos(tos), eos(eos), pc(pc) {}
+  Frame(jword_t *fp, jword_t *op, jword_t *tos, jword_t *eos, pc_t &pc,
+        const jpackage_ID_t packageID) noexcept
+      : fp(fp), op(op), tos(tos), eos(eos), pc(pc), packageID(packageID),
+        nb_saved_pcs(0) {}
   // Frame(const Frame &frame) noexcept = default;
   Frame &operator=(const Frame &frame) = default;
   /// Return frame base pointer
@@ -67,6 +74,8 @@ public:
   jword_t *getEOS() const noexcept;
   /// Return method program counter pointer
   pc_t &getPC() noexcept;
+  /// Return executed package ID
+  jpackage_ID_t getPackageID() const noexcept;
   /// Set frame base pointer
   void setFP(jword_t *fp) noexcept;
   /// Set operand stack base pointer
@@ -78,9 +87,9 @@ public:
   /// Set method program counter pointer
   void setPC(pc_t &pc) noexcept;
   /// Save PC value for jsr instruction
-  uint8_t savePC() noexcept;
+  uint8_t savePC();
   /// Restore PC value for ret instruction
-  pc_t &restorePC(const uint8_t index)
+  pc_t restorePC(const uint8_t index)
 #if !defined(JCVM_FIREWALL_CHECKS) && !defined(JCVM_ARRAY_SIZE_CHECK)
       noexcept
 #endif
@@ -26,10 +26,11 @@
 */
 
 #include "heap.hpp"
+#include "debug.hpp"
+#include "jc_handlers/flashmemory_cache.hpp"
 #include "jc_handlers/jc_cp.hpp"
 #include "jc_types/jc_array.hpp"
-
-#include <algorithm>
+#include "slab_allocator.hpp"
 
 namespace jcvm {
 
@@ -59,10 +60,11 @@ jref_t Heap::addArray(const uint16_t nb_entry, const jc_array_type type) {
   jref_t ref;
 
   // Creating and adding new array in the heap.
-  this->arrays.push_back(std::make_shared<JC_Array>(*this, nb_entry, type));
+  uint16_t offset = this->arrays.emplace(*this, nb_entry, type);
+  this->allocated_bytes += Heap::getSize(this->arrays.at(offset));
 
   ref.setAsArray(true);
-  ref.setOffset(this->arrays.size());
+  ref.setOffset(offset);
 
   return ref;
 }
@@ -80,11 +82,12 @@ jref_t Heap::addArray(const uint16_t nb_entry, const jc_array_type type,
   jref_t ref;
 
   // Creating and adding new array in the heap.
-  this->arrays.push_back(
-      std::make_shared<JC_Array>(*this, nb_entry, type, reference_type));
+  uint16_t offset =
+      this->arrays.emplace(*this, nb_entry, type, reference_type);
+  this->allocated_bytes += Heap::getSize(this->arrays.at(offset));
 
   ref.setAsArray(true);
-  ref.setOffset(this->arrays.size());
+  ref.setOffset(offset);
 
   return ref;
 }
@@ -96,14 +99,15 @@ jref_t Heap::addArray(const uint16_t nb_entry, const jc_array_type type,
  *
  * @return reference value.
  */
-jref_t Heap::addArray(JC_Array array) {
+jref_t Heap::addArray(JC_Array &&array) {
   jref_t ref;
 
   // Adding new array in the heap.
-  this->arrays.push_back(std::make_shared<JC_Array>(array));
+  this->allocated_bytes += Heap::getSize(array);
+  uint16_t offset = this->arrays.emplace(std::move(array));
 
   ref.setAsArray(true);
-  ref.setOffset(this->arrays.size());
+  ref.setOffset(offset);
 
   return ref;
 }
@@ -120,11 +124,12 @@ jref_t Heap::addInstance(const jpackage_ID_t packageID,
   jref_t ref;
 
   // Creating and adding new instance in the heap.
-  this->instances.push_back(
-      std::make_shared<JC_Instance>(*this, packageID, instantiated_class));
+  uint16_t offset =
+      this->instances.emplace(*this, packageID, instantiated_class);
+  this->allocated_bytes += Heap::getSize(this->instances.at(offset));
 
   ref.setAsArray(false);
-  ref.setOffset(this->instances.size());
+  ref.setOffset(offset);
 
   return ref;
 }
@@ -134,14 +139,15 @@ jref_t Heap::addInstance(const jpackage_ID_t packageID,
  *
  * @param[instance] pointer to the new instance to add.
  */
-jref_t Heap::addInstance(JC_Instance instance) {
+jref_t Heap::addInstance(JC_Instance &&instance) {
   jref_t ref;
 
-  // Creating and adding new instance in the heap.
-  this->instances.push_back(std::make_shared<JC_Instance>(instance));
+  // Adding new instance in the heap.
+  this->allocated_bytes += Heap::getSize(instance);
+  uint16_t offset = this->instances.emplace(std::move(instance));
 
   ref.setAsArray(false);
-  ref.setOffset(this->instances.size());
+  ref.setOffset(offset);
 
   return ref;
 }
@@ -151,7 +157,7 @@ jref_t Heap::addInstance(JC_Instance instance) {
  *
  * @param[objectref] reference to the objectref to get.
  */
-std::shared_ptr<JC_Array> Heap::getArray(const jref_t objectref)
+Handle<JC_Array> Heap::getArray(const jref_t objectref)
 #ifndef JCVM_SECURE_HEAP_ACCESS
     noexcept
 #endif /* JCVM_SECURE_HEAP_ACCESS */
@@ -169,7 +175,7 @@ std::shared_ptr<JC_Array> Heap::getArray(const jref_t objectref)
 
 #endif /* JCVM_SECURE_HEAP_ACCESS */
 
-  return this->arrays.at(objectref.getOffset() - 1);
+  return this->arrays.at(objectref.getOffset());
 }
 
 /*
@@ -177,7 +183,7 @@ std::shared_ptr<JC_Array> Heap::getArray(const jref_t objectref)
  *
  * @param[objectref] reference to the objectref to get.
  */
-std::shared_ptr<JC_Instance> Heap::getInstance(const jref_t objectref)
+Handle<JC_Instance> Heap::getInstance(const jref_t objectref)
 #ifndef JCVM_SECURE_HEAP_ACCESS
     noexcept
 #endif /* JCVM_SECURE_HEAP_ACCESS */
@@ -195,7 +201,335 @@ std::shared_ptr<JC_Instance> Heap::getInstance(const jref_t objectref)
 
 #endif /* JCVM_SECURE_HEAP_ACCESS */
 
-  return this->instances.at(objectref.getOffset() - 1);
+  return this->instances.at(objectref.getOffset());
+}
+
+/*
+ * Getting the heap object of a persistent object already loaded in the heap.
+ *
+ * @param[tag] persistent object tag.
+ * @return the object reference, if the object is loaded.
+ */
+std::optional<jref_t> Heap::findPersistentObject(const fs::Tag &tag) {
+  this->checkRollbacks();
+
+  const auto it = this->persistent_objects.find(tag);
+
+  if (it == this->persistent_objects.end()) {
+    return std::nullopt;
+  }
+
+  return it->second;
+}
+
+/*
+ * Recording the heap object of a persistent object loaded in the heap.
+ *
+ * @param[tag] persistent object tag.
+ * @param[objectref] reference to the loaded object.
+ */
+void Heap::addPersistentObject(const fs::Tag &tag, const jref_t objectref) {
+  this->checkRollbacks();
+  this->persistent_objects[tag] = objectref;
+}
+
+/*
+ * Forgetting the heap object of a persistent object, once the persistent
+ * object is overwritten. The heap object is reclaimed by the next collection
+ * if it is no more reachable.
+ *
+ * @param[tag] persistent object tag.
+ */
+void Heap::removePersistentObject(const fs::Tag &tag) noexcept {
+  this->persistent_objects.erase(tag);
+}
+
+/*
+ * Forgetting the heap objects of all the persistent objects, and the RAM
+ * objects stored in the persistent memory, once the persistent memory is
+ * restored. The heap objects are reclaimed by the next collection if they
+ * are no more reachable.
+ */
+void Heap::removePersistentObjects() noexcept {
+  this->persistent_objects.clear();
+  this->stored_objects.clear();
+}
+
+/*
+ * Forgetting the heap objects of the persistent objects, once a persistent
+ * memory journal is rolled back since the last check: they may hold the
+ * dropped journal writes. The journal may be rolled back by a write which
+ * does not fit in it, or during another context.
+ */
+void Heap::checkRollbacks() noexcept {
+  const uint32_t rollbacks = FlashMemory_Cache::getRollbacks();
+
+  if (this->rollbacks != rollbacks) {
+    this->rollbacks = rollbacks;
+    this->removePersistentObjects();
+  }
+}
+
+/*
+ * Get the number of modifications of an object.
+ *
+ * @param[objectref] object reference.
+ * @return the object version.
+ */
+uint32_t Heap::getVersion(const jref_t objectref) {
+  if (objectref.isArray()) {
+    return this->getArray(objectref)->getVersion();
+  }
+
+  return this->getInstance(objectref)->getVersion();
+}
+
+/*
+ * Is a RAM object unchanged since it was stored at a tag?
+ *
+ * @param[tag] persistent object tag.
+ * @param[objectref] stored object reference.
+ * @return true if the tag data is the object one.
+ */
+bool Heap::isStoredObject(const fs::Tag &tag, const jref_t objectref) {
+  if (objectref.isNullPointer()) {
+    return false;
+  }
+
+  this->checkRollbacks();
+
+  const auto it = this->stored_objects.find(tag);
+
+  return (it != this->stored_objects.end()) &&
+         (it->second.objectref == objectref) &&
+         (it->second.version == this->getVersion(objectref));
+}
+
+/*
+ * Recording a RAM object stored at a tag, with its current version.
+ *
+ * @param[tag] persistent object tag.
+ * @param[objectref] stored object reference.
+ */
+void Heap::addStoredObject(const fs::Tag &tag, const jref_t objectref) {
+  this->checkRollbacks();
+  this->stored_objects[tag] = {objectref, this->getVersion(objectref)};
+}
+
+/*
+ * Forgetting the RAM object stored at a tag, once the tag data is written
+ * by other means.
+ *
+ * @param[tag] persistent object tag.
+ */
+void Heap::removeStoredObject(const fs::Tag &tag) noexcept {
+  this->stored_objects.erase(tag);
+}
+
+/*
+ * Get the heap footprint of an array. The entries of a persistent array are
+ * stored in the flash memory and are not counted.
+ *
+ * @param[array] array to measure.
+ * @return array footprint in bytes.
+ */
+uint32_t Heap::getSize(const JC_Array &array) {
+  if (array.isPersistent() && !array.isTransientArray()) {
+    return sizeof(JC_Array);
+  }
+
+  return sizeof(JC_Array) + (uint32_t)array.size() * array.getEntrySize();
+}
+
+/*
+ * Get the heap footprint of an instance. The fields of a persistent instance
+ * are stored in the flash memory and are not counted.
+ *
+ * @param[instance] instance to measure.
+ * @return instance footprint in bytes.
+ */
+uint32_t Heap::getSize(const JC_Instance &instance) {
+  if (instance.isPersistent()) {
+    return sizeof(JC_Instance);
+  }
+
+  const uint32_t nb_fields = instance.getNumberOfFields();
+
+#ifdef JCVM_TYPED_HEAP
+  return sizeof(JC_Instance) + nb_fields * sizeof(jword_t) +
+         (nb_fields + 1) / 2;
+#else  /* !JCVM_TYPED_HEAP */
+  return sizeof(JC_Instance) + nb_fields * sizeof(jword_t);
+#endif /* JCVM_TYPED_HEAP */
+}
+
+/*
+ * Mark a reachable object. Values which are not a reference to a live object
+ * of this heap are ignored: stack words and, without JCVM_TYPED_HEAP, instance
+ * fields are untyped, they are conservatively handled as references.
+ *
+ * @param[objectref] reference to the reached object.
+ */
+void Heap::mark(const jref_t objectref) noexcept {
+  const uint16_t offset = objectref.getOffset();
+
+  if (objectref.isNullPointer()) {
+    return;
+  }
+
+  if (objectref.isArray()) {
+    if (!this->arrays.contains(offset) || this->marked_arrays[offset]) {
+      return;
+    }
+
+    this->marked_arrays[offset] = true;
+  } else {
+    if (!this->instances.contains(offset) || this->marked_instances[offset]) {
+      return;
+    }
+
+    this->marked_instances[offset] = true;
+  }
+
+  this->to_scan.push_back(objectref);
+}
+
+/*
+ * Mark the objects referenced by a reachable object. The references stored
+ * in persistent objects are located in the flash memory, they are read back
+ * in the heap each time they are fetched.
+ *
+ * @param[objectref] reference to the reached object.
+ */
+void Heap::scan(const jref_t objectref) {
+  if (objectref.isArray()) {
+    JC_Array &array = this->arrays.at(objectref.getOffset());
+
+    if ((array.isPersistent() && !array.isTransientArray()) ||
+        (array.getType() != jc_array_type::JAVA_ARRAY_T_REFERENCE)) {
+      return;
+    }
+
+    for (uint16_t index = 0; index < array.size(); index++) {
+      this->mark(array.getReferenceEntry(index));
+    }
+  } else {
+    const JC_Instance &instance = this->instances.at(objectref.getOffset());
+
+    if (instance.isPersistent()) {
+      return;
+    }
+
+    const auto fields = instance.getFields();
+
+    for (uint16_t index = 0; index < fields->size(); index++) {
+#ifdef JCVM_TYPED_HEAP
+      if (!isReferenceFieldType(instance.getFieldType(index))) {
+        continue;
+      }
+#endif /* JCVM_TYPED_HEAP */
+
+      this->mark(jref_t(fields->at(index)));
+    }
+  }
+}
+
+/*
+ * Is the allocation threshold crossed since the last collection? The heap
+ * occupancy is not checked: once the live objects fill the heap, each
+ * allocation would run a collection reclaiming nothing.
+ *
+ * @return true if a collection should be run.
+ */
+bool Heap::isCollectionRequired() const noexcept {
+  return this->allocated_bytes >= JCVM_GC_THRESHOLD;
+}
+
+/*
+ * Reclaim the objects of this heap which are unreachable. The roots are the
+ * locals and the operand stacks of all the stack frames, and the transient
+ * arrays. Static fields are stored in the flash memory and hold no heap
+ * reference.
+ *
+ * This function must be called when no reference is only held by the
+ * interpreter (between two bytecodes or from a native method).
+ *
+ * @param[stack] Java Card stack of the context owning this heap.
+ * @return reclaimed bytes.
+ */
+uint32_t Heap::collect(const Stack &stack) {
+  uint32_t reclaimed_bytes = 0;
+
+  this->marked_arrays.assign(this->arrays.capacity() + 1, false);
+  this->marked_instances.assign(this->instances.capacity() + 1, false);
+  this->to_scan.clear();
+
+  // Mark phase
+  for (const jword_t word : stack) {
+    this->mark(jref_t(word));
+  }
+
+  for (uint16_t handle = 1; handle <= this->arrays.capacity(); handle++) {
+    if (this->arrays.contains(handle) &&
+        this->arrays.at(handle).isTransientArray()) {
+      jref_t ref;
+
+      ref.setAsArray(true);
+      ref.setOffset(handle);
+      this->mark(ref);
+    }
+  }
+
+  while (!this->to_scan.empty()) {
+    const jref_t objectref = this->to_scan.back();
+
+    this->to_scan.pop_back();
+    this->scan(objectref);
+  }
+
+  // Sweep phase
+  for (uint16_t handle = 1; handle <= this->arrays.capacity(); handle++) {
+    if (this->arrays.contains(handle) && !this->marked_arrays[handle]) {
+      reclaimed_bytes += Heap::getSize(this->arrays.at(handle));
+      this->arrays.remove(handle);
+    }
+  }
+
+  for (uint16_t handle = 1; handle <= this->instances.capacity(); handle++) {
+    if (this->instances.contains(handle) && !this->marked_instances[handle]) {
+      reclaimed_bytes += Heap::getSize(this->instances.at(handle));
+      this->instances.remove(handle);
+    }
+  }
+
+  const auto isMarked = [this](const jref_t objectref) {
+    return objectref.isArray() ? this->marked_arrays[objectref.getOffset()]
+                               : this->marked_instances[objectref.getOffset()];
+  };
+
+  // Reclaimed persistent objects are loaded again on their next access.
+  for (auto it = this->persistent_objects.begin();
+       it != this->persistent_objects.end();) {
+    it = isMarked(it->second) ? std::next(it)
+                              : this->persistent_objects.erase(it);
+  }
+
+  for (auto it = this->stored_objects.begin();
+       it != this->stored_objects.end();) {
+    it = isMarked(it->second.objectref) ? std::next(it)
+                                        : this->stored_objects.erase(it);
+  }
+
+  this->allocated_bytes = 0;
+  Slab_Allocator::releaseEmptySlabs();
+
+  TRACE_JCVM_DEBUG("GC: %u bytes reclaimed, %u bytes used, %u/%u heap bytes "
+                   "reserved",
+                   reclaimed_bytes, Slab_Allocator::getStats().used_bytes,
+                   Slab_Allocator::getStats().reserved_bytes,
+                   (uint32_t)JCVM_MAX_HEAP_SIZE);
+
+  return reclaimed_bytes;
 }
 
 } // namespace jcvm
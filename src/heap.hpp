@@ -31,14 +31,19 @@
 #include "exceptions.hpp"
 #include "jc_config.h"
 #include "jc_handlers/flashmemory.hpp"
+#include "jc_handlers/fs_tag.hpp"
 #include "jc_types/jc_array_type.hpp"
 #include "jc_types/jc_instance.hpp"
 #include "jc_types/jref_t.hpp"
 #include "jc_utils.hpp"
-#include "jcvm_types/list.hpp"
+#include "jcvm_types/handle.hpp"
+#include "jcvm_types/slot_table.hpp"
+#include "stack.hpp"
 #include "types.hpp"
 
-#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 
 namespace jcvm {
 
@@ -49,10 +54,48 @@ private:
   ///
   const japplet_ID_t owner;
 
-  /// List of array in the heap.
-  List<std::shared_ptr<JC_Array>> arrays;
-  /// List of instance in the heap.
-  List<std::shared_ptr<JC_Instance>> instances;
+  /// Arrays owned by the heap, indexed by reference offset.
+  SlotTable<JC_Array> arrays;
+  /// Instances owned by the heap, indexed by reference offset.
+  SlotTable<JC_Instance> instances;
+
+  /// Persistent objects loaded in the heap, indexed by tag.
+  std::unordered_map<fs::Tag, jref_t, fs::TagHash> persistent_objects;
+
+  /// RAM object stored in the persistent memory
+  struct StoredObject {
+    /// Stored object
+    jref_t objectref;
+    /// Object version when it was stored
+    uint32_t version;
+  };
+
+  /// RAM objects stored in the persistent memory, indexed by tag.
+  std::unordered_map<fs::Tag, StoredObject, fs::TagHash> stored_objects;
+  /// Rolled back persistent memory journals, when the tables were checked.
+  uint32_t rollbacks = 0;
+
+  /// Bytes allocated since the last collection.
+  uint32_t allocated_bytes = 0;
+  /// Arrays reached during the current collection, indexed by handle.
+  std::vector<bool> marked_arrays;
+  /// Instances reached during the current collection, indexed by handle.
+  std::vector<bool> marked_instances;
+  /// Reached objects whose references are not yet marked.
+  std::vector<jref_t> to_scan;
+
+  /// Get the heap footprint of an array.
+  static uint32_t getSize(const JC_Array &array);
+  /// Get the heap footprint of an instance.
+  static uint32_t getSize(const JC_Instance &instance);
+  /// Get the number of modifications of an object.
+  uint32_t getVersion(const jref_t objectref);
+  /// Forget the persistent objects read during a rolled back journal.
+  void checkRollbacks() noexcept;
+  /// Mark a reachable object.
+  void mark(const jref_t objectref) noexcept;
+  /// Mark the objects referenced by a reachable object.
+  void scan(const jref_t objectref);
 
   /// Getting field reference from an instance reference.
   // jc_field_t &getFieldFromInstanceRef(jref_t objectref, uint16_t index);
@@ -70,26 +113,47 @@ public:
   jref_t addArray(const uint16_t nb_entry, const jc_array_type type,
                   const jc_cp_offset_t array_reference_type);
   /// Adding an array in in the transient heap.
-  jref_t addArray(JC_Array array);
+  jref_t addArray(JC_Array &&array);
   /// Adding new instance in the transient heap.
   jref_t addInstance(const jpackage_ID_t packageID,
                      const jclass_index_t instantiated_class);
   /// Adding an instance in in the transient heap.
-  jref_t addInstance(JC_Instance intance);
+  jref_t addInstance(JC_Instance &&instance);
 
   /// Getting array from the transient heap.
-  std::shared_ptr<JC_Array> getArray(const jref_t objectref)
+  Handle<JC_Array> getArray(const jref_t objectref)
 #ifndef JCVM_SECURE_HEAP_ACCESS
       noexcept
 #endif /* JCVM_SECURE_HEAP_ACCESS */
       ;
 
   /// Getting instance from the transient heap.
-  std::shared_ptr<JC_Instance> getInstance(const jref_t objectref)
+  Handle<JC_Instance> getInstance(const jref_t objectref)
 #ifndef JCVM_SECURE_HEAP_ACCESS
       noexcept
 #endif /* JCVM_SECURE_HEAP_ACCESS */
       ;
+
+  /// Getting the heap object of a loaded persistent object.
+  std::optional<jref_t> findPersistentObject(const fs::Tag &tag);
+  /// Recording the heap object of a loaded persistent object.
+  void addPersistentObject(const fs::Tag &tag, const jref_t objectref);
+  /// Forgetting the heap object of a persistent object.
+  void removePersistentObject(const fs::Tag &tag) noexcept;
+  /// Forgetting the heap objects of all the persistent objects.
+  void removePersistentObjects() noexcept;
+
+  /// Is a RAM object unchanged since it was stored at a tag?
+  bool isStoredObject(const fs::Tag &tag, const jref_t objectref);
+  /// Recording a RAM object stored at a tag.
+  void addStoredObject(const fs::Tag &tag, const jref_t objectref);
+  /// Forgetting the RAM object stored at a tag.
+  void removeStoredObject(const fs::Tag &tag) noexcept;
+
+  /// Is the allocation threshold crossed since the last collection?
+  bool isCollectionRequired() const noexcept;
+  /// Reclaim the objects unreachable from the stack and the transient arrays.
+  uint32_t collect(const Stack &stack);
 };
 
 } // namespace jcvm
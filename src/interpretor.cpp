@@ -27,6 +27,7 @@
 
 #include "interpretor.hpp"
 #include "debug.hpp"
+#include "jc_bytecodes/bytecode_handlers.hpp"
 #include "jc_bytecodes/bytecode_values.hpp"
 #include "jc_bytecodes/bytecodes.hpp"
 #include "jc_handlers/flashmemory.hpp"
@@ -52,10 +53,9 @@ Interpretor::Interpretor(
     const japplet_ID_t appletID, const jpackage_ID_t selectedPackageID,
     const uint8_t selectedClass, const uint8_t method,
     bool isStaticMethod) noexcept(noexcept(std::declval<List<Context> &>()
-                                               .push_back(std::declval<
-                                                          Context &>()))) {
-  Context context(appletID, selectedPackageID);
-  this->contexts.push_back(context);
+                                           .emplace_back(
+                                               appletID, selectedPackageID))) {
+  this->contexts.emplace_back(appletID, selectedPackageID);
 
   this->startingClass = selectedClass;
   this->startingMethod = method;
@@ -70,6 +70,8 @@ void Interpretor::run() noexcept {
   Context &context = this->getCurrentContext();
   Package package = context.getCurrentPackage();
 
+  Context::setRunningContext(context);
+
   TRACE_JCVM_DEBUG("Executing starting applet");
 
   Method_Handler methodHandler(context);
@@ -91,6 +93,23 @@ void Interpretor::run() noexcept {
 
   Stack &stack = context.getStack();
 
+#ifdef JCVM_THREADED_DISPATCH
+
+  //  the interpretor runs until the Java Card stack is empty
+  while (stack.empty() == false) {
+    // The exception handler is only set up again when a Java Card exception
+    // was thrown.
+    try {
+      this->dispatch(context);
+    } catch (Exceptions e) {
+      this->startJCVMException(e);
+    } catch (...) {
+      this->startJCVMException(Exceptions::SecurityException);
+    }
+  }
+
+#else /* !JCVM_THREADED_DISPATCH */
+
   //  the interpretor runs until the Java Card stack is empty
   while (stack.empty() == false) {
     // fetch: reading byte code value
@@ -118,7 +137,58 @@ void Interpretor::run() noexcept {
       this->startJCVMException(Exceptions::SecurityException);
     }
   }
+
+#endif /* JCVM_THREADED_DISPATCH */
+}
+
+#ifdef JCVM_THREADED_DISPATCH
+/**
+ * Execute bytecodes until the Java Card stack is empty.
+ *
+ * Handlers are picked from the bytecode_handlers table built at compile
+ * time. With GCC-compatible compilers, the dispatch is direct-threaded:
+ * each handler call is followed by its own fetch and computed goto to the
+ * next one.
+ *
+ * @param[context] context where bytecodes are executed.
+ */
+void Interpretor::dispatch(Context &context) {
+  Stack &stack = context.getStack();
+  Bytecodes bytecodes(context);
+
+#if defined(__GNUC__)
+
+#define JCVM_OPCODE_LABEL_ADDRESS(opcode) &&opcode_##opcode,
+#define JCVM_OPCODE_LABEL(opcode)                                              \
+  opcode_##opcode : (bytecodes.*bytecode_handlers[0x##opcode])();              \
+  JCVM_NEXT_OPCODE();
+#define JCVM_NEXT_OPCODE()                                                     \
+  do {                                                                         \
+    if (stack.empty()) {                                                       \
+      return;                                                                  \
+    }                                                                          \
+    goto *opcode_labels[stack.getPC().getNextByte()];                          \
+  } while (0)
+
+  static void *const opcode_labels[] = {
+      JCVM_FOR_EACH_OPCODE(JCVM_OPCODE_LABEL_ADDRESS)};
+
+  JCVM_NEXT_OPCODE();
+  JCVM_FOR_EACH_OPCODE(JCVM_OPCODE_LABEL)
+
+#undef JCVM_NEXT_OPCODE
+#undef JCVM_OPCODE_LABEL
+#undef JCVM_OPCODE_LABEL_ADDRESS
+
+#else /* !defined(__GNUC__) */
+
+  while (stack.empty() == false) {
+    (bytecodes.*bytecode_handlers[stack.getPC().getNextByte()])();
+  }
+
+#endif /* defined(__GNUC__) */
 }
+#endif /* JCVM_THREADED_DISPATCH */
 
 /**
  * Get the current context
@@ -43,8 +43,8 @@ public:
       const japplet_ID_t appletID, const jpackage_ID_t selectedPackageID,
       const uint8_t selectedClass, const uint8_t method,
       bool isStaticMethod) noexcept(noexcept(std::declval<List<Context> &>()
-                                                 .push_back(std::declval<
-                                                            Context &>())));
+                                             .emplace_back(
+                                                 appletID, selectedPackageID)));
 
   /// Run the Java Card Interpretor.
   void run() noexcept; // All exceptions must be handling there.
@@ -61,6 +61,11 @@ private:
   /// Class and method where the interpretor start.
   uint8_t startingClass, startingMethod;
   bool isStaticStatingMethod;
+
+#ifdef JCVM_THREADED_DISPATCH
+  /// Execute bytecodes until the Java Card stack is empty.
+  void dispatch(Context &context);
+#endif /* JCVM_THREADED_DISPATCH */
 };
 
 } // namespace jcvm
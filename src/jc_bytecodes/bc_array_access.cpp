@@ -99,6 +99,8 @@ void Bytecodes::bc_newarray() {
     throw Exceptions::NegativeArraySizeException;
   }
 
+  context.collectGarbageIfRequired();
+
   array_ref = heap.addArray(count, (jc_array_type)atype);
   stack.push_Reference(array_ref);
 
@@ -159,6 +161,8 @@ void Bytecodes::bc_anewarray() {
     throw Exceptions::NegativeArraySizeException;
   }
 
+  context.collectGarbageIfRequired();
+
   array_ref = heap.addArray(count, JAVA_ARRAY_T_REFERENCE, index);
   stack.push_Reference(array_ref);
 
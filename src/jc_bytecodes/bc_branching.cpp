@@ -873,13 +873,14 @@ void Bytecodes::bc_jsr() {
 
   TRACE_JCVM_DEBUG("JSR 0x%04X", branch);
 
+  // The return address is the instruction following this jsr instruction.
+  ret_addr = stack.savePC();
+  stack.push_ReturnAddress(ret_addr);
+
   // NOTE: -2 because of the branch offset value and -1 due to getNextByte
   // function increases the PC after reading.
   pc.updateFromOffset(branch - 3);
 
-  ret_addr = stack.savePC();
-  stack.push_ReturnAddress(ret_addr);
-
   return;
 }
 
@@ -40,6 +40,7 @@
 #include "../jc_handlers/jc_import.hpp"
 #include "../jc_handlers/jc_method.hpp"
 #include "../jc_handlers/package.hpp"
+#include "../jc_handlers/package_registry.hpp"
 #include "../stack.hpp"
 #include "bytecodes.hpp"
 
@@ -125,25 +126,61 @@ void Bytecodes::bc_invokevirtual() {
   Class_Handler class_handler(this->context.getCurrentPackage());
   pc_t &pc = stack.getPC();
 
+  InlineCache &inline_cache = Package_Registry::getInlineCache(
+      this->context.getCurrentPackageID(), pc.getValue());
+
   uint16_t index = pc.getNextShort();
 
   TRACE_JCVM_DEBUG("INVOKEVIRTUAL 0x%04X", index);
 
   auto virtual_method_ref_info = cp_handler.getVirtualMethodRef(index);
-  auto method_offset = class_handler.getMethodOffset(virtual_method_ref_info);
 
-  // Calling the method and updating PC value
-  method_handler.setPackage(method_offset.first);
-  method_handler.callVirtualMethod(method_offset.second);
+  if (inline_cache.getNargs() == 0) {
+    // The referenced method gives the arguments words of the call site.
+    auto method = class_handler.getVirtualMethod(virtual_method_ref_info);
+    inline_cache.setNargs(Method_Handler::getMethodNargs(method.second));
+  }
 
   // checking if the this reference is non NULL
-  jref_t objectref = stack.readLocal_Reference((uint8_t)0);
+  jref_t objectref = stack.get_Pushed_Element(inline_cache.getNargs());
 
   if (objectref.isNullPointer()) {
     throw Exceptions::NullPointerException;
   }
 
+  if (objectref.isArray()) {
+    // Arrays only inherit the methods of the Object class.
+    auto method = class_handler.getVirtualMethod(virtual_method_ref_info);
+    method_handler.setPackage(method.first);
+    method_handler.callVirtualMethod(method.second);
+    return;
+  }
+
   auto instance = context.getHeap().getInstance(objectref);
+  const InlineCache::Entry *cached = inline_cache.lookup(
+      instance->getPackageID(), instance->getClassIndex());
+
+  if (cached == nullptr) { // Resolving the method from the receiver class
+    jc_cap_class_ref receiver_classref;
+    receiver_classref.internal_classref = HTONS(instance->getClassIndex());
+
+    auto receiver_class =
+        ConstantPool_Handler(Package(instance->getPackageID()))
+            .classref2class(receiver_classref);
+    auto method = class_handler.getVirtualMethod(receiver_class,
+                                                 virtual_method_ref_info);
+
+    cached = inline_cache.update({
+        .receiver_packageID = instance->getPackageID(),
+        .receiver_class = instance->getClassIndex(),
+        .packageID = method.first.getPackageID(),
+        .method = method.second,
+    });
+  }
+
+  // Calling the method and updating PC value
+  method_handler.setPackage(Package(cached->packageID));
+  method_handler.callVirtualMethod(cached->method);
 
   return;
 }
@@ -216,7 +253,7 @@ void Bytecodes::bc_invokespecial() {
   Method_Handler method_handler(context);
   Class_Handler class_handler(context.getCurrentPackage());
 
-  uint16_t method_offset;
+  const uint8_t *method_to_call;
   pc_t &pc = stack.getPC();
 
   uint16_t index = pc.getNextShort();
@@ -234,15 +271,14 @@ void Bytecodes::bc_invokespecial() {
     {
       jc_cap_static_method_ref_info method_ref =
           cp_entry.info.static_method_ref_info;
+      uint16_t method_offset;
 
       if (IS_CP_INTERNAL_REF(method_ref.static_method_ref)) {
         method_offset = HTONS(method_ref.static_method_ref.internal_ref.offset);
       } else { // Is external static method ref
         Import_Handler imported(context.getCurrentPackage());
-        const jc_cap_package_info *package_aid = imported.getPackageAID(
-            method_ref.static_method_ref.external_ref.package_token & 0x7F);
-
-        Package exported_package(imported.getPackageIndex(package_aid));
+        Package exported_package(imported.getPackageIndexFromOffset(
+            method_ref.static_method_ref.external_ref.package_token));
         Export_Handler export_handler(exported_package);
 
         method_offset = export_handler.getExportedStaticMethodOffset(
@@ -250,6 +286,8 @@ void Bytecodes::bc_invokespecial() {
             method_ref.static_method_ref.external_ref.token);
         method_handler.setPackage(exported_package);
       }
+
+      method_to_call = method_handler.getMethodFromOffset(method_offset);
     }
     break;
 
@@ -274,9 +312,9 @@ void Bytecodes::bc_invokespecial() {
 
 #endif /* JCVM_DYNAMIC_CHECKS_CAP */
 
-    auto method = class_handler.getMethodOffset(virtual_method_ref_info);
+    auto method = class_handler.getVirtualMethod(virtual_method_ref_info);
     method_handler.setPackage(method.first);
-    method_offset = method.second;
+    method_to_call = method.second;
   } break;
 
   default:
@@ -286,7 +324,7 @@ void Bytecodes::bc_invokespecial() {
   }
 
   //  Calling the method
-  method_handler.callVirtualMethod(method_offset);
+  method_handler.callVirtualMethod(method_to_call);
 
   // checking if the this reference is non NULL
   jref_t objectref = stack.readLocal_Reference((uint8_t)0);
@@ -350,45 +388,18 @@ void Bytecodes::bc_invokestatic() {
   Stack &stack = context.getStack();
   ConstantPool_Handler cp_handler(context.getCurrentPackage());
   Method_Handler method_handler(context);
-  Class_Handler class_handler(context.getCurrentPackage());
 
-  uint16_t method_offset;
   pc_t &pc = stack.getPC();
 
   uint16_t index = pc.getNextShort();
 
   TRACE_JCVM_DEBUG("INVOKESTATIC 0x%04X", index);
 
-  auto cp_entry = cp_handler.getCPEntry(index);
-
-  if (cp_entry.tag != JC_CP_TAG_CONSTANT_STATICMETHODREF) {
-    throw Exceptions::SecurityException;
-  }
-
-  jc_cap_static_method_ref_info method_ref =
-      cp_entry.info.static_method_ref_info;
-
-  if (IS_CP_INTERNAL_REF(method_ref.static_method_ref)) {
-    method_offset = method_ref.static_method_ref.internal_ref.offset
-                    // remove handler_count element's size
-                    - sizeof(jc_cap_method_component::handler_count);
-  } else { // Is external static method ref
-    Import_Handler imported(context.getCurrentPackage());
-    const jc_cap_package_info *package_aid = imported.getPackageAID(
-        method_ref.static_method_ref.external_ref.package_token & 0x7F);
-
-    Package exported_package(imported.getPackageIndex(package_aid));
-    Export_Handler export_handler(exported_package);
-
-    method_offset = export_handler.getExportedStaticMethodOffset(
-        method_ref.static_method_ref.external_ref.class_token,
-        method_ref.static_method_ref.external_ref.token);
-
-    method_handler.setPackage(exported_package);
-  }
+  auto method = cp_handler.getResolvedStaticMethod(index);
+  method_handler.setPackage(method.first);
 
   // Calling the method
-  method_handler.callStaticMethod(method_offset);
+  method_handler.callStaticMethod(method.second);
 
   return;
 }
@@ -479,6 +490,9 @@ void Bytecodes::bc_invokeinterface() {
 
   pc_t &pc = stack.getPC();
 
+  InlineCache &inline_cache = Package_Registry::getInlineCache(
+      context.getCurrentPackageID(), pc.getValue());
+
   TRACE_JCVM_DEBUG("INVOKEINTERFACE");
 
   uint8_t nargs = pc.getNextByte();
@@ -489,7 +503,7 @@ void Bytecodes::bc_invokeinterface() {
     throw Exceptions::SecurityException;
   }
 
-  auto interface_ref = cp_handler.getClassRef(index);
+  auto interface = cp_handler.getResolvedClassref(index);
 
   // nargs-th arguments should be popped to access the objectref.
   jref_t objectref = stack.get_Pushed_Element(nargs);
@@ -504,23 +518,39 @@ void Bytecodes::bc_invokeinterface() {
     auto instance = context.getHeap().getInstance(thisref);
     auto classref = ConstantPool_Handler(instance->getPackageID())
                         .getClassRefFromClassIndex(instance->getClassIndex());
-    auto method_offset = class_handler.getImplementedInterfaceMethodOffset(
-        classref, interface_ref, method, true);
+    auto method_to_call = Class_Handler::getInterfaceMethod(
+        class_handler.getObjectClassFromAnObjectRef(classref), interface,
+        method);
     // Calling the method
-    method_handler.setPackage(method_offset.first);
-    method_handler.callVirtualMethod(method_offset.second);
+    method_handler.setPackage(method_to_call.first);
+    method_handler.callVirtualMethod(method_to_call.second);
 
   } else { // is an interface
     auto instance = context.getHeap().getInstance(objectref);
+    const InlineCache::Entry *cached = inline_cache.lookup(
+        instance->getPackageID(), instance->getClassIndex());
+
+    if (cached == nullptr) {
+      Package receiver_package(instance->getPackageID());
+      ConstantPool_Handler receiver_cp(receiver_package);
+      auto receiver_class = std::make_pair(
+          receiver_package,
+          receiver_cp.getClassFromClassIndex(instance->getClassIndex()));
+
+      auto method_to_call =
+          Class_Handler::getInterfaceMethod(receiver_class, interface, method);
+
+      cached = inline_cache.update({
+          .receiver_packageID = instance->getPackageID(),
+          .receiver_class = instance->getClassIndex(),
+          .packageID = method_to_call.first.getPackageID(),
+          .method = method_to_call.second,
+      });
+    }
 
-    auto classref = ConstantPool_Handler(instance->getPackageID())
-                        .getClassRefFromClassIndex(instance->getClassIndex());
-
-    auto method_offset = class_handler.getImplementedInterfaceMethodOffset(
-        classref, interface_ref, method);
     // Calling the method
-    method_handler.setPackage(method_offset.first);
-    method_handler.callVirtualMethod(method_offset.second);
+    method_handler.setPackage(Package(cached->packageID));
+    method_handler.callVirtualMethod(cached->method);
   }
 
   return;
@@ -85,6 +85,8 @@ void Bytecodes::bc_new() {
   ConstantPool_Handler cp(context.getCurrentPackage());
   auto instantiated_class = cp.getClassInformation(index);
 
+  context.collectGarbageIfRequired();
+
   jref_t objectref =
       heap.addInstance(instantiated_class.first, instantiated_class.second);
   stack.push_Reference(objectref);
@@ -111,23 +113,24 @@ jbool_t Bytecodes::docheck(const jref_t objectref, const uint8_t atype,
   if (atype == 0) {
     auto instance = heap.getInstance(objectref);
 
-    std::pair<jpackage_ID_t, jclass_index_t> type_in_classinfo =
-        ConstantPool_Handler(instance->getPackageID())
-            .getClassInformation(instance->getClassIndex());
+    // The instance class index is already resolved at instantiation.
+    Package type_in_package(instance->getPackageID());
     auto type_in_ref = std::make_pair(
-        type_in_classinfo.first,
+        type_in_package,
         reinterpret_cast<const uint8_t *>(
-            ConstantPool_Handler(type_in_classinfo.first)
-                .getClassFromClassIndex(type_in_classinfo.second)));
+            ConstantPool_Handler(type_in_package)
+                .getClassFromClassIndex(instance->getClassIndex())));
+
+    auto type_out_ref = ConstantPool_Handler(context.getCurrentPackage())
+                            .getResolvedClassref(index);
 
-    auto type_out_classref =
-        ConstantPool_Handler(context.getCurrentPackage()).getClassRef(index);
-    auto [type_out_package, type_out_class] =
-        ConstantPool_Handler(context.getCurrentPackage())
-            .classref2class(type_out_classref);
+#ifdef JCVM_DYNAMIC_CHECKS_CAP
 
-    auto type_out_ref = std::make_pair(
-        type_out_package, reinterpret_cast<const uint8_t *>(type_out_class));
+    if (IS_INTERFACE(type_out_ref.second)) { // Classref is an interface!
+      throw Exceptions::SecurityException;
+    }
+
+#endif /* JCVM_DYNAMIC_CHECKS_CAP */
 
     return Class_Handler::docheckcast(type_in_ref, type_out_ref);
 
@@ -169,12 +172,9 @@ jbool_t Bytecodes::docheck(const jref_t objectref, const uint8_t atype,
       auto current_package = context.getCurrentPackage();
       ConstantPool_Handler constantpool_handler(current_package);
 
-      auto type_in_ref = constantpool_handler.getClassRef(type_in);
-      auto type_out_ref = constantpool_handler.getClassRef(type_out);
-
       return Class_Handler::docheckcast(
-          constantpool_handler.resolveClassref(type_in_ref),
-          constantpool_handler.resolveClassref(type_out_ref));
+          constantpool_handler.getResolvedClassref(type_in),
+          constantpool_handler.getResolvedClassref(type_out));
     }
     }
   }
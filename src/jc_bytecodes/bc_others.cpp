@@ -109,4 +109,18 @@ void Bytecodes::bc_impdep2() {
   return;
 }
 
+/**
+ * Unsupported instruction
+ *
+ * Description:
+ *
+ *   The opcode value is not defined or not supported by this virtual
+ *   machine.
+ */
+void Bytecodes::bc_unsupported() {
+  TRACE_JCVM_DEBUG("UNSUPPORTED");
+
+  throw Exceptions::SecurityException;
+}
+
 } // namespace jcvm
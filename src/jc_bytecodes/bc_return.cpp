@@ -63,7 +63,6 @@ void Bytecodes::bc_areturn() {
   returned_value = stack.pop_Reference();
 
   stack.pop_Frame();
-  context.backToPreviousPackageID();
 
   stack.push_Reference(returned_value);
 
@@ -102,7 +101,6 @@ void Bytecodes::bc_sreturn() {
   returned_value = stack.pop_Short();
 
   stack.pop_Frame();
-  context.backToPreviousPackageID();
 
   stack.push_Short(returned_value);
 
@@ -147,7 +145,6 @@ void Bytecodes::bc_ireturn() {
   returned_value = stack.pop_Int();
 
   stack.pop_Frame();
-  context.backToPreviousPackageID();
 
   stack.push_Int(returned_value);
 
@@ -180,7 +177,6 @@ void Bytecodes::bc_return() {
   TRACE_JCVM_DEBUG("RETURN");
 
   stack.pop_Frame();
-  context.backToPreviousPackageID();
 
   return;
 }
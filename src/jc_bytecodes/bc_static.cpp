@@ -29,7 +29,6 @@
 #include "../jc_cap/jc_cap_cp.hpp"
 #include "../jc_handlers/flashmemory.hpp"
 #include "../jc_handlers/jc_cp.hpp"
-#include "../jc_handlers/jc_import.hpp"
 #include "../jc_handlers/jc_static.hpp"
 #include "../jc_types/jc_array.hpp"
 #include "../jc_utils.hpp"
@@ -81,43 +80,7 @@ void Bytecodes::bc_getstatic_a() {
 
   TRACE_JCVM_DEBUG("GETSTATIC_A 0x%04X", index);
 
-  jc_cap_static_field_ref_info cp_entry = cp.getStaticFieldRefInfo(index);
-
-  jpackage_ID_t packageID;
-  uint8_t fieldNumber;
-
-  if (IS_CP_INTERNAL_REF(cp_entry.static_field_ref)) {
-    packageID = this->context.getCurrentPackageID();
-    fieldNumber = NTOHS(cp_entry.static_field_ref.internal_ref.offset);
-  } else {
-    jc_cap_external_ref external_ref = cp_entry.static_field_ref.external_ref;
-
-    /// Searching the Package number in the flash.
-    Import_Handler imp(context.getCurrentPackage());
-    auto package_info =
-        imp.getPackageAID(CLEAR_BYTE_MSB(external_ref.package_token));
-    auto package_index = imp.getPackageIndex(package_info);
-
-    packageID = package_index;
-
-    /// Looking for the static field nomber in the package.
-    auto export_comp = Package(package_index).getCap().getExport();
-
-#if defined(JCVM_DYNAMIC_CHECKS_CAP) & defined(JCVM_ARRAY_SIZE_CHECK)
-
-    if (export_comp->class_count <= external_ref.class_token) {
-      throw Exceptions::SecurityException;
-    }
-
-#endif /* defined (JCVM_DYNAMIC_CHECKS_CAP) & defined (JCVM_ARRAY_SIZE_CHECK)  \
-        */
-
-    auto exported_class = export_comp->classexport(external_ref.class_token);
-    auto static_field_offsets = exported_class.static_field_offsets();
-    const uint16_t static_field_offset =
-        static_field_offsets[external_ref.token];
-    fieldNumber = static_field_offset;
-  }
+  auto [packageID, fieldNumber] = cp.getResolvedStaticField(index);
 
   fs::Tag tag = FlashMemory_Handler::getStaticFieldTag(packageID, fieldNumber);
 
@@ -0,0 +1,490 @@
+/*
+** The MIT License (MIT)
+**
+** Copyright (c) 2020, National Cybersecurity Agency of France (ANSSI)
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+** Author:
+**   - Guillaume Bouffard <guillaume.bouffard@ssi.gouv.fr>
+*/
+
+#ifndef _BYTECODE_HANDLERS_HPP
+#define _BYTECODE_HANDLERS_HPP
+
+#include "../jc_config.h"
+#include "bytecodes.hpp"
+
+namespace jcvm {
+
+/// Bytecode handlers indexed by opcode value
+static constexpr Bytecodes::handler_t bytecode_handlers[] = {
+    /* 0x00 */ &Bytecodes::bc_nop,
+    /* 0x01 */ &Bytecodes::bc_aconst_null,
+    /* 0x02 */ &Bytecodes::bc_sconst_m1,
+    /* 0x03 */ &Bytecodes::bc_sconst_0,
+    /* 0x04 */ &Bytecodes::bc_sconst_1,
+    /* 0x05 */ &Bytecodes::bc_sconst_2,
+    /* 0x06 */ &Bytecodes::bc_sconst_3,
+    /* 0x07 */ &Bytecodes::bc_sconst_4,
+    /* 0x08 */ &Bytecodes::bc_sconst_5,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0x09 */ &Bytecodes::bc_iconst_m1,
+    /* 0x0a */ &Bytecodes::bc_iconst_0,
+    /* 0x0b */ &Bytecodes::bc_iconst_1,
+    /* 0x0c */ &Bytecodes::bc_iconst_2,
+    /* 0x0d */ &Bytecodes::bc_iconst_3,
+    /* 0x0e */ &Bytecodes::bc_iconst_4,
+    /* 0x0f */ &Bytecodes::bc_iconst_5,
+#else  // int type not supported
+    /* 0x09 */ &Bytecodes::bc_unsupported,
+    /* 0x0a */ &Bytecodes::bc_unsupported,
+    /* 0x0b */ &Bytecodes::bc_unsupported,
+    /* 0x0c */ &Bytecodes::bc_unsupported,
+    /* 0x0d */ &Bytecodes::bc_unsupported,
+    /* 0x0e */ &Bytecodes::bc_unsupported,
+    /* 0x0f */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0x10 */ &Bytecodes::bc_bspush,
+    /* 0x11 */ &Bytecodes::bc_sspush,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0x12 */ &Bytecodes::bc_bipush,
+    /* 0x13 */ &Bytecodes::bc_sipush,
+    /* 0x14 */ &Bytecodes::bc_iipush,
+#else  // int type not supported
+    /* 0x12 */ &Bytecodes::bc_unsupported,
+    /* 0x13 */ &Bytecodes::bc_unsupported,
+    /* 0x14 */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0x15 */ &Bytecodes::bc_aload,
+    /* 0x16 */ &Bytecodes::bc_sload,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0x17 */ &Bytecodes::bc_iload,
+#else  // int type not supported
+    /* 0x17 */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0x18 */ &Bytecodes::bc_aload_0,
+    /* 0x19 */ &Bytecodes::bc_aload_1,
+    /* 0x1a */ &Bytecodes::bc_aload_2,
+    /* 0x1b */ &Bytecodes::bc_aload_3,
+    /* 0x1c */ &Bytecodes::bc_sload_0,
+    /* 0x1d */ &Bytecodes::bc_sload_1,
+    /* 0x1e */ &Bytecodes::bc_sload_2,
+    /* 0x1f */ &Bytecodes::bc_sload_3,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0x20 */ &Bytecodes::bc_iload_0,
+    /* 0x21 */ &Bytecodes::bc_iload_1,
+    /* 0x22 */ &Bytecodes::bc_iload_2,
+    /* 0x23 */ &Bytecodes::bc_iload_3,
+#else  // int type not supported
+    /* 0x20 */ &Bytecodes::bc_unsupported,
+    /* 0x21 */ &Bytecodes::bc_unsupported,
+    /* 0x22 */ &Bytecodes::bc_unsupported,
+    /* 0x23 */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0x24 */ &Bytecodes::bc_aaload,
+    /* 0x25 */ &Bytecodes::bc_baload,
+    /* 0x26 */ &Bytecodes::bc_saload,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0x27 */ &Bytecodes::bc_iaload,
+#else  // int type not supported
+    /* 0x27 */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0x28 */ &Bytecodes::bc_astore,
+    /* 0x29 */ &Bytecodes::bc_sstore,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0x2a */ &Bytecodes::bc_istore,
+#else  // int type not supported
+    /* 0x2a */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0x2b */ &Bytecodes::bc_astore_0,
+    /* 0x2c */ &Bytecodes::bc_astore_1,
+    /* 0x2d */ &Bytecodes::bc_astore_2,
+    /* 0x2e */ &Bytecodes::bc_astore_3,
+    /* 0x2f */ &Bytecodes::bc_sstore_0,
+    /* 0x30 */ &Bytecodes::bc_sstore_1,
+    /* 0x31 */ &Bytecodes::bc_sstore_2,
+    /* 0x32 */ &Bytecodes::bc_sstore_3,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0x33 */ &Bytecodes::bc_istore_0,
+    /* 0x34 */ &Bytecodes::bc_istore_1,
+    /* 0x35 */ &Bytecodes::bc_istore_2,
+    /* 0x36 */ &Bytecodes::bc_istore_3,
+#else  // int type not supported
+    /* 0x33 */ &Bytecodes::bc_unsupported,
+    /* 0x34 */ &Bytecodes::bc_unsupported,
+    /* 0x35 */ &Bytecodes::bc_unsupported,
+    /* 0x36 */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0x37 */ &Bytecodes::bc_aastore,
+    /* 0x38 */ &Bytecodes::bc_bastore,
+    /* 0x39 */ &Bytecodes::bc_sastore,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0x3a */ &Bytecodes::bc_iastore,
+#else  // int type not supported
+    /* 0x3a */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0x3b */ &Bytecodes::bc_pop,
+    /* 0x3c */ &Bytecodes::bc_pop2,
+    /* 0x3d */ &Bytecodes::bc_dup,
+    /* 0x3e */ &Bytecodes::bc_dup2,
+    /* 0x3f */ &Bytecodes::bc_dup_x,
+    /* 0x40 */ &Bytecodes::bc_swap_x,
+    /* 0x41 */ &Bytecodes::bc_sadd,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0x42 */ &Bytecodes::bc_iadd,
+#else  // int type not supported
+    /* 0x42 */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0x43 */ &Bytecodes::bc_ssub,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0x44 */ &Bytecodes::bc_isub,
+#else  // int type not supported
+    /* 0x44 */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0x45 */ &Bytecodes::bc_smul,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0x46 */ &Bytecodes::bc_imul,
+#else  // int type not supported
+    /* 0x46 */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0x47 */ &Bytecodes::bc_sdiv,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0x48 */ &Bytecodes::bc_idiv,
+#else  // int type not supported
+    /* 0x48 */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0x49 */ &Bytecodes::bc_srem,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0x4a */ &Bytecodes::bc_irem,
+#else  // int type not supported
+    /* 0x4a */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0x4b */ &Bytecodes::bc_sneg,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0x4c */ &Bytecodes::bc_ineg,
+#else  // int type not supported
+    /* 0x4c */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0x4d */ &Bytecodes::bc_sshl,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0x4e */ &Bytecodes::bc_ishl,
+#else  // int type not supported
+    /* 0x4e */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0x4f */ &Bytecodes::bc_sshr,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0x50 */ &Bytecodes::bc_ishr,
+#else  // int type not supported
+    /* 0x50 */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0x51 */ &Bytecodes::bc_sushr,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0x52 */ &Bytecodes::bc_iushr,
+#else  // int type not supported
+    /* 0x52 */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0x53 */ &Bytecodes::bc_sand,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0x54 */ &Bytecodes::bc_iand,
+#else  // int type not supported
+    /* 0x54 */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0x55 */ &Bytecodes::bc_sor,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0x56 */ &Bytecodes::bc_ior,
+#else  // int type not supported
+    /* 0x56 */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0x57 */ &Bytecodes::bc_sxor,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0x58 */ &Bytecodes::bc_ixor,
+#else  // int type not supported
+    /* 0x58 */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0x59 */ &Bytecodes::bc_sinc,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0x5a */ &Bytecodes::bc_iinc,
+#else  // int type not supported
+    /* 0x5a */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0x5b */ &Bytecodes::bc_s2b,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0x5c */ &Bytecodes::bc_s2i,
+    /* 0x5d */ &Bytecodes::bc_i2b,
+    /* 0x5e */ &Bytecodes::bc_i2s,
+    /* 0x5f */ &Bytecodes::bc_icmp,
+#else  // int type not supported
+    /* 0x5c */ &Bytecodes::bc_unsupported,
+    /* 0x5d */ &Bytecodes::bc_unsupported,
+    /* 0x5e */ &Bytecodes::bc_unsupported,
+    /* 0x5f */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0x60 */ &Bytecodes::bc_ifeq,
+    /* 0x61 */ &Bytecodes::bc_ifne,
+    /* 0x62 */ &Bytecodes::bc_iflt,
+    /* 0x63 */ &Bytecodes::bc_ifge,
+    /* 0x64 */ &Bytecodes::bc_ifgt,
+    /* 0x65 */ &Bytecodes::bc_ifle,
+    /* 0x66 */ &Bytecodes::bc_ifnull,
+    /* 0x67 */ &Bytecodes::bc_ifnonnull,
+    /* 0x68 */ &Bytecodes::bc_if_acmpeq,
+    /* 0x69 */ &Bytecodes::bc_if_acmpne,
+    /* 0x6a */ &Bytecodes::bc_if_scmpeq,
+    /* 0x6b */ &Bytecodes::bc_if_scmpne,
+    /* 0x6c */ &Bytecodes::bc_if_scmplt,
+    /* 0x6d */ &Bytecodes::bc_if_scmpge,
+    /* 0x6e */ &Bytecodes::bc_if_scmpgt,
+    /* 0x6f */ &Bytecodes::bc_if_scmple,
+    /* 0x70 */ &Bytecodes::bc_goto,
+    /* 0x71 */ &Bytecodes::bc_jsr,
+    /* 0x72 */ &Bytecodes::bc_ret,
+    /* 0x73 */ &Bytecodes::bc_stableswitch,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0x74 */ &Bytecodes::bc_itableswitch,
+#else  // int type not supported
+    /* 0x74 */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0x75 */ &Bytecodes::bc_slookupswitch,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0x76 */ &Bytecodes::bc_ilookupswitch,
+#else  // int type not supported
+    /* 0x76 */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0x77 */ &Bytecodes::bc_areturn,
+    /* 0x78 */ &Bytecodes::bc_sreturn,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0x79 */ &Bytecodes::bc_ireturn,
+#else  // int type not supported
+    /* 0x79 */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0x7a */ &Bytecodes::bc_return,
+    /* 0x7b */ &Bytecodes::bc_getstatic_a,
+    /* 0x7c */ &Bytecodes::bc_getstatic_b,
+    /* 0x7d */ &Bytecodes::bc_getstatic_s,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0x7e */ &Bytecodes::bc_getstatic_i,
+#else  // int type not supported
+    /* 0x7e */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0x7f */ &Bytecodes::bc_putstatic_a,
+    /* 0x80 */ &Bytecodes::bc_putstatic_b,
+    /* 0x81 */ &Bytecodes::bc_putstatic_s,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0x82 */ &Bytecodes::bc_putstatic_i,
+#else  // int type not supported
+    /* 0x82 */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0x83 */ &Bytecodes::bc_getfield_a,
+    /* 0x84 */ &Bytecodes::bc_getfield_b,
+    /* 0x85 */ &Bytecodes::bc_getfield_s,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0x86 */ &Bytecodes::bc_getfield_i,
+#else  // int type not supported
+    /* 0x86 */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0x87 */ &Bytecodes::bc_putfield_a,
+    /* 0x88 */ &Bytecodes::bc_putfield_b,
+    /* 0x89 */ &Bytecodes::bc_putfield_s,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0x8a */ &Bytecodes::bc_putfield_i,
+#else  // int type not supported
+    /* 0x8a */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0x8b */ &Bytecodes::bc_invokevirtual,
+    /* 0x8c */ &Bytecodes::bc_invokespecial,
+    /* 0x8d */ &Bytecodes::bc_invokestatic,
+    /* 0x8e */ &Bytecodes::bc_invokeinterface,
+    /* 0x8f */ &Bytecodes::bc_new,
+    /* 0x90 */ &Bytecodes::bc_newarray,
+    /* 0x91 */ &Bytecodes::bc_anewarray,
+    /* 0x92 */ &Bytecodes::bc_arraylength,
+    /* 0x93 */ &Bytecodes::bc_athrow,
+    /* 0x94 */ &Bytecodes::bc_checkcast,
+    /* 0x95 */ &Bytecodes::bc_instanceof,
+    /* 0x96 */ &Bytecodes::bc_sinc_w,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0x97 */ &Bytecodes::bc_iinc_w,
+#else  // int type not supported
+    /* 0x97 */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0x98 */ &Bytecodes::bc_ifeq_w,
+    /* 0x99 */ &Bytecodes::bc_ifne_w,
+    /* 0x9a */ &Bytecodes::bc_iflt_w,
+    /* 0x9b */ &Bytecodes::bc_ifge_w,
+    /* 0x9c */ &Bytecodes::bc_ifgt_w,
+    /* 0x9d */ &Bytecodes::bc_ifle_w,
+    /* 0x9e */ &Bytecodes::bc_ifnull_w,
+    /* 0x9f */ &Bytecodes::bc_ifnonnull_w,
+    /* 0xa0 */ &Bytecodes::bc_if_acmpeq_w,
+    /* 0xa1 */ &Bytecodes::bc_if_acmpne_w,
+    /* 0xa2 */ &Bytecodes::bc_if_scmpeq_w,
+    /* 0xa3 */ &Bytecodes::bc_if_scmpne_w,
+    /* 0xa4 */ &Bytecodes::bc_if_scmplt_w,
+    /* 0xa5 */ &Bytecodes::bc_if_scmpge_w,
+    /* 0xa6 */ &Bytecodes::bc_if_scmpgt_w,
+    /* 0xa7 */ &Bytecodes::bc_if_scmple_w,
+    /* 0xa8 */ &Bytecodes::bc_goto_w,
+    /* 0xa9 */ &Bytecodes::bc_getfield_a_w,
+    /* 0xaa */ &Bytecodes::bc_getfield_b_w,
+    /* 0xab */ &Bytecodes::bc_getfield_s_w,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0xac */ &Bytecodes::bc_getfield_i_w,
+#else  // int type not supported
+    /* 0xac */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0xad */ &Bytecodes::bc_getfield_a_this,
+    /* 0xae */ &Bytecodes::bc_getfield_b_this,
+    /* 0xaf */ &Bytecodes::bc_getfield_s_this,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0xb0 */ &Bytecodes::bc_getfield_i_this,
+#else  // int type not supported
+    /* 0xb0 */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0xb1 */ &Bytecodes::bc_putfield_a_w,
+    /* 0xb2 */ &Bytecodes::bc_putfield_b_w,
+    /* 0xb3 */ &Bytecodes::bc_putfield_s_w,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0xb4 */ &Bytecodes::bc_putfield_i_w,
+#else  // int type not supported
+    /* 0xb4 */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0xb5 */ &Bytecodes::bc_putfield_a_this,
+    /* 0xb6 */ &Bytecodes::bc_putfield_b_this,
+    /* 0xb7 */ &Bytecodes::bc_putfield_s_this,
+#ifdef JCVM_INT_SUPPORTED
+    /* 0xb8 */ &Bytecodes::bc_putfield_i_this,
+#else  // int type not supported
+    /* 0xb8 */ &Bytecodes::bc_unsupported,
+#endif /* JCVM_INT_SUPPORTED */
+    /* 0xb9 */ &Bytecodes::bc_unsupported,
+    /* 0xba */ &Bytecodes::bc_unsupported,
+    /* 0xbb */ &Bytecodes::bc_unsupported,
+    /* 0xbc */ &Bytecodes::bc_unsupported,
+    /* 0xbd */ &Bytecodes::bc_unsupported,
+    /* 0xbe */ &Bytecodes::bc_unsupported,
+    /* 0xbf */ &Bytecodes::bc_unsupported,
+    /* 0xc0 */ &Bytecodes::bc_unsupported,
+    /* 0xc1 */ &Bytecodes::bc_unsupported,
+    /* 0xc2 */ &Bytecodes::bc_unsupported,
+    /* 0xc3 */ &Bytecodes::bc_unsupported,
+    /* 0xc4 */ &Bytecodes::bc_unsupported,
+    /* 0xc5 */ &Bytecodes::bc_unsupported,
+    /* 0xc6 */ &Bytecodes::bc_unsupported,
+    /* 0xc7 */ &Bytecodes::bc_unsupported,
+    /* 0xc8 */ &Bytecodes::bc_unsupported,
+    /* 0xc9 */ &Bytecodes::bc_unsupported,
+    /* 0xca */ &Bytecodes::bc_unsupported,
+    /* 0xcb */ &Bytecodes::bc_unsupported,
+    /* 0xcc */ &Bytecodes::bc_unsupported,
+    /* 0xcd */ &Bytecodes::bc_unsupported,
+    /* 0xce */ &Bytecodes::bc_unsupported,
+    /* 0xcf */ &Bytecodes::bc_unsupported,
+    /* 0xd0 */ &Bytecodes::bc_unsupported,
+    /* 0xd1 */ &Bytecodes::bc_unsupported,
+    /* 0xd2 */ &Bytecodes::bc_unsupported,
+    /* 0xd3 */ &Bytecodes::bc_unsupported,
+    /* 0xd4 */ &Bytecodes::bc_unsupported,
+    /* 0xd5 */ &Bytecodes::bc_unsupported,
+    /* 0xd6 */ &Bytecodes::bc_unsupported,
+    /* 0xd7 */ &Bytecodes::bc_unsupported,
+    /* 0xd8 */ &Bytecodes::bc_unsupported,
+    /* 0xd9 */ &Bytecodes::bc_unsupported,
+    /* 0xda */ &Bytecodes::bc_unsupported,
+    /* 0xdb */ &Bytecodes::bc_unsupported,
+    /* 0xdc */ &Bytecodes::bc_unsupported,
+    /* 0xdd */ &Bytecodes::bc_unsupported,
+    /* 0xde */ &Bytecodes::bc_unsupported,
+    /* 0xdf */ &Bytecodes::bc_unsupported,
+    /* 0xe0 */ &Bytecodes::bc_unsupported,
+    /* 0xe1 */ &Bytecodes::bc_unsupported,
+    /* 0xe2 */ &Bytecodes::bc_unsupported,
+    /* 0xe3 */ &Bytecodes::bc_unsupported,
+    /* 0xe4 */ &Bytecodes::bc_unsupported,
+    /* 0xe5 */ &Bytecodes::bc_unsupported,
+    /* 0xe6 */ &Bytecodes::bc_unsupported,
+    /* 0xe7 */ &Bytecodes::bc_unsupported,
+    /* 0xe8 */ &Bytecodes::bc_unsupported,
+    /* 0xe9 */ &Bytecodes::bc_unsupported,
+    /* 0xea */ &Bytecodes::bc_unsupported,
+    /* 0xeb */ &Bytecodes::bc_unsupported,
+    /* 0xec */ &Bytecodes::bc_unsupported,
+    /* 0xed */ &Bytecodes::bc_unsupported,
+    /* 0xee */ &Bytecodes::bc_unsupported,
+    /* 0xef */ &Bytecodes::bc_unsupported,
+    /* 0xf0 */ &Bytecodes::bc_unsupported,
+    /* 0xf1 */ &Bytecodes::bc_unsupported,
+    /* 0xf2 */ &Bytecodes::bc_unsupported,
+    /* 0xf3 */ &Bytecodes::bc_unsupported,
+    /* 0xf4 */ &Bytecodes::bc_unsupported,
+    /* 0xf5 */ &Bytecodes::bc_unsupported,
+    /* 0xf6 */ &Bytecodes::bc_unsupported,
+    /* 0xf7 */ &Bytecodes::bc_unsupported,
+    /* 0xf8 */ &Bytecodes::bc_unsupported,
+    /* 0xf9 */ &Bytecodes::bc_unsupported,
+    /* 0xfa */ &Bytecodes::bc_unsupported,
+    /* 0xfb */ &Bytecodes::bc_unsupported,
+    /* 0xfc */ &Bytecodes::bc_unsupported,
+    /* 0xfd */ &Bytecodes::bc_unsupported,
+    /* 0xfe */ &Bytecodes::bc_impdep1,
+    /* 0xff */ &Bytecodes::bc_impdep2,
+};
+
+static_assert((sizeof(bytecode_handlers) / sizeof(bytecode_handlers[0])) ==
+                  256,
+              "A handler must be defined for each opcode value.");
+
+/// Apply X to each opcode value, written as 2 hexadecimal digits.
+#define JCVM_FOR_EACH_OPCODE(X)                                                \
+  X(00) X(01) X(02) X(03) X(04) X(05) X(06) X(07)                              \
+  X(08) X(09) X(0A) X(0B) X(0C) X(0D) X(0E) X(0F)                              \
+  X(10) X(11) X(12) X(13) X(14) X(15) X(16) X(17)                              \
+  X(18) X(19) X(1A) X(1B) X(1C) X(1D) X(1E) X(1F)                              \
+  X(20) X(21) X(22) X(23) X(24) X(25) X(26) X(27)                              \
+  X(28) X(29) X(2A) X(2B) X(2C) X(2D) X(2E) X(2F)                              \
+  X(30) X(31) X(32) X(33) X(34) X(35) X(36) X(37)                              \
+  X(38) X(39) X(3A) X(3B) X(3C) X(3D) X(3E) X(3F)                              \
+  X(40) X(41) X(42) X(43) X(44) X(45) X(46) X(47)                              \
+  X(48) X(49) X(4A) X(4B) X(4C) X(4D) X(4E) X(4F)                              \
+  X(50) X(51) X(52) X(53) X(54) X(55) X(56) X(57)                              \
+  X(58) X(59) X(5A) X(5B) X(5C) X(5D) X(5E) X(5F)                              \
+  X(60) X(61) X(62) X(63) X(64) X(65) X(66) X(67)                              \
+  X(68) X(69) X(6A) X(6B) X(6C) X(6D) X(6E) X(6F)                              \
+  X(70) X(71) X(72) X(73) X(74) X(75) X(76) X(77)                              \
+  X(78) X(79) X(7A) X(7B) X(7C) X(7D) X(7E) X(7F)                              \
+  X(80) X(81) X(82) X(83) X(84) X(85) X(86) X(87)                              \
+  X(88) X(89) X(8A) X(8B) X(8C) X(8D) X(8E) X(8F)                              \
+  X(90) X(91) X(92) X(93) X(94) X(95) X(96) X(97)                              \
+  X(98) X(99) X(9A) X(9B) X(9C) X(9D) X(9E) X(9F)                              \
+  X(A0) X(A1) X(A2) X(A3) X(A4) X(A5) X(A6) X(A7)                              \
+  X(A8) X(A9) X(AA) X(AB) X(AC) X(AD) X(AE) X(AF)                              \
+  X(B0) X(B1) X(B2) X(B3) X(B4) X(B5) X(B6) X(B7)                              \
+  X(B8) X(B9) X(BA) X(BB) X(BC) X(BD) X(BE) X(BF)                              \
+  X(C0) X(C1) X(C2) X(C3) X(C4) X(C5) X(C6) X(C7)                              \
+  X(C8) X(C9) X(CA) X(CB) X(CC) X(CD) X(CE) X(CF)                              \
+  X(D0) X(D1) X(D2) X(D3) X(D4) X(D5) X(D6) X(D7)                              \
+  X(D8) X(D9) X(DA) X(DB) X(DC) X(DD) X(DE) X(DF)                              \
+  X(E0) X(E1) X(E2) X(E3) X(E4) X(E5) X(E6) X(E7)                              \
+  X(E8) X(E9) X(EA) X(EB) X(EC) X(ED) X(EE) X(EF)                              \
+  X(F0) X(F1) X(F2) X(F3) X(F4) X(F5) X(F6) X(F7)                              \
+  X(F8) X(F9) X(FA) X(FB) X(FC) X(FD) X(FE) X(FF)
+
+} // namespace jcvm
+
+#endif /* _BYTECODE_HANDLERS_HPP */
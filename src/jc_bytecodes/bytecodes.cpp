@@ -830,11 +830,11 @@ auto Bytecodes::decode(const uint8_t value) -> void (Bytecodes::*)() {
     break;
 
   case BC_PUTFIELD_B_THIS:
-    return &Bytecodes::bc_putfield_s_this;
+    return &Bytecodes::bc_putfield_b_this;
     break;
 
   case BC_PUTFIELD_S_THIS:
-    return &Bytecodes::bc_putfield_b_this;
+    return &Bytecodes::bc_putfield_s_this;
     break;
 
 #ifdef JCVM_INT_SUPPORTED
@@ -40,6 +40,9 @@ private:
   Context &context;
 
 public:
+  /// Bytecode handler type
+  typedef void (Bytecodes::*handler_t)();
+
   // Default constructor
   Bytecodes(Context &context) noexcept : context(context){};
 
@@ -374,6 +377,8 @@ public:
   void bc_impdep1(); /* 0xfe */
   void bc_impdep2(); /* 0xff */
 
+  void bc_unsupported(); /* Unsupported opcode values */
+
   void doThrow(jref_t objectref);
 };
 
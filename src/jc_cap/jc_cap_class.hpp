@@ -108,7 +108,7 @@ struct __attribute__((__packed__)) jc_cap_class_info {
       noexcept {
     return JCVMArray<const uint16_t>(
         package_method_table_count,
-        (data + public_method_table_count * sizeof(uint16_t)));
+        (data + public_method_table_count));
   }
 
   const jc_cap_implemented_interface_info &
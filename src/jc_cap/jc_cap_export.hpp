@@ -54,8 +54,8 @@ struct __attribute__((__packed__)) jc_cap_class_export_info {
   }
 
   const JCVMArray<const uint16_t> static_method_offsets() const noexcept {
-    return JCVMArray<const uint16_t>(
-        static_method_count, (data + static_field_count * sizeof(uint16_t)));
+    return JCVMArray<const uint16_t>(static_method_count,
+                                     (data + static_field_count));
   }
 
   uint16_t getSizeOf() const noexcept {
@@ -29,11 +29,30 @@
 #define _JCVM_CONFIG_H
 
 #define JCVM_STACK_SIZE (uint16_t)(1024 >> 2) // 2-Bytes
-#define JCVM_MAX_HEAP_SIZE (uint16_t)256      // bytes
+/// The PC version hosts applets allocating APDU-sized buffers (up to 261
+/// bytes), which do not fit the embedded heap.
+#ifdef PC_VERSION
+#define JCVM_MAX_HEAP_SIZE (uint16_t)16384 // bytes
+#else /* !PC_VERSION */
+#define JCVM_MAX_HEAP_SIZE (uint16_t)256 // bytes
+#endif /* PC_VERSION */
 /// NOTE: This size must be < to 0x7FFE. A max size more than 0x7FFE will occur
 /// several bugs.
 #define JCVM_MAX_APPLETS (uint16_t)40 // applets (max 255)
 #define JCVM_MAX_PACKAGES (uint8_t)64 // packages (max 255)
+#define JCVM_MAX_FRAMES (uint8_t)32    // nested method calls (max 255)
+#define JCVM_MAX_SAVED_PCS (uint8_t)4  // jsr return addresses by frame
+#define JCVM_INLINE_CACHE_SIZE (uint8_t)4 // receiver classes by call site
+#define JCVM_GC_THRESHOLD (uint16_t)(JCVM_MAX_HEAP_SIZE >> 2) // allocated bytes
+#define JCVM_WRITE_BACK_CACHE_SIZE (uint8_t)16 // pending persistent writes
+#define JCVM_TRANSACTION_CAPACITY (uint16_t)512 // bytes written by transaction
+
+/// The in-tree file system backend is selected by defining JCVM_NATIVE_FS
+/// (see CHOUPI_NATIVE_FS build option). The other PC builds use it to
+/// convert the flash images.
+#define JCVM_NATIVE_FS_SIZE (uint32_t)0x100000 // bytes of flash memory
+#define JCVM_NATIVE_FS_COMPACTION_THRESHOLD (uint32_t)4096 // dead bytes
+#define JCVM_NATIVE_FS_COMPACTION_STEP (uint32_t)16384 // moved bytes
 
 #define JCRE_CLEAN_STACK
 #define JCVM_INT_SUPPORTED
@@ -45,8 +64,20 @@
 
 #define NVM_LITTLE_ENDIAN
 
+/// The decode-based interpretor loop is selected by defining
+/// JCVM_LEGACY_DISPATCH (see CHOUPI_JCVM_LEGACY_DISPATCH build option).
+#ifndef JCVM_LEGACY_DISPATCH
+#define JCVM_THREADED_DISPATCH
+#endif /* JCVM_LEGACY_DISPATCH */
+
+/// Instance field types, packed by 4 bits, are tracked by defining
+/// JCVM_TYPED_HEAP. It is required to store RAM instances holding references
+/// in the persistent memory: without it, every field of a stored instance,
+/// references included, is saved as a short value and the referenced objects
+/// are not stored.
+#undef JCVM_TYPED_HEAP
+
 #undef JCRE_SWITCH_PROTECTION // TODO: To be tested and implemented
-#undef JCVM_TYPED_HEAP        // TODO: not yet implemented
 #undef JCVM_TYPED_STACK       // TODO: not yet implemented
 
 #endif /* _JCVM_CONFIG_H */
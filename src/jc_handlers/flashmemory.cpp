@@ -33,6 +33,8 @@
 #include "../jc_types/jc_instance.hpp"
 #include "../jc_utils.hpp"
 #include "ffi.h"
+#include "flashmemory_cache.hpp"
+#include "package_registry.hpp"
 
 #include <cassert>
 
@@ -46,30 +48,18 @@ static constexpr uint16_t getPackagesArrayLength() {
 }
 
 /**
- * Read data from tag
+ * Read scalar data in place from tag. The data is read from the write-back
+ * cache when pending, else from the file system, without copy.
  *
  * @param[tag] Associated tag value.
- * @return data associated to the tag.
+ * @return data associated to the tag, valid until the next persistent write.
  */
-std::pair<uint32_t, uint8_t *>
-FlashMemory_Handler::getDataFromTag(const fs::Tag &tag) {
+std::pair<uint32_t, const uint8_t *>
+FlashMemory_Handler::getScalarDataFromTag(const fs::Tag &tag) {
   uint32_t data_length = 0;
+  const uint8_t *data = FlashMemory_Cache::readScalar(tag, data_length);
 
-  if (fs_length(&(tag.value[0]), tag.len, &data_length)) {
-    throw Exceptions::IOException;
-  }
-
-  if (data_length == 0) {
-    throw Exceptions::IOException;
-  }
-
-  uint8_t *data = new uint8_t[data_length];
-
-  if (data == nullptr) {
-    throw Exceptions::IOException;
-  }
-
-  if (fs_read(&(tag.value[0]), tag.len, data, data_length)) {
+  if ((data_length == 0) || (data == nullptr)) {
     throw Exceptions::IOException;
   }
 
@@ -94,24 +84,43 @@ void FlashMemory_Handler::writeInstanceHeader(
   uint8_t data[] = {FieldType::FIELD_TYPE_OBJECT, package,
                     HIGH_BYTE_SHORT(class_index), LOW_BYTE_SHORT(class_index)};
 
-  if (fs_write(tag.value, tag.len, data, (sizeof(data) / sizeof(data[0])))) {
-    throw Exceptions::IOException;
-  }
+  FlashMemory_Cache::write(tag, data, (sizeof(data) / sizeof(data[0])));
 }
 
 /**
- * Write persistant array data
+ * Write persistant array data. The elements of a reference array are stored
+ * at their own tags: they are written even if the array is unchanged.
  *
  * @param[tag] Associated tag value.
  * @param[array_type] array type to write
  * @param[data] array data
+ * @param[isUnchanged] is the array already stored at the tag?
  */
 void FlashMemory_Handler::writeArray(const fs::Tag &tag, const FieldType type,
-                                     JC_Array &array, Heap &heap) {
+                                     JC_Array &array, Heap &heap,
+                                     const bool isUnchanged) {
 
   static_assert(sizeof(decltype(array.getReferenceType())) == sizeof(uint16_t),
                 "japplet_ID_t should be encoded on 2-byte.");
 
+  if (type == FieldType::FIELD_TYPE_ARRAY_OBJECT) {
+    for (decltype(array.size()) idx = 0; idx < array.size(); idx++) {
+      if ((tag.len + sizeof(idx)) >=
+          (sizeof(tag.value) / sizeof(tag.value[0]))) {
+        throw Exceptions::IOException;
+      }
+
+      fs::Tag new_tag = FlashMemory_Handler::computeTag(tag, idx);
+
+      FlashMemory_Handler::setPersistentField_Reference(
+          new_tag, array.getReferenceEntry(idx), heap);
+    }
+  }
+
+  if (isUnchanged) {
+    return;
+  }
+
   uint8_t *data = nullptr;
   uint16_t header = sizeof(FieldType) + sizeof(array.size());
   uint16_t array_size = 0;
@@ -150,27 +159,7 @@ void FlashMemory_Handler::writeArray(const fs::Tag &tag, const FieldType type,
     data[pos++] = LOW_BYTE_SHORT(array.getReferenceType());
   }
 
-  if (type == FieldType::FIELD_TYPE_ARRAY_OBJECT) {
-    for (decltype(array.size()) idx = 0; idx < array.size(); idx++) {
-      if ((tag.len + sizeof(idx)) >=
-          (sizeof(tag.value) / sizeof(tag.value[0]))) {
-        throw Exceptions::IOException;
-      }
-
-      fs::Tag new_tag = FlashMemory_Handler::computeTag(tag, idx);
-
-      jref_t objectref = array.getReferenceEntry(idx);
-
-      if (objectref.isArray()) {
-        auto array = heap.getArray(objectref);
-        FlashMemory_Handler::setPersistentField_Array(new_tag, *array, heap);
-      } else { // Is an instance
-        auto instance = heap.getInstance(objectref);
-        FlashMemory_Handler::setPersistentField_Instance(new_tag, *instance,
-                                                         heap);
-      }
-    }
-  } else {
+  if (type != FieldType::FIELD_TYPE_ARRAY_OBJECT) {
     if (array.isTransientArray()) {
       // Do not copy data
     } else {
@@ -211,9 +200,7 @@ void FlashMemory_Handler::writeArray(const fs::Tag &tag, const FieldType type,
      */
   }
 
-  if (fs_write(tag.value, tag.len, data, array_size)) {
-    throw Exceptions::IOException;
-  }
+  FlashMemory_Cache::write(tag, data, array_size);
 
   if (data != nullptr) {
     delete[] data;
@@ -227,24 +214,19 @@ fs::Tag FlashMemory_Handler::computeTag(const fs::Tag &tag,
     noexcept
 #endif /* JCVM_SECURE_HEAP_ACCESS */
 {
-  fs::Tag new_tag;
-
-  new_tag.len = tag.len + sizeof(index);
+  fs::Tag new_tag = tag;
 
 #ifdef JCVM_SECURE_HEAP_ACCESS
 
-  if (new_tag.len > (sizeof(new_tag.value) / sizeof(new_tag.value[0]))) {
+  if ((tag.len + sizeof(index)) >
+      (sizeof(new_tag.value) / sizeof(new_tag.value[0]))) {
     throw Exceptions::SecurityException;
   }
 
 #endif /* JCVM_SECURE_HEAP_ACCESS */
 
-  for (uint8_t idx = 0; idx < tag.len; idx++) {
-    new_tag.value[idx] = tag.value[idx];
-  }
-
-  new_tag.value[tag.len] = LOW_BYTE_SHORT(index);
-  new_tag.value[tag.len + 1] = LOW_BYTE_SHORT(index);
+  new_tag.append(LOW_BYTE_SHORT(index));
+  new_tag.append(LOW_BYTE_SHORT(index));
 
   return new_tag;
 }
@@ -257,12 +239,8 @@ fs::Tag FlashMemory_Handler::computeTag(const fs::Tag &tag,
  */
 std::pair<uint32_t, const uint8_t *>
 FlashMemory_Handler::getDataInPlaceFromTag(const fs::Tag &tag) {
-  const uint8_t *data = nullptr;
-  uint32_t data_length;
-
-  if (fs_read_inplace(&(tag.value[0]), tag.len, &data, &data_length)) {
-    throw Exceptions::IOException;
-  }
+  uint32_t data_length = 0;
+  const uint8_t *data = FlashMemory_Cache::readInPlace(tag, data_length);
 
   if (data_length == 0) {
     throw Exceptions::IOException;
@@ -285,9 +263,7 @@ FlashMemory_Handler::getDataInPlaceFromTag(const fs::Tag &tag) {
 void FlashMemory_Handler::setDataFromTag(const fs::Tag &tag, uint32_t length,
                                          const uint8_t data[]) {
 
-  if (fs_write(&(tag.value[0]), tag.len, data, length)) {
-    throw Exceptions::IOException;
-  }
+  FlashMemory_Cache::write(tag, data, length);
 }
 
 /**
@@ -298,6 +274,7 @@ void FlashMemory_Handler::setDataFromTag(const fs::Tag &tag, uint32_t length,
 const fs::Tag FlashMemory_Handler::getPackagesListTag() noexcept {
   fs::Tag tag;
   path_package_list(&(tag.value), &(tag.len));
+  tag.rehash();
   return tag;
 }
 
@@ -310,6 +287,7 @@ const fs::Tag
 FlashMemory_Handler::getCapTag(const jpackage_ID_t package) noexcept {
   fs::Tag tag;
   path_cap(package, &(tag.value), &(tag.len));
+  tag.rehash();
   return tag;
 }
 
@@ -326,6 +304,7 @@ FlashMemory_Handler::getStaticFieldTag(const jpackage_ID_t package,
                                        const uint8_t static_id) noexcept {
   fs::Tag tag;
   path_static(package, static_id, &(tag.value), &(tag.len));
+  tag.rehash();
   return tag;
 }
 
@@ -345,12 +324,14 @@ const fs::Tag FlashMemory_Handler::getPersistentFieldTag(
   fs::Tag tag;
   path_applet_field(applet_owner, package, claz, field, &(tag.value),
                     &(tag.len));
+  tag.rehash();
   return tag;
 }
 
 /**
  * Get a static field from a tag. This field should be a serialized instance or
- * array
+ * array. A persistent object is loaded once in the heap: the next calls
+ * return the same reference until the object is collected or overwritten.
  *
  * @param[tag] the data tag value to read.
  *
@@ -358,6 +339,30 @@ const fs::Tag FlashMemory_Handler::getPersistentFieldTag(
  */
 jref_t FlashMemory_Handler::getPersistentField_Reference(const fs::Tag &tag,
                                                          Heap &heap) {
+  if (auto objectref = heap.findPersistentObject(tag)) {
+    return *objectref;
+  }
+
+  jref_t objectref =
+      FlashMemory_Handler::loadPersistentField_Reference(tag, heap);
+
+  if (!objectref.isNullPointer()) {
+    heap.addPersistentObject(tag, objectref);
+  }
+
+  return objectref;
+}
+
+/**
+ * Load a static field in the heap from a tag. This field should be a
+ * serialized instance or array.
+ *
+ * @param[tag] the data tag value to read.
+ *
+ * @return the loaded static field value.
+ */
+jref_t FlashMemory_Handler::loadPersistentField_Reference(const fs::Tag &tag,
+                                                          Heap &heap) {
   uint32_t length = 0;
   const uint8_t *data = nullptr;
 
@@ -374,7 +379,7 @@ jref_t FlashMemory_Handler::getPersistentField_Reference(const fs::Tag &tag,
   }
 
   FieldType type = static_cast<FieldType>(data[0]);
-  uint16_t size = BYTES_TO_SHORT(data[2], data[1]);
+  uint16_t size = BYTES_TO_SHORT(data[1], data[2]);
 
   switch (type) {
   case FieldType::FIELD_TYPE_ARRAY_BYTE: {
@@ -474,73 +479,83 @@ jref_t FlashMemory_Handler::getPersistentField_Reference(const fs::Tag &tag,
 void FlashMemory_Handler::setPersistentField_Array(const fs::Tag &tag,
                                                    JC_Array &array,
                                                    Heap &heap) {
-  FieldType type;
-
-  switch (array.getType()) {
-  case JAVA_ARRAY_T_BOOLEAN:
-    if (array.isTransientArray()) {
-      type = FieldType::FIELD_TYPE_TRANSIENT_ARRAY_BOOLEAN;
-    } else {
-      type = FieldType::FIELD_TYPE_ARRAY_BOOLEAN;
-    }
-
-    break;
-
-  case JAVA_ARRAY_T_BYTE:
-    if (array.isTransientArray()) {
-      type = FieldType::FIELD_TYPE_TRANSIENT_ARRAY_BYTE;
-    } else {
-      type = FieldType::FIELD_TYPE_ARRAY_BYTE;
-    }
+  heap.removePersistentObject(tag);
+  FlashMemory_Handler::writeArray(tag, array.getFieldType(), array, heap,
+                                  false);
+}
 
-    break;
+/*
+ * Write static instance field from tag
+ *
+ * @param[tag] associated tag
+ * @param[instance] instance to write
+ * @param[heap] associated heap
+ */
+void FlashMemory_Handler::setPersistentField_Instance(
+    const fs::Tag &tag, const JC_Instance &instance, Heap &heap) {
+  heap.removePersistentObject(tag);
+  FlashMemory_Handler::writeInstance(tag, instance, heap, false);
+}
 
-  case JAVA_ARRAY_T_SHORT:
-    if (array.isTransientArray()) {
-      type = FieldType::FIELD_TYPE_TRANSIENT_ARRAY_SHORT;
-    } else {
-      type = FieldType::FIELD_TYPE_ARRAY_SHORT;
-    }
+/*
+ * Write an instance or an array field from tag. Only the modified parts of
+ * the object graph are written:
+ * - the persistent object loaded from the tag is already stored,
+ * - a RAM object unchanged since it was stored at the tag is not written
+ *   again, but the objects it references are checked in turn.
+ *
+ * @param[tag] associated tag
+ * @param[objectref] instance or array to write
+ * @param[heap] associated heap
+ */
+void FlashMemory_Handler::setPersistentField_Reference(const fs::Tag &tag,
+                                                       const jref_t objectref,
+                                                       Heap &heap) {
+  if (heap.findPersistentObject(tag) == objectref) {
+    return;
+  }
 
-    break;
+  const bool isUnchanged = heap.isStoredObject(tag, objectref);
+  bool isPersistent = false;
 
-#ifdef JCVM_INT_SUPPORTED
+  if (objectref.isArray()) {
+    auto array = heap.getArray(objectref);
+    isPersistent = array->isPersistent();
 
-  case JAVA_ARRAY_T_INT:
-    if (array.isTransientArray()) {
-      type = FieldType::FIELD_TYPE_TRANSIENT_ARRAY_INT;
+    if (isUnchanged) {
+      FlashMemory_Handler::writeArray(tag, array->getFieldType(), *array,
+                                      heap, true);
     } else {
-      type = FieldType::FIELD_TYPE_ARRAY_INT;
+      FlashMemory_Handler::setPersistentField_Array(tag, *array, heap);
     }
+  } else {
+    auto instance = heap.getInstance(objectref);
+    isPersistent = instance->isPersistent();
 
-    break;
-#endif /* JCVM_INT_SUPPORTED */
-
-  case JAVA_ARRAY_T_REFERENCE:
-    if (array.isTransientArray()) {
-      type = FieldType::FIELD_TYPE_TRANSIENT_ARRAY_OBJECT;
+    if (isUnchanged) {
+      FlashMemory_Handler::writeInstance(tag, *instance, heap, true);
     } else {
-      type = FieldType::FIELD_TYPE_ARRAY_OBJECT;
+      FlashMemory_Handler::setPersistentField_Instance(tag, *instance, heap);
     }
-
-    break;
-
-  default:
-    throw Exceptions::SecurityException;
   }
 
-  FlashMemory_Handler::writeArray(tag, type, array, heap);
+  if (!isPersistent) {
+    heap.addStoredObject(tag, objectref);
+  }
 }
 
 /*
- * Write static instance field from tag
+ * Write persistent instance data. The reference fields are stored at their
+ * own tags: they are written even if the instance is unchanged.
  *
  * @param[tag] associated tag
  * @param[instance] instance to write
  * @param[heap] associated heap
+ * @param[isUnchanged] is the instance already stored at the tag?
  */
-void FlashMemory_Handler::setPersistentField_Instance(
-    const fs::Tag &tag, const JC_Instance &instance, Heap &heap) {
+void FlashMemory_Handler::writeInstance(const fs::Tag &tag,
+                                        const JC_Instance &instance,
+                                        Heap &heap, const bool isUnchanged) {
   auto fields = instance.getFields();
 
   if (fields == nullptr) {
@@ -548,37 +563,52 @@ void FlashMemory_Handler::setPersistentField_Instance(
     throw Exceptions::SecurityException;
   }
 
-  FlashMemory_Handler::writeInstanceHeader(tag, instance.getPackageID(),
-                                           instance.getClassIndex());
+  if (!isUnchanged) {
+    FlashMemory_Handler::writeInstanceHeader(tag, instance.getPackageID(),
+                                             instance.getClassIndex());
+  }
 
   for (uint16_t idx = 0; idx < fields->size(); idx++) {
 
     fs::Tag field_tag = FlashMemory_Handler::computeTag(tag, idx);
 
-    jc_field_t field = fields->at(idx);
+    const jword_t value = fields->at(idx);
 
-    switch (field.type) {
+#ifdef JCVM_TYPED_HEAP
+    FieldType type = instance.getFieldType(idx);
+
+    if (type == FieldType::FIELD_TYPE_UNINITIALIZED) {
+      // A field never set holds its default value.
+      type = FieldType::FIELD_TYPE_SHORT;
+    }
+#else  /* !JCVM_TYPED_HEAP */
+    // Without field types, the field words, references included, are saved
+    // as short values: the referenced objects are not stored.
+    const FieldType type = FieldType::FIELD_TYPE_SHORT;
+#endif /* JCVM_TYPED_HEAP */
+
+    if (isUnchanged && !isReferenceFieldType(type)) {
+      continue;
+    }
+
+    switch (type) {
     case FieldType::FIELD_TYPE_BYTE:
     case FieldType::FIELD_TYPE_BOOLEAN: {
-      const uint8_t data[] = {field.type, static_cast<uint8_t>(field.value)};
+      const uint8_t data[] = {type, static_cast<uint8_t>(value)};
 
-      if (fs_write(field_tag.value, field_tag.len, data,
-                   sizeof(jbyte_t) + sizeof(uint8_t))) {
-        throw Exceptions::IOException;
-      }
+      FlashMemory_Cache::write(field_tag, data,
+                               sizeof(jbyte_t) + sizeof(uint8_t));
 
       break;
     }
 
     case FieldType::FIELD_TYPE_SHORT: {
       const uint8_t data[] = {
-          field.type, static_cast<uint8_t>(HIGH_BYTE_SHORT(field.value)),
-          static_cast<uint8_t>(LOW_BYTE_SHORT(field.value))};
+          type, static_cast<uint8_t>(HIGH_BYTE_SHORT(value)),
+          static_cast<uint8_t>(LOW_BYTE_SHORT(value))};
 
-      if (fs_write(field_tag.value, field_tag.len, data,
-                   sizeof(jshort_t) + sizeof(uint8_t))) {
-        throw Exceptions::IOException;
-      }
+      FlashMemory_Cache::write(field_tag, data,
+                               sizeof(jshort_t) + sizeof(uint8_t));
 
       break;
     }
@@ -586,21 +616,19 @@ void FlashMemory_Handler::setPersistentField_Instance(
 #ifdef JCVM_INT_SUPPORTED
 
     case FieldType::FIELD_TYPE_INT: {
-      jc_field_t field_low = fields->at(++idx);
-      jint_t value = SHORTS_TO_INT(static_cast<jshort_t>(field.value),
-                                   static_cast<jshort_t>(field_low.value));
+      const jword_t value_low = fields->at(++idx);
+      jint_t int_value = SHORTS_TO_INT(static_cast<jshort_t>(value),
+                                       static_cast<jshort_t>(value_low));
       const uint8_t data[] = {
-          field.type,
-          static_cast<uint8_t>(HIGH_BYTE_SHORT(INT_2_MSSHORTS(value))),
-          static_cast<uint8_t>(LOW_BYTE_SHORT(INT_2_MSSHORTS(value))),
-          static_cast<uint8_t>(HIGH_BYTE_SHORT(INT_2_LSSHORTS(value))),
-          static_cast<uint8_t>(LOW_BYTE_SHORT(INT_2_LSSHORTS(value))),
+          type,
+          static_cast<uint8_t>(HIGH_BYTE_SHORT(INT_2_MSSHORTS(int_value))),
+          static_cast<uint8_t>(LOW_BYTE_SHORT(INT_2_MSSHORTS(int_value))),
+          static_cast<uint8_t>(HIGH_BYTE_SHORT(INT_2_LSSHORTS(int_value))),
+          static_cast<uint8_t>(LOW_BYTE_SHORT(INT_2_LSSHORTS(int_value))),
       };
 
-      if (fs_write(field_tag.value, field_tag.len, data,
-                   sizeof(jint_t) + sizeof(uint8_t))) {
-        throw Exceptions::IOException;
-      }
+      FlashMemory_Cache::write(field_tag, data,
+                               sizeof(jint_t) + sizeof(uint8_t));
 
       break;
     }
@@ -608,15 +636,14 @@ void FlashMemory_Handler::setPersistentField_Instance(
 #endif /* JCVM_INT_SUPPORTED */
 
     case FieldType::FIELD_TYPE_OBJECT: {
-      jref_t objectref = static_cast<jref_t>(field.value);
+      jref_t objectref = static_cast<jref_t>(value);
 
       if (objectref.isArray()) {
         throw Exceptions::SecurityException;
       }
 
-      auto field_instance = heap.getInstance(objectref);
-      FlashMemory_Handler::setPersistentField_Instance(field_tag,
-                                                       *field_instance, heap);
+      FlashMemory_Handler::setPersistentField_Reference(field_tag, objectref,
+                                                        heap);
       break;
     }
 
@@ -634,15 +661,14 @@ void FlashMemory_Handler::setPersistentField_Instance(
     case FieldType::FIELD_TYPE_TRANSIENT_ARRAY_INT:
 #endif /* JCVM_INT_SUPPORTED */
     case FieldType::FIELD_TYPE_TRANSIENT_ARRAY_OBJECT: {
-      jref_t arrayref = static_cast<jref_t>(field.value);
+      jref_t arrayref = static_cast<jref_t>(value);
 
       if (!arrayref.isArray()) { // Is an array?
         throw Exceptions::SecurityException;
       }
 
-      auto array = heap.getArray(arrayref);
-      FlashMemory_Handler::writeArray(field_tag, field.type, *array, heap);
-
+      FlashMemory_Handler::setPersistentField_Reference(field_tag, arrayref,
+                                                        heap);
       break;
     }
 
@@ -661,7 +687,7 @@ void FlashMemory_Handler::setPersistentField_Instance(
  * @return the requested field
  */
 const jbyte_t FlashMemory_Handler::getPersistentField_Byte(const fs::Tag &tag) {
-  auto [length, data] = FlashMemory_Handler::getDataFromTag(tag);
+  auto [length, data] = FlashMemory_Handler::getScalarDataFromTag(tag);
 
 #ifdef JCVM_ARRAY_SIZE_CHECK
 
@@ -715,7 +741,7 @@ void FlashMemory_Handler::setPersistentField_Byte(const fs::Tag &tag,
  */
 const jshort_t
 FlashMemory_Handler::getPersistentField_Short(const fs::Tag &tag) {
-  auto [length, data] = FlashMemory_Handler::getDataFromTag(tag);
+  auto [length, data] = FlashMemory_Handler::getScalarDataFromTag(tag);
 
 #ifdef JCVM_ARRAY_SIZE_CHECK
 
@@ -768,7 +794,7 @@ void FlashMemory_Handler::setPersistentField_Short(const fs::Tag &tag,
  *  @return the requested field
  */
 const jint_t FlashMemory_Handler::getPersistentField_Int(const fs::Tag &tag) {
-  auto [length, data] = FlashMemory_Handler::getDataFromTag(tag);
+  auto [length, data] = FlashMemory_Handler::getScalarDataFromTag(tag);
 
 #ifdef JCVM_ARRAY_SIZE_CHECK
 
@@ -821,7 +847,7 @@ void FlashMemory_Handler::setPersistentField_Int(const fs::Tag &tag,
  *
  * @return the requested field as an array.
  */
-std::shared_ptr<JC_Array>
+JC_Array
 FlashMemory_Handler::getPersistentField_Array(const fs::Tag &tag, Heap &heap) {
   auto [length, array_flash] = FlashMemory_Handler::getDataInPlaceFromTag(tag);
 
@@ -915,8 +941,8 @@ FlashMemory_Handler::getPersistentField_Array(const fs::Tag &tag, Heap &heap) {
     throw Exceptions::SecurityException;
   }
 
-  return std::make_shared<JC_Array>(heap, array_type, reference_type, tag,
-                                    isTransient, event, size);
+  return JC_Array(heap, array_type, reference_type, tag, isTransient, event,
+                  size);
 }
 
 /*
@@ -929,26 +955,8 @@ FlashMemory_Handler::getPersistentField_Array(const fs::Tag &tag, Heap &heap) {
  */
 const jbyte_t
 FlashMemory_Handler::getPersistentField_Array_Byte(const fs::Tag &tag,
-                                                   const uint16_t index
-#ifdef JCVM_SECURE_HEAP_ACCESS
-                                                   ,
-                                                   Heap &heap
-#endif /* JCVM_SECURE_HEAP_ACCESS */
-) {
-  uint8_t value;
-
-#ifdef JCVM_SECURE_HEAP_ACCESS
-  auto array = FlashMemory_Handler::getPersistentField_Array(tag, heap);
-
-  if (array->size() <= index) {
-    throw Exceptions::SecurityException;
-  }
-
-#endif /* JCVM_SECURE_HEAP_ACCESS */
-
-  if (fs_read_1b_at(&(tag.value[0]), tag.len, index, &value)) {
-    throw Exceptions::IOException;
-  }
+                                                   const uint16_t index) {
+  const uint8_t value = FlashMemory_Cache::read_1b_at(tag, index);
 
   return static_cast<const jbyte_t>(value);
 }
@@ -962,24 +970,8 @@ FlashMemory_Handler::getPersistentField_Array_Byte(const fs::Tag &tag,
  */
 void FlashMemory_Handler::setPersistentField_Array_Byte(const fs::Tag &tag,
                                                         const uint16_t index,
-                                                        const jbyte_t value
-#ifdef JCVM_SECURE_HEAP_ACCESS
-                                                        ,
-                                                        Heap &heap
-#endif /* JCVM_SECURE_HEAP_ACCESS */
-) {
-#ifdef JCVM_SECURE_HEAP_ACCESS
-  auto array = FlashMemory_Handler::getPersistentField_Array(tag, heap);
-
-  if (array->size() <= index) {
-    throw Exceptions::SecurityException;
-  }
-
-#endif /* JCVM_SECURE_HEAP_ACCESS */
-
-  if (fs_write_1b_at(&(tag.value[0]), tag.len, index, value)) {
-    throw Exceptions::IOException;
-  }
+                                                        const jbyte_t value) {
+  FlashMemory_Cache::write_1b_at(tag, index, value);
 }
 
 /*
@@ -992,26 +984,8 @@ void FlashMemory_Handler::setPersistentField_Array_Byte(const fs::Tag &tag,
  */
 const jshort_t
 FlashMemory_Handler::getPersistentField_Array_Short(const fs::Tag &tag,
-                                                    const uint16_t index
-#ifdef JCVM_SECURE_HEAP_ACCESS
-                                                    ,
-                                                    Heap &heap
-#endif /* JCVM_SECURE_HEAP_ACCESS */
-) {
-  uint16_t value;
-
-#ifdef JCVM_SECURE_HEAP_ACCESS
-  auto array = FlashMemory_Handler::getPersistentField_Array(tag, heap);
-
-  if (array->size() <= index) {
-    throw Exceptions::SecurityException;
-  }
-
-#endif /* JCVM_SECURE_HEAP_ACCESS */
-
-  if (fs_read_2b_at(&(tag.value[0]), tag.len, index, &value)) {
-    throw Exceptions::IOException;
-  }
+                                                    const uint16_t index) {
+  const uint16_t value = FlashMemory_Cache::read_2b_at(tag, index);
 
   return static_cast<const jshort_t>(value);
 }
@@ -1025,24 +999,8 @@ FlashMemory_Handler::getPersistentField_Array_Short(const fs::Tag &tag,
  */
 void FlashMemory_Handler::setPersistentField_Array_Short(const fs::Tag &tag,
                                                          const uint16_t index,
-                                                         const jshort_t value
-#ifdef JCVM_SECURE_HEAP_ACCESS
-                                                         ,
-                                                         Heap &heap
-#endif /* JCVM_SECURE_HEAP_ACCESS */
-) {
-#ifdef JCVM_SECURE_HEAP_ACCESS
-  auto array = FlashMemory_Handler::getPersistentField_Array(tag, heap);
-
-  if (array->size() <= index) {
-    throw Exceptions::SecurityException;
-  }
-
-#endif /* JCVM_SECURE_HEAP_ACCESS */
-
-  if (fs_write_2b_at(&(tag.value[0]), tag.len, index, value)) {
-    throw Exceptions::IOException;
-  }
+                                                         const jshort_t value) {
+  FlashMemory_Cache::write_2b_at(tag, index, value);
 }
 
 #ifdef JCVM_INT_SUPPORTED
@@ -1057,26 +1015,8 @@ void FlashMemory_Handler::setPersistentField_Array_Short(const fs::Tag &tag,
  */
 const jint_t
 FlashMemory_Handler::getPersistentField_Array_Int(const fs::Tag &tag,
-                                                  const uint16_t index
-#ifdef JCVM_SECURE_HEAP_ACCESS
-                                                  ,
-                                                  Heap &heap
-#endif /* JCVM_SECURE_HEAP_ACCESS */
-) {
-  uint32_t value;
-
-#ifdef JCVM_SECURE_HEAP_ACCESS
-  auto array = FlashMemory_Handler::getPersistentField_Array(tag, heap);
-
-  if (array->size() <= index) {
-    throw Exceptions::SecurityException;
-  }
-
-#endif /* JCVM_SECURE_HEAP_ACCESS */
-
-  if (fs_read_4b_at(&(tag.value[0]), tag.len, index, &value)) {
-    throw Exceptions::IOException;
-  }
+                                                  const uint16_t index) {
+  const uint32_t value = FlashMemory_Cache::read_4b_at(tag, index);
 
   return static_cast<const jint_t>(value);
 }
@@ -1090,24 +1030,8 @@ FlashMemory_Handler::getPersistentField_Array_Int(const fs::Tag &tag,
  */
 void FlashMemory_Handler::setPersistentField_Array_Int(const fs::Tag &tag,
                                                        const uint16_t index,
-                                                       const jint_t value
-#ifdef JCVM_SECURE_HEAP_ACCESS
-                                                       ,
-                                                       Heap &heap
-#endif /* JCVM_SECURE_HEAP_ACCESS */
-) {
-#ifdef JCVM_SECURE_HEAP_ACCESS
-  auto array = FlashMemory_Handler::getPersistentField_Array(tag, heap);
-
-  if (array->size() <= index) {
-    throw Exceptions::SecurityException;
-  }
-
-#endif /* JCVM_SECURE_HEAP_ACCESS */
-
-  if (fs_write_4b_at(&(tag.value[0]), tag.len, index, value)) {
-    throw Exceptions::IOException;
-  }
+                                                       const jint_t value) {
+  FlashMemory_Cache::write_4b_at(tag, index, value);
 }
 #endif /* JCVM_INT_SUPPORTED */
 
@@ -1122,26 +1046,12 @@ void FlashMemory_Handler::setPersistentField_Array_Int(const fs::Tag &tag,
 const jref_t FlashMemory_Handler::getPersistentField_Array_Reference(
     const fs::Tag &tag, const uint16_t index, Heap &heap) {
 
-#ifdef JCVM_SECURE_HEAP_ACCESS
-  {
-    auto array = FlashMemory_Handler::getPersistentField_Array(tag, heap);
-
-    if (array->isTransientArray()) {
-      throw Exceptions::SecurityException;
-    }
-
-    if (array->getType() != JAVA_ARRAY_T_REFERENCE) {
-      throw Exceptions::SecurityException;
-    }
-  }
-#endif /* JCVM_SECURE_HEAP_ACCESS */
-
   if ((tag.len + 2) > (sizeof(tag.value) / sizeof(tag.value[0]))) {
     throw Exceptions::IOException;
   }
 
   fs::Tag field_tag = FlashMemory_Handler::computeTag(tag, index);
-  return FlashMemory_Handler::getPersistentField_Reference(tag, heap);
+  return FlashMemory_Handler::getPersistentField_Reference(field_tag, heap);
 }
 
 /*
@@ -1154,30 +1064,9 @@ const jref_t FlashMemory_Handler::getPersistentField_Array_Reference(
 void FlashMemory_Handler::setPersistentField_Array_Reference(
     const fs::Tag &tag, const uint16_t index, const jref_t value, Heap &heap) {
 
-#ifdef JCVM_SECURE_HEAP_ACCESS
-  auto array = FlashMemory_Handler::getPersistentField_Array(tag, heap);
-
-  if (array->size() <= index) {
-    throw Exceptions::SecurityException;
-  }
-
-#endif /* JCVM_SECURE_HEAP_ACCESS */
-
   fs::Tag field_tag = FlashMemory_Handler::computeTag(tag, index);
-  field_tag.len = tag.len;
-
-  for (uint8_t idx = 0; idx < tag.len; idx++) {
-    field_tag.value[idx] = tag.value[idx];
-  }
 
-  if (value.isArray()) {
-    auto array = heap.getArray(value);
-    return FlashMemory_Handler::setPersistentField_Array(tag, *array, heap);
-  } else {
-    auto instance = heap.getInstance(value);
-    return FlashMemory_Handler::setPersistentField_Instance(tag, *instance,
-                                                            heap);
-  }
+  FlashMemory_Handler::setPersistentField_Reference(field_tag, value, heap);
 }
 
 /**
@@ -1206,17 +1095,16 @@ void FlashMemory_Handler::enablePackage(const jpackage_ID_t id) {
   auto &tag = FlashMemory_Handler::getPackagesListTag();
   uint8_t packages_byte;
 
+  // The package set is updated: the resolved CAP file is outdated.
+  Package_Registry::invalidate(id);
+
   // Reading the value to update
-  if (fs_read_1b_at(tag.value, tag.len, (id / 8), &packages_byte)) {
-    throw Exceptions::IOException;
-  }
+  packages_byte = FlashMemory_Cache::read_1b_at(tag, (id / 8));
 
   packages_byte |= (1 << (id % 8));
 
   // Writing the updated value
-  if (fs_write_1b_at(tag.value, tag.len, (id / 8), packages_byte)) {
-    throw Exceptions::IOException;
-  }
+  FlashMemory_Cache::write_1b_at(tag, (id / 8), packages_byte);
 }
 
 /**
@@ -1229,17 +1117,16 @@ void FlashMemory_Handler::disablePackage(const jpackage_ID_t id) {
   auto &tag = FlashMemory_Handler::getPackagesListTag();
   uint8_t packages_byte;
 
+  // The package set is updated: the resolved CAP file is outdated.
+  Package_Registry::invalidate(id);
+
   // Reading the value to update
-  if (fs_read_1b_at(tag.value, tag.len, (id / 8), &packages_byte)) {
-    throw Exceptions::IOException;
-  }
+  packages_byte = FlashMemory_Cache::read_1b_at(tag, (id / 8));
 
   packages_byte &= ~(1 << (id % 8));
 
   // Writing the updated value
-  if (fs_write_1b_at(tag.value, tag.len, (id / 8), packages_byte)) {
-    throw Exceptions::IOException;
-  }
+  FlashMemory_Cache::write_1b_at(tag, (id / 8), packages_byte);
 }
 
 /**
@@ -1252,9 +1139,7 @@ bool FlashMemory_Handler::isPackageExist(const jpackage_ID_t id) {
   uint8_t packages_byte;
 
   // Reading the value to update
-  if (fs_read_1b_at(tag.value, tag.len, (id / 8), &packages_byte)) {
-    throw Exceptions::IOException;
-  }
+  packages_byte = FlashMemory_Cache::read_1b_at(tag, (id / 8));
 
   return packages_byte & (1 << (id % 8));
 }
@@ -1272,4 +1157,84 @@ JC_Cap FlashMemory_Handler::getCap(const jpackage_ID_t packageID) {
   return JC_Cap(cap.first, cap.second);
 }
 
+/**
+ * Begin a transaction. The persistent writes until the transaction end are
+ * kept in RAM, and the flash memory is not written before the commit. A write
+ * which does not fit in the commit capacity aborts the transaction.
+ * Transactions cannot be nested.
+ */
+void FlashMemory_Handler::beginTransaction() {
+  if (FlashMemory_Cache::isJournalInProgress()) {
+    throw Exceptions::TransactionException;
+  }
+
+  FlashMemory_Cache::startJournal();
+}
+
+/**
+ * Commit the transaction in progress. The persistent writes of the
+ * transaction are written to the flash memory in one sequence, in write
+ * order.
+ */
+void FlashMemory_Handler::commitTransaction() {
+  if (!FlashMemory_Cache::isJournalInProgress()) {
+    throw Exceptions::TransactionException;
+  }
+
+  FlashMemory_Cache::commitJournal();
+}
+
+/**
+ * Abort the transaction in progress. The persistent writes of the
+ * transaction are dropped, and the persistent objects loaded in the heap are
+ * loaded again on their next access.
+ *
+ * @param[heap] heap of the running context.
+ */
+void FlashMemory_Handler::abortTransaction(Heap &heap) {
+  if (!FlashMemory_Cache::isJournalInProgress()) {
+    throw Exceptions::TransactionException;
+  }
+
+  FlashMemory_Cache::rollbackJournal();
+  heap.removePersistentObjects();
+}
+
+/**
+ * Get the transaction nesting depth.
+ *
+ * @return 1 if a transaction is in progress, 0 otherwise.
+ */
+uint8_t FlashMemory_Handler::getTransactionDepth() noexcept {
+  return FlashMemory_Cache::isJournalInProgress() ? 1 : 0;
+}
+
+/**
+ * Get the commit capacity left in the transaction in progress.
+ *
+ * @return the bytes which can still be written by the transaction.
+ */
+uint16_t FlashMemory_Handler::getUnusedCommitCapacity() noexcept {
+  return JCVM_TRANSACTION_CAPACITY - FlashMemory_Cache::getJournalBytes();
+}
+
+/**
+ * Get the commit capacity of a transaction.
+ *
+ * @return the bytes which can be written by a transaction.
+ */
+uint16_t FlashMemory_Handler::getMaxCommitCapacity() noexcept {
+  return JCVM_TRANSACTION_CAPACITY;
+}
+
+/**
+ * Leave the next persistent writes out of the transaction in progress, as
+ * done by the non-atomic array methods, or not.
+ *
+ * @param[isNonAtomic] are the next persistent writes non-atomic?
+ */
+void FlashMemory_Handler::setNonAtomicWrites(const bool isNonAtomic) noexcept {
+  FlashMemory_Cache::suspendJournal(isNonAtomic);
+}
+
 } // namespace jcvm
@@ -33,6 +33,7 @@
 #include "../jc_types/jc_field.hpp"
 #include "../jc_types/jref_t.hpp"
 
+#include "fs_tag.hpp"
 #include "jc_cap.hpp"
 
 #include <memory>
@@ -44,21 +45,11 @@ class JC_Array;    // Forward declaration of JC_Array
 class JC_Instance; // Forward declaration of JC_Instance
 class Heap;        // Forward declaration of Heap
 
-namespace fs {
-
-#define TAG_MAX_LENGTH 32
-
-struct Tag {
-  uint8_t len = 0;
-  uint8_t value[TAG_MAX_LENGTH] = {0};
-};
-
-} // namespace fs
-
 class FlashMemory_Handler {
 private:
-  /// Read data from tag
-  static std::pair<uint32_t, uint8_t *> getDataFromTag(const fs::Tag &tag);
+  /// Read scalar data in place from tag
+  static std::pair<uint32_t, const uint8_t *>
+  getScalarDataFromTag(const fs::Tag &tag);
   /// Read data in place from tag
   static std::pair<uint32_t, const uint8_t *>
   getDataInPlaceFromTag(const fs::Tag &tag);
@@ -73,7 +64,13 @@ private:
 
   /// Write array data
   static void writeArray(const fs::Tag &tag, const FieldType type,
-                         JC_Array &array, Heap &heap);
+                         JC_Array &array, Heap &heap, const bool isUnchanged);
+  /// Write instance data
+  static void writeInstance(const fs::Tag &tag, const JC_Instance &instance,
+                            Heap &heap, const bool isUnchanged);
+
+  /// Load a persistent instance or array field in the heap
+  static jref_t loadPersistentField_Reference(const fs::Tag &tag, Heap &heap);
 
 public:
   ///  Compute tag to access to persistant data
@@ -100,8 +97,7 @@ public:
   static jbyte_t getByteFromAddr(const uint8_t *const address) noexcept;
 
   /// Get array data store in flash memory.
-  static std::shared_ptr<JC_Array> getPersistentField_Array(const fs::Tag &tag,
-                                                            Heap &heap);
+  static JC_Array getPersistentField_Array(const fs::Tag &tag, Heap &heap);
   /// Get array data store in flash memory.
   static void setPersistentField_Array(const fs::Tag &tag, JC_Array &array,
                                        Heap &heap);
@@ -125,61 +121,34 @@ public:
   /// Set int data store in flash memory.
   static void setPersistentField_Int(const fs::Tag &tag, jint_t value);
 #endif /* JCVM_INT_SUPPORTED */
-  /// Get int data store in flash memory.
+  /// Get the heap object of a persistent instance or array field.
   static jref_t getPersistentField_Reference(const fs::Tag &tag, Heap &heap);
+  /// Set instance or array data store in flash memory.
+  static void setPersistentField_Reference(const fs::Tag &tag,
+                                           const jref_t objectref, Heap &heap);
 
   /// Get array data store value in flash memory at a specific index.
   static const jbyte_t getPersistentField_Array_Byte(const fs::Tag &tag,
-                                                     const uint16_t index
-#ifdef JCVM_SECURE_HEAP_ACCESS
-                                                     ,
-                                                     Heap &heap
-#endif /* JCVM_SECURE_HEAP_ACCESS */
-  );
+                                                     const uint16_t index);
   /// Set array data store in flash memory at a specific index.
   static void setPersistentField_Array_Byte(const fs::Tag &tag,
                                             const uint16_t index,
-                                            const jbyte_t value
-#ifdef JCVM_SECURE_HEAP_ACCESS
-                                            ,
-                                            Heap &heap
-#endif /* JCVM_SECURE_HEAP_ACCESS */
-  );
+                                            const jbyte_t value);
   /// Get array data store in flash memory at a specific index.
   static const jshort_t getPersistentField_Array_Short(const fs::Tag &tag,
-                                                       const uint16_t index
-#ifdef JCVM_SECURE_HEAP_ACCESS
-                                                       ,
-                                                       Heap &heap
-#endif /* JCVM_SECURE_HEAP_ACCESS */
-  );
+                                                       const uint16_t index);
   /// Set array data store in flash memory at a specific index.
   static void setPersistentField_Array_Short(const fs::Tag &tag,
                                              const uint16_t index,
-                                             const jshort_t value
-#ifdef JCVM_SECURE_HEAP_ACCESS
-                                             ,
-                                             Heap &heap
-#endif /* JCVM_SECURE_HEAP_ACCESS */
-  );
+                                             const jshort_t value);
 #ifdef JCVM_INT_SUPPORTED
   /// Get array data store in flash memory at a specific index.
   static const jint_t getPersistentField_Array_Int(const fs::Tag &tag,
-                                                   const uint16_t index
-#ifdef JCVM_SECURE_HEAP_ACCESS
-                                                   ,
-                                                   Heap &heap
-#endif /* JCVM_SECURE_HEAP_ACCESS */
-  );
+                                                   const uint16_t index);
   /// Set array data store in flash memory at a specific index.
   static void setPersistentField_Array_Int(const fs::Tag &tag,
                                            const uint16_t index,
-                                           const jint_t value
-#ifdef JCVM_SECURE_HEAP_ACCESS
-                                           ,
-                                           Heap &heap
-#endif /* JCVM_SECURE_HEAP_ACCESS */
-  );
+                                           const jint_t value);
 #endif /* JCVM_INT_SUPPORTED */
   /// Get array data store in flash memory at a specific index.
   static const jref_t getPersistentField_Array_Reference(const fs::Tag &tag,
@@ -201,6 +170,21 @@ public:
   static bool isPackageExist(const jpackage_ID_t id);
   /// Get a CAP file from a package ID.
   static JC_Cap getCap(const jpackage_ID_t packageID);
+
+  /// Begin a transaction.
+  static void beginTransaction();
+  /// Commit the transaction in progress.
+  static void commitTransaction();
+  /// Abort the transaction in progress.
+  static void abortTransaction(Heap &heap);
+  /// Get the transaction nesting depth.
+  static uint8_t getTransactionDepth() noexcept;
+  /// Get the commit capacity left in the transaction in progress.
+  static uint16_t getUnusedCommitCapacity() noexcept;
+  /// Get the commit capacity of a transaction.
+  static uint16_t getMaxCommitCapacity() noexcept;
+  /// Leave the next persistent writes out of the transaction, or not.
+  static void setNonAtomicWrites(const bool isNonAtomic) noexcept;
 };
 
 } // namespace jcvm
@@ -0,0 +1,971 @@
+/*
+** The MIT License (MIT)
+**
+** Copyright (c) 2020, National Cybersecurity Agency of France (ANSSI)
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+** Author:
+**   - Guillaume Bouffard <guillaume.bouffard@ssi.gouv.fr>
+*/
+
+
+#include "flashmemory_cache.hpp"
+#include "../exceptions.hpp"
+#include "ffi.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef PC_VERSION
+extern uint32_t flash_length;
+#endif /* PC_VERSION */
+
+namespace jcvm {
+
+FlashMemory_Cache::Entry
+    FlashMemory_Cache::entries[JCVM_WRITE_BACK_CACHE_SIZE] = {};
+uint8_t FlashMemory_Cache::next_eviction = 0;
+FlashMemory_Cache::Stats FlashMemory_Cache::stats;
+bool FlashMemory_Cache::isJournalStarted = false;
+bool FlashMemory_Cache::isJournalSuspended = false;
+std::vector<FlashMemory_Cache::JournalRecord> FlashMemory_Cache::journal;
+uint16_t FlashMemory_Cache::journal_bytes = 0;
+std::vector<FlashMemory_Cache::JournalRecord> FlashMemory_Cache::journal_views;
+uint32_t FlashMemory_Cache::rollbacks = 0;
+#ifdef PC_VERSION
+std::vector<bool> FlashMemory_Cache::modified_chunks;
+bool FlashMemory_Cache::isDataMoved = false;
+#endif /* PC_VERSION */
+
+/**
+ * Find a pending write.
+ *
+ * @param[tag] written tag.
+ * @param[isWhole] is the whole tag data written?
+ * @param[index] written element index, if an element is written.
+ * @param[length] written element length, if an element is written.
+ *
+ * @return the pending write entry, or nullptr if there is none.
+ */
+FlashMemory_Cache::Entry *
+FlashMemory_Cache::find(const fs::Tag &tag, const bool isWhole,
+                        const uint32_t index, const uint8_t length) noexcept {
+  for (auto &entry : FlashMemory_Cache::entries) {
+    if (entry.isUsed && (entry.isWhole == isWhole) &&
+        (isWhole || ((entry.index == index) && (entry.length == length))) &&
+        (entry.tag == tag)) {
+      return &entry;
+    }
+  }
+
+  return nullptr;
+}
+
+/**
+ * Copy the bytes of a write which overlap a buffer of the same tag data.
+ *
+ * @param[data] buffer to update.
+ * @param[index] buffer index in the tag data.
+ * @param[length] buffer length.
+ * @param[written] written bytes.
+ * @param[written_index] written bytes index in the tag data.
+ * @param[written_length] written bytes length.
+ */
+void FlashMemory_Cache::copyOverlap(uint8_t *data, const uint32_t index,
+                                    const uint32_t length,
+                                    const uint8_t *written,
+                                    const uint32_t written_index,
+                                    const uint32_t written_length) noexcept {
+  const uint32_t begin = std::max(index, written_index);
+  const uint32_t end =
+      std::min(index + length, written_index + written_length);
+
+  if (begin < end) {
+    std::memcpy(data + (begin - index), written + (begin - written_index),
+                end - begin);
+  }
+}
+
+/**
+ * Write data to the file system.
+ *
+ * @param[tag] written tag.
+ * @param[isWhole] is the whole tag data written?
+ * @param[index] written element index, if an element is written.
+ * @param[data] written data.
+ * @param[length] written data length, the element width if an element is
+ * written.
+ */
+void FlashMemory_Cache::writeToFileSystem(const fs::Tag &tag,
+                                          const bool isWhole,
+                                          const uint32_t index,
+                                          const uint8_t *data,
+                                          const uint32_t length) {
+  const uint8_t *tag_value = &(tag.value[0]);
+  int error = 0;
+#ifdef PC_VERSION
+  const uint32_t previous_flash_length = flash_length;
+#endif /* PC_VERSION */
+
+  if (isWhole) {
+    error = fs_write(tag_value, tag.len, data, length);
+  } else if (length == sizeof(uint8_t)) {
+    error = fs_write_1b_at(tag_value, tag.len, index, data[0]);
+  } else if (length == sizeof(uint16_t)) {
+    uint16_t value;
+    std::memcpy(&value, data, sizeof(value));
+    error = fs_write_2b_at(tag_value, tag.len, index, value);
+  } else {
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    error = fs_write_4b_at(tag_value, tag.len, index, value);
+  }
+
+  if (error) {
+    throw Exceptions::IOException;
+  }
+
+#ifdef PC_VERSION
+  FlashMemory_Cache::markWritten(tag, isWhole, index, length,
+                                 previous_flash_length);
+#endif /* PC_VERSION */
+}
+
+/**
+ * Write a pending write to the file system and release its entry. The entry
+ * is kept if the write fails.
+ *
+ * @param[entry] pending write to write back.
+ */
+void FlashMemory_Cache::writeBack(Entry &entry) {
+  FlashMemory_Cache::writeToFileSystem(entry.tag, entry.isWhole, entry.index,
+                                       entry.data, entry.length);
+
+  FlashMemory_Cache::stats.flushed_bytes += entry.length;
+  entry.isUsed = false;
+}
+
+/**
+ * Write back the pending writes of a tag.
+ *
+ * @param[tag] written tag.
+ * @param[isWhole] write back the whole tag data write, or the element
+ * writes?
+ */
+void FlashMemory_Cache::flush(const fs::Tag &tag, const bool isWhole) {
+  for (auto &entry : FlashMemory_Cache::entries) {
+    if (entry.isUsed && (entry.isWhole == isWhole) && (entry.tag == tag)) {
+      FlashMemory_Cache::writeBack(entry);
+    }
+  }
+}
+
+/**
+ * Drop the pending writes of a tag, once they are overwritten.
+ *
+ * @param[tag] written tag.
+ * @param[isWhole] drop the whole tag data write, or the element writes?
+ */
+void FlashMemory_Cache::discard(const fs::Tag &tag,
+                                const bool isWhole) noexcept {
+  for (auto &entry : FlashMemory_Cache::entries) {
+    if (entry.isUsed && (entry.isWhole == isWhole) && (entry.tag == tag)) {
+      entry.isUsed = false;
+    }
+  }
+}
+
+/**
+ * Record a pending write. A pending write of the same data is replaced,
+ * otherwise the entry is taken from the free entries or evicted in
+ * round-robin order. The pending element writes which overlap a new element
+ * write are updated with its bytes, so that the pending writes of a tag never
+ * disagree.
+ *
+ * @param[tag] written tag.
+ * @param[isWhole] is the whole tag data written?
+ * @param[index] written element index, if an element is written.
+ * @param[data] written data.
+ * @param[length] written data length.
+ */
+void FlashMemory_Cache::put(const fs::Tag &tag, const bool isWhole,
+                            const uint32_t index, const uint8_t *data,
+                            const uint8_t length) {
+  Entry *entry = FlashMemory_Cache::find(tag, isWhole, index, length);
+
+  if (!isWhole) {
+    for (auto &other : FlashMemory_Cache::entries) {
+      if (other.isUsed && !other.isWhole && (&other != entry) &&
+          (other.tag == tag)) {
+        FlashMemory_Cache::copyOverlap(other.data, other.index, other.length,
+                                       data, index, length);
+      }
+    }
+  }
+
+  if (entry != nullptr) {
+    FlashMemory_Cache::stats.coalesced_writes++;
+  } else {
+    for (auto &free_entry : FlashMemory_Cache::entries) {
+      if (!free_entry.isUsed) {
+        entry = &free_entry;
+        break;
+      }
+    }
+
+    if (entry == nullptr) {
+      entry = &(FlashMemory_Cache::entries[FlashMemory_Cache::next_eviction]);
+      FlashMemory_Cache::next_eviction =
+          (FlashMemory_Cache::next_eviction + 1) % JCVM_WRITE_BACK_CACHE_SIZE;
+      FlashMemory_Cache::writeBack(*entry);
+      FlashMemory_Cache::stats.evictions++;
+    }
+
+    entry->isUsed = true;
+    entry->isWhole = isWhole;
+    entry->tag = tag;
+    entry->index = index;
+  }
+
+  entry->length = length;
+  std::copy_n(data, length, entry->data);
+}
+
+/**
+ * Read an element, from the cache if the element write is pending. The
+ * bytes of the pending element writes which overlap the element, with
+ * another index or width, are copied over the element read in the file
+ * system, then the bytes of the journal writes.
+ *
+ * @param[tag] read tag.
+ * @param[index] element index.
+ * @param[data] read element.
+ * @param[length] element length.
+ */
+void FlashMemory_Cache::readAt(const fs::Tag &tag, const uint32_t index,
+                               uint8_t *data, const uint8_t length) {
+  const JournalRecord *record = FlashMemory_Cache::findRecord(
+      FlashMemory_Cache::journal, tag, true, 0, 0);
+
+  if (record != nullptr) {
+    if ((index > record->data.size()) ||
+        ((record->data.size() - index) < length)) {
+      throw Exceptions::IOException;
+    }
+
+    std::memcpy(data, record->data.data() + index, length);
+    return;
+  }
+
+  FlashMemory_Cache::flush(tag, true);
+
+  const Entry *entry = FlashMemory_Cache::find(tag, false, index, length);
+
+  if (entry != nullptr) {
+    FlashMemory_Cache::stats.hits++;
+    std::memcpy(data, entry->data, length);
+  } else {
+    const uint8_t *tag_value = &(tag.value[0]);
+    int error = 0;
+
+    if (length == sizeof(uint8_t)) {
+      error = fs_read_1b_at(tag_value, tag.len, index, data);
+    } else if (length == sizeof(uint16_t)) {
+      uint16_t value;
+      error = fs_read_2b_at(tag_value, tag.len, index, &value);
+      std::memcpy(data, &value, sizeof(value));
+    } else {
+      uint32_t value;
+      error = fs_read_4b_at(tag_value, tag.len, index, &value);
+      std::memcpy(data, &value, sizeof(value));
+    }
+
+    if (error) {
+      throw Exceptions::IOException;
+    }
+
+    for (const auto &other : FlashMemory_Cache::entries) {
+      if (other.isUsed && !other.isWhole && (other.tag == tag)) {
+        FlashMemory_Cache::copyOverlap(data, index, length, other.data,
+                                       other.index, other.length);
+      }
+    }
+  }
+
+  FlashMemory_Cache::readRecords(tag, data, index, length);
+}
+
+/**
+ * Write an element, in the journal if it is started. Otherwise a pending
+ * write of the whole tag data is written back first, and the journal writes
+ * of the tag are updated with the element, so that a write left out of the
+ * journal is not undone by its commit.
+ *
+ * @param[tag] written tag.
+ * @param[index] element index.
+ * @param[data] element value.
+ * @param[length] element length.
+ */
+void FlashMemory_Cache::writeAt(const fs::Tag &tag, const uint32_t index,
+                                const uint8_t *data, const uint8_t length) {
+  if (FlashMemory_Cache::isJournalWrite()) {
+    FlashMemory_Cache::writeJournal(tag, false, index, data, length);
+    return;
+  }
+
+  FlashMemory_Cache::updateRecords(tag, index, data, length);
+  FlashMemory_Cache::flush(tag, true);
+  FlashMemory_Cache::put(tag, false, index, data, length);
+}
+
+/**
+ * Are the writes kept in the journal? They are while the journal is started,
+ * unless it is suspended.
+ *
+ * @return true if the writes are kept in the journal.
+ */
+bool FlashMemory_Cache::isJournalWrite() noexcept {
+  return FlashMemory_Cache::isJournalStarted &&
+         !FlashMemory_Cache::isJournalSuspended;
+}
+
+/**
+ * Find a journal write.
+ *
+ * @param[records] journal writes or journal views to search.
+ * @param[tag] written tag.
+ * @param[isWhole] is the whole tag data written?
+ * @param[index] written element index, if an element is written.
+ * @param[length] written element length, if an element is written.
+ *
+ * @return the journal write, or nullptr if there is none.
+ */
+FlashMemory_Cache::JournalRecord *FlashMemory_Cache::findRecord(
+    std::vector<JournalRecord> &records, const fs::Tag &tag,
+    const bool isWhole, const uint32_t index, const uint32_t length) noexcept {
+  for (auto &record : records) {
+    if ((record.isWhole == isWhole) &&
+        (isWhole ||
+         ((record.index == index) && (record.data.size() == length))) &&
+        (record.tag == tag)) {
+      return &record;
+    }
+  }
+
+  return nullptr;
+}
+
+/**
+ * Drop the journal writes of a tag, once the whole tag data is written.
+ *
+ * @param[tag] written tag.
+ */
+void FlashMemory_Cache::dropRecords(const fs::Tag &tag) noexcept {
+  auto &journal = FlashMemory_Cache::journal;
+  auto &views = FlashMemory_Cache::journal_views;
+  const auto isTagRecord = [&tag](const JournalRecord &record) {
+    return record.tag == tag;
+  };
+
+  for (const auto &record : journal) {
+    if (isTagRecord(record)) {
+      FlashMemory_Cache::journal_bytes -= record.data.size();
+    }
+  }
+
+  journal.erase(std::remove_if(journal.begin(), journal.end(), isTagRecord),
+                journal.end());
+  views.erase(std::remove_if(views.begin(), views.end(), isTagRecord),
+              views.end());
+}
+
+/**
+ * Copy an element write over the journal writes and the journal views of its
+ * tag which overlap it, so that they never disagree.
+ *
+ * @param[tag] written tag.
+ * @param[index] element index.
+ * @param[data] element value.
+ * @param[length] element length.
+ */
+void FlashMemory_Cache::updateRecords(const fs::Tag &tag,
+                                      const uint32_t index,
+                                      const uint8_t *data,
+                                      const uint8_t length) noexcept {
+  for (auto *records :
+       {&FlashMemory_Cache::journal, &FlashMemory_Cache::journal_views}) {
+    for (auto &record : *records) {
+      if (record.tag == tag) {
+        FlashMemory_Cache::copyOverlap(record.data.data(), record.index,
+                                       record.data.size(), data, index,
+                                       length);
+      }
+    }
+  }
+}
+
+/**
+ * Copy the journal element writes of a tag which overlap a buffer of the tag
+ * data over the buffer.
+ *
+ * @param[tag] read tag.
+ * @param[data] buffer to update.
+ * @param[index] buffer index in the tag data.
+ * @param[length] buffer length.
+ */
+void FlashMemory_Cache::readRecords(const fs::Tag &tag, uint8_t *data,
+                                    const uint32_t index,
+                                    const uint32_t length) noexcept {
+  for (const auto &record : FlashMemory_Cache::journal) {
+    if (!record.isWhole && (record.tag == tag)) {
+      FlashMemory_Cache::copyOverlap(data, index, length, record.data.data(),
+                                     record.index, record.data.size());
+    }
+  }
+}
+
+/**
+ * Keep a write in the journal. A whole tag data write replaces the journal
+ * writes of the tag, an element write updates them. A new write which does
+ * not fit in the journal rolls the journal back.
+ *
+ * @param[tag] written tag.
+ * @param[isWhole] is the whole tag data written?
+ * @param[index] written element index, if an element is written.
+ * @param[data] written data.
+ * @param[length] written data length.
+ */
+void FlashMemory_Cache::writeJournal(const fs::Tag &tag, const bool isWhole,
+                                     const uint32_t index, const uint8_t *data,
+                                     const uint32_t length) {
+  bool isNew = true;
+
+  if (isWhole) {
+    FlashMemory_Cache::dropRecords(tag);
+  } else {
+    const JournalRecord *record = FlashMemory_Cache::findRecord(
+        FlashMemory_Cache::journal, tag, true, 0, 0);
+
+    if ((record != nullptr) && ((index > record->data.size()) ||
+                                ((record->data.size() - index) < length))) {
+      throw Exceptions::IOException;
+    }
+
+    isNew = (record == nullptr) &&
+            (FlashMemory_Cache::findRecord(FlashMemory_Cache::journal, tag,
+                                           false, index, length) == nullptr);
+  }
+
+  if (isNew && ((FlashMemory_Cache::journal_bytes + length) >
+                JCVM_TRANSACTION_CAPACITY)) {
+    FlashMemory_Cache::rollbackJournal();
+    throw Exceptions::TransactionException;
+  }
+
+  if (!isWhole) {
+    FlashMemory_Cache::updateRecords(tag, index, data, (uint8_t)length);
+  }
+
+  if (isNew) {
+    FlashMemory_Cache::journal_bytes += length;
+    FlashMemory_Cache::journal.push_back(
+        {tag, isWhole, index, std::vector<uint8_t>(data, data + length)});
+  }
+}
+
+#ifdef PC_VERSION
+
+/**
+ * Record the flash memory modified by a write to the file system: the written
+ * tag data and the flash memory appended by the write. The Java Card OS file
+ * system may move the data of a tag written as a whole, and its metadata are
+ * not known here.
+ *
+ * @param[tag] written tag.
+ * @param[isWhole] is the whole tag data written?
+ * @param[index] written element index, if an element is written.
+ * @param[length] written data length.
+ * @param[previous_flash_length] used flash memory length before the write.
+ */
+void FlashMemory_Cache::markWritten(const fs::Tag &tag,
+                                    [[maybe_unused]] const bool isWhole,
+                                    const uint32_t index, const uint32_t length,
+                                    const uint32_t previous_flash_length) {
+  const uint8_t *data = nullptr;
+  uint32_t data_length = 0;
+
+  if (flash_length > previous_flash_length) {
+    FlashMemory_Cache::markModified(previous_flash_length,
+                                    flash_length - previous_flash_length);
+  }
+
+#ifndef JCVM_NATIVE_FS
+  if (isWhole) {
+    FlashMemory_Cache::markMoved();
+    return;
+  }
+#endif /* !JCVM_NATIVE_FS */
+
+  if (fs_read_inplace(&(tag.value[0]), tag.len, &data, &data_length)) {
+    FlashMemory_Cache::markMoved();
+    return;
+  }
+
+  FlashMemory_Cache::markModified(
+      static_cast<uint32_t>(data - flash_pointer()) + index, length);
+}
+
+#endif /* PC_VERSION */
+
+/**
+ * Get the tag data length.
+ *
+ * @param[tag] read tag.
+ *
+ * @return the tag data length.
+ */
+uint32_t FlashMemory_Cache::length(const fs::Tag &tag) {
+  const JournalRecord *record = FlashMemory_Cache::findRecord(
+      FlashMemory_Cache::journal, tag, true, 0, 0);
+
+  if (record != nullptr) {
+    return record->data.size();
+  }
+
+  const Entry *entry = FlashMemory_Cache::find(tag, true, 0, 0);
+
+  if (entry != nullptr) {
+    FlashMemory_Cache::stats.hits++;
+    return entry->length;
+  }
+
+  uint32_t length = 0;
+
+  if (fs_length(&(tag.value[0]), tag.len, &length)) {
+    throw Exceptions::IOException;
+  }
+
+  return length;
+}
+
+/**
+ * Read the tag data, with the journal writes of the tag.
+ *
+ * @param[tag] read tag.
+ * @param[data] read data.
+ * @param[length] length to read.
+ */
+void FlashMemory_Cache::read(const fs::Tag &tag, uint8_t *data,
+                             const uint32_t length) {
+  const JournalRecord *record = FlashMemory_Cache::findRecord(
+      FlashMemory_Cache::journal, tag, true, 0, 0);
+
+  if (record != nullptr) {
+    if (length > record->data.size()) {
+      throw Exceptions::IOException;
+    }
+
+    std::memcpy(data, record->data.data(), length);
+    return;
+  }
+
+  const Entry *entry = FlashMemory_Cache::find(tag, true, 0, 0);
+
+  if (entry != nullptr) {
+    if (length > entry->length) {
+      throw Exceptions::IOException;
+    }
+
+    FlashMemory_Cache::stats.hits++;
+    std::memcpy(data, entry->data, length);
+  } else {
+    FlashMemory_Cache::flush(tag, false);
+
+    if (fs_read(&(tag.value[0]), tag.len, data, length)) {
+      throw Exceptions::IOException;
+    }
+  }
+
+  FlashMemory_Cache::readRecords(tag, data, 0, length);
+}
+
+/**
+ * Read the tag data in place. The pending writes of the tag are written back
+ * first. A tag with journal writes is read in the journal: from its whole
+ * tag data write, or from a journal view, a copy of the tag data with the
+ * journal element writes applied, kept until the journal end.
+ *
+ * @param[tag] read tag.
+ * @param[length] read data length.
+ *
+ * @return a pointer to the tag data, valid until the next write.
+ */
+const uint8_t *FlashMemory_Cache::readInPlace(const fs::Tag &tag,
+                                              uint32_t &length) {
+  const JournalRecord *record = FlashMemory_Cache::findRecord(
+      FlashMemory_Cache::journal, tag, true, 0, 0);
+
+  if (record == nullptr) {
+    record = FlashMemory_Cache::findRecord(FlashMemory_Cache::journal_views,
+                                           tag, true, 0, 0);
+  }
+
+  if (record != nullptr) {
+    length = record->data.size();
+    return record->data.data();
+  }
+
+  const uint8_t *data = nullptr;
+
+  FlashMemory_Cache::flush(tag, true);
+  FlashMemory_Cache::flush(tag, false);
+
+  if (fs_read_inplace(&(tag.value[0]), tag.len, &data, &length)) {
+    throw Exceptions::IOException;
+  }
+
+  const bool isJournaled =
+      std::any_of(FlashMemory_Cache::journal.begin(),
+                  FlashMemory_Cache::journal.end(),
+                  [&tag](const JournalRecord &record) {
+                    return record.tag == tag;
+                  });
+
+  if (!isJournaled) {
+    return data;
+  }
+
+  auto &view = FlashMemory_Cache::journal_views.emplace_back(
+      JournalRecord{tag, true, 0, std::vector<uint8_t>(data, data + length)});
+  FlashMemory_Cache::readRecords(tag, view.data.data(), 0, length);
+
+  return view.data.data();
+}
+
+/**
+ * Read a small tag data in place. A pending write of the whole tag data is
+ * read from the cache, unless the tag has journal writes, otherwise the tag
+ * data is read as by readInPlace(). Unlike readInPlace(), a pending whole tag
+ * data is not written back.
+ *
+ * @param[tag] read tag.
+ * @param[length] read data length.
+ *
+ * @return a pointer to the tag data, valid until the next write.
+ */
+const uint8_t *FlashMemory_Cache::readScalar(const fs::Tag &tag,
+                                             uint32_t &length) {
+  const Entry *entry = FlashMemory_Cache::find(tag, true, 0, 0);
+  const bool isJournaled =
+      std::any_of(FlashMemory_Cache::journal.begin(),
+                  FlashMemory_Cache::journal.end(),
+                  [&tag](const JournalRecord &record) {
+                    return record.tag == tag;
+                  });
+
+  if ((entry != nullptr) && !isJournaled) {
+    FlashMemory_Cache::stats.hits++;
+    length = entry->length;
+    return entry->data;
+  }
+
+  return FlashMemory_Cache::readInPlace(tag, length);
+}
+
+/**
+ * Write the tag data, in the journal if it is started. Otherwise small data
+ * are kept in the cache, bigger ones are written through, and the journal
+ * writes of the tag are dropped.
+ *
+ * @param[tag] written tag.
+ * @param[data] data to write.
+ * @param[length] data length.
+ */
+void FlashMemory_Cache::write(const fs::Tag &tag, const uint8_t *data,
+                              const uint32_t length) {
+  if (FlashMemory_Cache::isJournalWrite()) {
+    FlashMemory_Cache::writeJournal(tag, true, 0, data, length);
+    return;
+  }
+
+  FlashMemory_Cache::dropRecords(tag);
+  FlashMemory_Cache::discard(tag, false);
+
+  if (length <= FS_CACHE_DATA_MAX_LENGTH) {
+    FlashMemory_Cache::put(tag, true, 0, data, (uint8_t)length);
+    return;
+  }
+
+  FlashMemory_Cache::discard(tag, true);
+  FlashMemory_Cache::writeToFileSystem(tag, true, 0, data, length);
+
+  FlashMemory_Cache::stats.written_through_bytes += length;
+}
+
+/**
+ * Read a 1-byte element.
+ *
+ * @param[tag] read tag.
+ * @param[index] element index.
+ *
+ * @return the element value.
+ */
+uint8_t FlashMemory_Cache::read_1b_at(const fs::Tag &tag,
+                                      const uint32_t index) {
+  uint8_t value;
+  FlashMemory_Cache::readAt(tag, index, &value, sizeof(value));
+  return value;
+}
+
+/**
+ * Read a 2-byte element.
+ *
+ * @param[tag] read tag.
+ * @param[index] element index.
+ *
+ * @return the element value.
+ */
+uint16_t FlashMemory_Cache::read_2b_at(const fs::Tag &tag,
+                                       const uint32_t index) {
+  uint16_t value;
+  FlashMemory_Cache::readAt(tag, index, reinterpret_cast<uint8_t *>(&value),
+                            sizeof(value));
+  return value;
+}
+
+/**
+ * Read a 4-byte element.
+ *
+ * @param[tag] read tag.
+ * @param[index] element index.
+ *
+ * @return the element value.
+ */
+uint32_t FlashMemory_Cache::read_4b_at(const fs::Tag &tag,
+                                       const uint32_t index) {
+  uint32_t value;
+  FlashMemory_Cache::readAt(tag, index, reinterpret_cast<uint8_t *>(&value),
+                            sizeof(value));
+  return value;
+}
+
+/**
+ * Write a 1-byte element.
+ *
+ * @param[tag] written tag.
+ * @param[index] element index.
+ * @param[value] element value.
+ */
+void FlashMemory_Cache::write_1b_at(const fs::Tag &tag, const uint32_t index,
+                                    const uint8_t value) {
+  FlashMemory_Cache::writeAt(tag, index, &value, sizeof(value));
+}
+
+/**
+ * Write a 2-byte element.
+ *
+ * @param[tag] written tag.
+ * @param[index] element index.
+ * @param[value] element value.
+ */
+void FlashMemory_Cache::write_2b_at(const fs::Tag &tag, const uint32_t index,
+                                    const uint16_t value) {
+  FlashMemory_Cache::writeAt(tag, index,
+                             reinterpret_cast<const uint8_t *>(&value),
+                             sizeof(value));
+}
+
+/**
+ * Write a 4-byte element.
+ *
+ * @param[tag] written tag.
+ * @param[index] element index.
+ * @param[value] element value.
+ */
+void FlashMemory_Cache::write_4b_at(const fs::Tag &tag, const uint32_t index,
+                                    const uint32_t value) {
+  FlashMemory_Cache::writeAt(tag, index,
+                             reinterpret_cast<const uint8_t *>(&value),
+                             sizeof(value));
+}
+
+/**
+ * Write back all the pending writes.
+ */
+void FlashMemory_Cache::flush() {
+  for (auto &entry : FlashMemory_Cache::entries) {
+    if (entry.isUsed) {
+      FlashMemory_Cache::writeBack(entry);
+    }
+  }
+}
+
+/**
+ * Get the cache statistics.
+ *
+ * @return the cache statistics.
+ */
+const FlashMemory_Cache::Stats &FlashMemory_Cache::getStats() noexcept {
+  return FlashMemory_Cache::stats;
+}
+
+/**
+ * Start keeping the next writes in the journal.
+ */
+void FlashMemory_Cache::startJournal() noexcept {
+  FlashMemory_Cache::isJournalStarted = true;
+  FlashMemory_Cache::isJournalSuspended = false;
+  FlashMemory_Cache::journal.clear();
+  FlashMemory_Cache::journal_views.clear();
+  FlashMemory_Cache::journal_bytes = 0;
+}
+
+/**
+ * Write the journal writes to the file system, in write order. The pending
+ * writes of the cache are older, and are written back first.
+ */
+void FlashMemory_Cache::commitJournal() {
+  std::vector<JournalRecord> records;
+
+  records.swap(FlashMemory_Cache::journal);
+  FlashMemory_Cache::isJournalStarted = false;
+  FlashMemory_Cache::journal_views.clear();
+  FlashMemory_Cache::journal_bytes = 0;
+
+  FlashMemory_Cache::flush();
+
+  for (const auto &record : records) {
+    FlashMemory_Cache::writeToFileSystem(record.tag, record.isWhole,
+                                         record.index, record.data.data(),
+                                         record.data.size());
+    FlashMemory_Cache::stats.flushed_bytes += record.data.size();
+  }
+}
+
+/**
+ * Drop the journal writes. The file system is not written.
+ */
+void FlashMemory_Cache::rollbackJournal() noexcept {
+  FlashMemory_Cache::isJournalStarted = false;
+  FlashMemory_Cache::journal.clear();
+  FlashMemory_Cache::journal_views.clear();
+  FlashMemory_Cache::journal_bytes = 0;
+  FlashMemory_Cache::rollbacks++;
+}
+
+/**
+ * Leave the next writes out of the journal, or keep them again. A write left
+ * out of the journal is not undone by a rollback.
+ *
+ * @param[isSuspended] are the next writes left out of the journal?
+ */
+void FlashMemory_Cache::suspendJournal(const bool isSuspended) noexcept {
+  FlashMemory_Cache::isJournalSuspended = isSuspended;
+}
+
+/**
+ * Is the journal started?
+ *
+ * @return true if the writes are kept in the journal.
+ */
+bool FlashMemory_Cache::isJournalInProgress() noexcept {
+  return FlashMemory_Cache::isJournalStarted;
+}
+
+/**
+ * Get the bytes of written data kept in the journal.
+ *
+ * @return the journal size.
+ */
+uint16_t FlashMemory_Cache::getJournalBytes() noexcept {
+  return FlashMemory_Cache::journal_bytes;
+}
+
+/**
+ * Get the number of rolled back journals, so that the data read during a
+ * rolled back journal can be read again.
+ *
+ * @return the number of rollbacks.
+ */
+uint32_t FlashMemory_Cache::getRollbacks() noexcept {
+  return FlashMemory_Cache::rollbacks;
+}
+
+#ifdef PC_VERSION
+
+/**
+ * Record a modified flash memory range.
+ *
+ * @param[offset] range offset in the flash memory.
+ * @param[length] range length.
+ */
+void FlashMemory_Cache::markModified(const uint32_t offset,
+                                     const uint32_t length) {
+  if (length == 0) {
+    return;
+  }
+
+  const uint32_t last_chunk =
+      (offset + length - 1) / FS_CACHE_MODIFIED_CHUNK_SIZE;
+
+  if (FlashMemory_Cache::modified_chunks.size() <= last_chunk) {
+    FlashMemory_Cache::modified_chunks.resize(last_chunk + 1, false);
+  }
+
+  for (uint32_t chunk = offset / FS_CACHE_MODIFIED_CHUNK_SIZE;
+       chunk <= last_chunk; chunk++) {
+    FlashMemory_Cache::modified_chunks[chunk] = true;
+  }
+}
+
+/**
+ * Record that data of the file system are moved: the modified flash memory
+ * chunks are no longer known.
+ */
+void FlashMemory_Cache::markMoved() noexcept {
+  FlashMemory_Cache::isDataMoved = true;
+}
+
+/**
+ * Is a flash memory chunk modified?
+ *
+ * @param[offset] offset in the flash memory chunk.
+ *
+ * @return true if the chunk is modified.
+ */
+bool FlashMemory_Cache::isModified(const uint32_t offset) noexcept {
+  const uint32_t chunk = offset / FS_CACHE_MODIFIED_CHUNK_SIZE;
+
+  return (chunk < FlashMemory_Cache::modified_chunks.size()) &&
+         FlashMemory_Cache::modified_chunks[chunk];
+}
+
+/**
+ * Are data of the file system moved?
+ *
+ * @return true if the modified flash memory chunks are not known.
+ */
+bool FlashMemory_Cache::isMoved() noexcept {
+  return FlashMemory_Cache::isDataMoved;
+}
+
+#endif /* PC_VERSION */
+
+} // namespace jcvm
@@ -0,0 +1,261 @@
+/*
+** The MIT License (MIT)
+**
+** Copyright (c) 2020, National Cybersecurity Agency of France (ANSSI)
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+** Author:
+**   - Guillaume Bouffard <guillaume.bouffard@ssi.gouv.fr>
+*/
+
+
+#ifndef _FLASHMEMORY_CACHE_HPP
+#define _FLASHMEMORY_CACHE_HPP
+
+#include "../jc_config.h"
+#include "../types.hpp"
+#include "fs_tag.hpp"
+
+#include <vector>
+
+namespace jcvm {
+
+/// Maximal length of a whole tag data kept in the cache.
+#define FS_CACHE_DATA_MAX_LENGTH (uint8_t)8 // bytes
+
+#ifdef PC_VERSION
+/// Granularity of the modified flash memory tracking.
+#define FS_CACHE_MODIFIED_CHUNK_SIZE (uint32_t)4096 // bytes
+#endif /* PC_VERSION */
+
+/*
+ * Write-back cache between the flash memory handler and the file system.
+ *
+ * Small writes (scalar fields, instance headers and array elements) are kept
+ * in RAM. A new write to a pending tag data, or to a pending array element,
+ * replaces the pending value. Pending writes are written to the file system
+ * when they are evicted and when the cache is flushed. Reads return the
+ * pending values.
+ *
+ * A tag is either written as a whole, or by elements: pending element writes
+ * of a tag are dropped when the whole tag data is written, and written back
+ * before the whole tag data is read. Pending element writes of a tag may
+ * overlap with other indexes or widths: they are kept consistent, and an
+ * element read gathers the bytes of all of them.
+ *
+ * While the journal is started, the writes are kept in the journal instead, a
+ * RAM redo buffer, and the file system is not written: neither write-through
+ * nor eviction. Reads return the journal data. The journal is written to the
+ * file system in write order when it is committed, and dropped when it is
+ * rolled back. The journal size is bounded by JCVM_TRANSACTION_CAPACITY: a
+ * write which does not fit rolls the journal back.
+ *
+ * On PC, the flash memory chunks modified by the writes to the file system
+ * are recorded, so that only these chunks are saved in the flash memory file.
+ * Writes which may move data of the file system are recorded apart.
+ */
+class FlashMemory_Cache {
+public:
+  /// Cache statistics
+  struct Stats {
+    /// Reads answered from the cache
+    uint32_t hits = 0;
+    /// Writes replacing a pending write
+    uint32_t coalesced_writes = 0;
+    /// Pending writes evicted to make room for a new one
+    uint32_t evictions = 0;
+    /// Bytes written back to the file system
+    uint32_t flushed_bytes = 0;
+    /// Bytes written through to the file system, without being cached
+    uint32_t written_through_bytes = 0;
+  };
+
+private:
+  /// Pending write
+  struct Entry {
+    /// Is the entry used?
+    bool isUsed = false;
+    /// Is the whole tag data written, or an element at an index?
+    bool isWhole = false;
+    /// Written tag
+    fs::Tag tag;
+    /// Element index
+    uint32_t index = 0;
+    /// Written data length
+    uint8_t length = 0;
+    /// Written data
+    uint8_t data[FS_CACHE_DATA_MAX_LENGTH] = {0};
+  };
+
+  /// Write kept in the journal
+  struct JournalRecord {
+    /// Written tag
+    fs::Tag tag;
+    /// Is the whole tag data written, or an element at an index?
+    bool isWhole;
+    /// Element index
+    uint32_t index;
+    /// Written data
+    std::vector<uint8_t> data;
+  };
+
+  /// Pending writes
+  static Entry entries[JCVM_WRITE_BACK_CACHE_SIZE];
+  /// Next entry to evict when the cache is full
+  static uint8_t next_eviction;
+  /// Cache statistics
+  static Stats stats;
+  /// Is the journal started?
+  static bool isJournalStarted;
+  /// Are the writes left out of the journal?
+  static bool isJournalSuspended;
+  /// Journal writes, in write order
+  static std::vector<JournalRecord> journal;
+  /// Bytes of written data kept in the journal
+  static uint16_t journal_bytes;
+  /// Tag data read in place, with the journal element writes applied
+  static std::vector<JournalRecord> journal_views;
+  /// Number of rolled back journals
+  static uint32_t rollbacks;
+#ifdef PC_VERSION
+  /// Modified flash memory chunks
+  static std::vector<bool> modified_chunks;
+  /// Are data of the file system moved?
+  static bool isDataMoved;
+#endif /* PC_VERSION */
+
+  /// Find a pending write
+  static Entry *find(const fs::Tag &tag, const bool isWhole,
+                     const uint32_t index, const uint8_t length) noexcept;
+  /// Copy the bytes of a write which overlap a buffer of the same tag data
+  static void copyOverlap(uint8_t *data, const uint32_t index,
+                          const uint32_t length, const uint8_t *written,
+                          const uint32_t written_index,
+                          const uint32_t written_length) noexcept;
+  /// Write data to the file system
+  static void writeToFileSystem(const fs::Tag &tag, const bool isWhole,
+                                const uint32_t index, const uint8_t *data,
+                                const uint32_t length);
+  /// Write a pending write to the file system and release its entry
+  static void writeBack(Entry &entry);
+  /// Write back the pending writes of a tag
+  static void flush(const fs::Tag &tag, const bool isWhole);
+  /// Drop the pending writes of a tag
+  static void discard(const fs::Tag &tag, const bool isWhole) noexcept;
+  /// Record a pending write
+  static void put(const fs::Tag &tag, const bool isWhole, const uint32_t index,
+                  const uint8_t *data, const uint8_t length);
+  /// Read an element, from the cache if pending
+  static void readAt(const fs::Tag &tag, const uint32_t index, uint8_t *data,
+                     const uint8_t length);
+  /// Write an element
+  static void writeAt(const fs::Tag &tag, const uint32_t index,
+                      const uint8_t *data, const uint8_t length);
+  /// Are the writes kept in the journal?
+  static bool isJournalWrite() noexcept;
+  /// Find a journal write
+  static JournalRecord *findRecord(std::vector<JournalRecord> &records,
+                                   const fs::Tag &tag, const bool isWhole,
+                                   const uint32_t index,
+                                   const uint32_t length) noexcept;
+  /// Drop the journal writes of a tag
+  static void dropRecords(const fs::Tag &tag) noexcept;
+  /// Copy an element write over the journal writes of its tag
+  static void updateRecords(const fs::Tag &tag, const uint32_t index,
+                            const uint8_t *data,
+                            const uint8_t length) noexcept;
+  /// Copy the journal element writes of a tag over a buffer
+  static void readRecords(const fs::Tag &tag, uint8_t *data,
+                          const uint32_t index, const uint32_t length) noexcept;
+  /// Keep a write in the journal
+  static void writeJournal(const fs::Tag &tag, const bool isWhole,
+                           const uint32_t index, const uint8_t *data,
+                           const uint32_t length);
+#ifdef PC_VERSION
+  /// Record the flash memory modified by a write to the file system
+  static void markWritten(const fs::Tag &tag, const bool isWhole,
+                          const uint32_t index, const uint32_t length,
+                          const uint32_t previous_flash_length);
+#endif /* PC_VERSION */
+
+public:
+  /// Get the tag data length
+  static uint32_t length(const fs::Tag &tag);
+  /// Read the tag data
+  static void read(const fs::Tag &tag, uint8_t *data, const uint32_t length);
+  /// Read the tag data in place
+  static const uint8_t *readInPlace(const fs::Tag &tag, uint32_t &length);
+  /// Read a small tag data in place, from the cache if pending
+  static const uint8_t *readScalar(const fs::Tag &tag, uint32_t &length);
+  /// Write the tag data
+  static void write(const fs::Tag &tag, const uint8_t *data,
+                    const uint32_t length);
+
+  /// Read a 1-byte element
+  static uint8_t read_1b_at(const fs::Tag &tag, const uint32_t index);
+  /// Read a 2-byte element
+  static uint16_t read_2b_at(const fs::Tag &tag, const uint32_t index);
+  /// Read a 4-byte element
+  static uint32_t read_4b_at(const fs::Tag &tag, const uint32_t index);
+  /// Write a 1-byte element
+  static void write_1b_at(const fs::Tag &tag, const uint32_t index,
+                          const uint8_t value);
+  /// Write a 2-byte element
+  static void write_2b_at(const fs::Tag &tag, const uint32_t index,
+                          const uint16_t value);
+  /// Write a 4-byte element
+  static void write_4b_at(const fs::Tag &tag, const uint32_t index,
+                          const uint32_t value);
+
+  /// Write back all the pending writes
+  static void flush();
+  /// Get the cache statistics
+  static const Stats &getStats() noexcept;
+
+  /// Start keeping the writes in the journal
+  static void startJournal() noexcept;
+  /// Write the journal writes to the file system
+  static void commitJournal();
+  /// Drop the journal writes
+  static void rollbackJournal() noexcept;
+  /// Leave the next writes out of the journal, or not
+  static void suspendJournal(const bool isSuspended) noexcept;
+  /// Is the journal started?
+  static bool isJournalInProgress() noexcept;
+  /// Get the bytes kept in the journal
+  static uint16_t getJournalBytes() noexcept;
+  /// Get the number of rolled back journals
+  static uint32_t getRollbacks() noexcept;
+
+#ifdef PC_VERSION
+  /// Record a modified flash memory range
+  static void markModified(const uint32_t offset, const uint32_t length);
+  /// Record that data of the file system are moved
+  static void markMoved() noexcept;
+  /// Is a flash memory chunk modified?
+  static bool isModified(const uint32_t offset) noexcept;
+  /// Are data of the file system moved?
+  static bool isMoved() noexcept;
+#endif /* PC_VERSION */
+};
+
+} // namespace jcvm
+
+#endif /* _FLASHMEMORY_CACHE_HPP */
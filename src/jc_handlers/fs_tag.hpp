@@ -0,0 +1,125 @@
+/*
+** The MIT License (MIT)
+**
+** Copyright (c) 2020, National Cybersecurity Agency of France (ANSSI)
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+** Author:
+**   - Guillaume Bouffard <guillaume.bouffard@ssi.gouv.fr>
+*/
+
+
+#ifndef _FS_TAG_HPP
+#define _FS_TAG_HPP
+
+#include "../types.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+namespace jcvm {
+namespace fs {
+
+#define TAG_MAX_LENGTH 32
+/// 32-bit FNV-1a parameters of the tag keys.
+#define TAG_KEY_OFFSET_BASIS (uint32_t)2166136261u
+#define TAG_KEY_PRIME (uint32_t)16777619u
+
+/*
+ * File system tag. Besides its value, a tag holds a 32-bit key, the FNV-1a
+ * hash of its value. The key is updated in O(1) when a byte is appended, so
+ * that the nested tags (fields and array elements of persistent objects) are
+ * built from their parent tag without hashing it again. Tags are compared
+ * and indexed by key first.
+ *
+ * A tag whose value is filled from outside (the path_* functions) must be
+ * rehashed.
+ */
+struct Tag {
+  uint32_t key = TAG_KEY_OFFSET_BASIS;
+  uint8_t len = 0;
+  uint8_t value[TAG_MAX_LENGTH] = {0};
+
+  /// Compute the key from the value
+  void rehash() noexcept {
+    this->key = TAG_KEY_OFFSET_BASIS;
+
+    for (uint8_t idx = 0; idx < this->len; idx++) {
+      this->key = (this->key ^ this->value[idx]) * TAG_KEY_PRIME;
+    }
+  }
+
+  /// Append a byte to the value. The caller checks the tag capacity.
+  void append(const uint8_t byte) noexcept {
+    this->value[this->len++] = byte;
+    this->key = (this->key ^ byte) * TAG_KEY_PRIME;
+  }
+
+  /// Length of the stored tag: key, value length and value
+  uint16_t storedLength() const noexcept {
+    return sizeof(this->key) + sizeof(this->len) + this->len;
+  }
+
+  /// Store the tag, with its key, in a heap object body
+  void store(uint8_t *out) const noexcept {
+    std::memcpy(out, &(this->key), sizeof(this->key));
+    out[sizeof(this->key)] = this->len;
+    std::memcpy(out + sizeof(this->key) + sizeof(this->len), this->value,
+                this->len);
+  }
+
+  /// Load a tag stored in a heap object body
+  static Tag load(const uint8_t *in) noexcept {
+    Tag tag;
+
+    std::memcpy(&(tag.key), in, sizeof(tag.key));
+    tag.len = std::min(in[sizeof(tag.key)], (uint8_t)TAG_MAX_LENGTH);
+    std::memcpy(tag.value, in + sizeof(tag.key) + sizeof(tag.len), tag.len);
+
+    return tag;
+  }
+};
+
+/*
+ * Tag equality: the keys are compared first, then only the first len bytes
+ * of the values.
+ */
+inline bool operator==(const Tag &lhs, const Tag &rhs) noexcept {
+  if ((lhs.key != rhs.key) || (lhs.len != rhs.len)) {
+    return false;
+  }
+
+  return std::memcmp(lhs.value, rhs.value, lhs.len) == 0;
+}
+
+/*
+ * Tag hash to index containers by tag: the tag key.
+ */
+struct TagHash {
+  size_t operator()(const Tag &tag) const noexcept {
+    return static_cast<size_t>(tag.key);
+  }
+};
+
+} // namespace fs
+} // namespace jcvm
+
+#endif /* _FS_TAG_HPP */
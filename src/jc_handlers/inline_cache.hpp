@@ -0,0 +1,116 @@
+/*
+** The MIT License (MIT)
+**
+** Copyright (c) 2020, National Cybersecurity Agency of France (ANSSI)
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+** Author:
+**   - Guillaume Bouffard <guillaume.bouffard@ssi.gouv.fr>
+*/
+
+#ifndef _INLINE_CACHE_HPP
+#define _INLINE_CACHE_HPP
+
+#include "../jc_config.h"
+#include "../types.hpp"
+
+namespace jcvm {
+
+/*
+ * Inline cache of a virtual or interface call site. It maps the last
+ * receiver classes seen at this call site to the resolved method. When the
+ * cache is full, the oldest entry is replaced.
+ */
+class InlineCache {
+public:
+  /// Cached receiver class and its resolved method
+  struct Entry {
+    /// Package ID where the receiver class is located
+    jpackage_ID_t receiver_packageID;
+    /// Receiver class index
+    jclass_index_t receiver_class;
+    /// Package ID where the resolved method is located
+    jpackage_ID_t packageID;
+    /// Resolved method (with its header)
+    const uint8_t *method;
+  };
+
+private:
+  /// Cached receiver classes
+  Entry entries[JCVM_INLINE_CACHE_SIZE];
+  /// Number of cached receiver classes
+  uint8_t nb_entries = 0;
+  /// Next entry to replace when the cache is full
+  uint8_t next_entry = 0;
+  /// Arguments words of the call site, 0 until it is first resolved
+  uint8_t nargs = 0;
+
+public:
+  /// Get the arguments words of the call site
+  uint8_t getNargs() const noexcept { return this->nargs; }
+  /// Set the arguments words of the call site
+  void setNargs(const uint8_t nargs) noexcept { this->nargs = nargs; }
+
+  /*
+   * Look for a receiver class in the cache.
+   *
+   * @param[receiver_packageID] package ID where the receiver class is
+   *                            located.
+   * @param[receiver_class] receiver class index.
+   * @return the cached entry or nullptr on a cache miss.
+   */
+  const Entry *lookup(const jpackage_ID_t receiver_packageID,
+                      const jclass_index_t receiver_class) const noexcept {
+    for (uint8_t index = 0; index < this->nb_entries; index++) {
+      const Entry &entry = this->entries[index];
+
+      if ((entry.receiver_class == receiver_class) &&
+          (entry.receiver_packageID == receiver_packageID)) {
+        return &entry;
+      }
+    }
+
+    return nullptr;
+  }
+
+  /*
+   * Add a resolved receiver class in the cache.
+   *
+   * @param[entry] resolved receiver class to add.
+   * @return the cached entry.
+   */
+  const Entry *update(const Entry &entry) noexcept {
+    uint8_t index;
+
+    if (this->nb_entries < JCVM_INLINE_CACHE_SIZE) {
+      index = this->nb_entries++;
+    } else {
+      index = this->next_entry;
+      this->next_entry = (this->next_entry + 1) % JCVM_INLINE_CACHE_SIZE;
+    }
+
+    this->entries[index] = entry;
+    return &(this->entries[index]);
+  }
+};
+
+} // namespace jcvm
+
+#endif /* _INLINE_CACHE_HPP */
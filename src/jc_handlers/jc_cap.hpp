@@ -70,6 +70,8 @@ private:
   const jc_cap_descriptor_component *descriptor_comp = nullptr;
 
 public:
+  /// Empty CAP file constructor
+  JC_Cap() noexcept = default;
   /// default constructor
   JC_Cap(uint16_t length, const uint8_t *cap_file);
   JC_Cap(const JC_Cap &cap) noexcept = default;
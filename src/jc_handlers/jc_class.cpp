@@ -27,6 +27,7 @@
 
 #include "jc_class.hpp"
 #include "jc_cp.hpp"
+#include "jc_method.hpp"
 
 namespace jcvm {
 
@@ -62,6 +63,11 @@ namespace jcvm {
  * Similarly, in the recursive call, T, which was TC in the original call,
  * may be an interface type.
  *
+ * The check relies on the class hierarchy indexes: a class is a subclass of
+ * T when T is found in its superclasses display at the depth of T, and an
+ * interface is implemented when its interface ID is set in the implemented
+ * interfaces.
+ *
  * @param[jtype_in] the input type
  * @param[jtype_out] the out type
  *
@@ -74,120 +80,146 @@ Class_Handler::docheckcast(const std::pair<Package, const uint8_t *> jtype_in,
     noexcept
 #endif
 {
-  // case 1: type_in is a class type
-  if (IS_CLASS(jtype_in.second)) {
-    auto jclass_in = std::make_pair(
-        jtype_in.first,
-        reinterpret_cast<const jc_cap_class_info *>(jtype_in.second));
-
-    // case 1.1: type_out is a class type
-    if (IS_CLASS(jtype_out.second)) {
-      auto jclass_out =
-          reinterpret_cast<const jc_cap_class_info *>(jtype_out.second);
-
-      // then S must be the same class as T, or S must be a subclass of T
-      if (jclass_out->isObjectClass()) {
-        return TRUE;
-      }
+  const Package_Registry::TypeInfo &type_in =
+      Class_Handler::getTypeInfo(jtype_in);
 
-      while (!jclass_in.second->isObjectClass()) {
-        if (jclass_in.second == jclass_out) {
-          return TRUE;
-        }
+  // case 1: type_out is a class type
+  if (IS_CLASS(jtype_out.second)) {
+    auto jclass_out =
+        reinterpret_cast<const jc_cap_class_info *>(jtype_out.second);
 
-        jclass_in = ConstantPool_Handler(jclass_in.first)
-                        .classref2class(jclass_in.second->super_class_ref);
-      }
+    if (jclass_out->isObjectClass()) {
+      return TRUE;
+    }
 
+    // case 1.1: type_in is an interface type, then T must be Object
+    if (!IS_CLASS(jtype_in.second)) {
       return FALSE;
     }
-    // case 1.2: type_out is an interface type
-    else {
-      if (jclass_in.second->interface_count == 0) {
-        return FALSE;
-      }
 
-      for (uint8_t i = 0; i < jclass_in.second->interface_count; ++i) {
-        auto implemented_interface = jclass_in.second->interfaces(i);
-        ConstantPool_Handler cp(jclass_in.first);
+    // case 1.2: type_in is a class type, then S must be the same class as T,
+    // or S must be a subclass of T
+    const Package_Registry::TypeInfo &type_out =
+        Class_Handler::getTypeInfo(jtype_out);
+    size_t depth = type_out.display.size() - 1;
 
-        if (Class_Handler::checkInterfaceCast(
-                cp.resolveClassref(implemented_interface.interface),
-                jtype_out) == TRUE) {
-          return TRUE;
-        }
-      }
-    }
+    return (((depth < type_in.display.size()) &&
+             (type_in.display[depth] == jtype_out.second))
+                ? TRUE
+                : FALSE);
   }
 
-  // case 2: type_in is an interface type
-  else {
-    // jtype_out must be Object
-    if (IS_CLASS(jtype_out.second)) {
-      const auto jclass_out = std::make_pair(
-          jtype_out.first,
-          reinterpret_cast<const jc_cap_class_info *>(jtype_out.second));
-      return (jclass_out.second->isObjectClass() ? TRUE : FALSE);
-    }
+  // case 2: type_out is an interface type, then S must implement T (or be a
+  // subinterface of T)
+  const Package_Registry::TypeInfo &type_out =
+      Class_Handler::getTypeInfo(jtype_out);
 
-    return Class_Handler::checkInterfaceCast(jtype_in, jtype_out);
+  return (((type_out.interface_id < type_in.interfaces.size()) &&
+           type_in.interfaces[type_out.interface_id])
+              ? TRUE
+              : FALSE);
+}
+
+/*
+ * Add the interfaces of a class hierarchy index to another one.
+ *
+ * @param[type] class hierarchy index to update.
+ * @param[interfaces] class hierarchy index whose interfaces are added.
+ */
+void Class_Handler::addInterfaces(
+    Package_Registry::TypeInfo &type,
+    const Package_Registry::TypeInfo &interfaces) {
+  if (type.interfaces.size() < interfaces.interfaces.size()) {
+    type.interfaces.resize(interfaces.interfaces.size(), false);
   }
 
-  return FALSE;
+  for (size_t id = 0; id < interfaces.interfaces.size(); ++id) {
+    if (interfaces.interfaces[id]) {
+      type.interfaces[id] = true;
+    }
+  }
 }
 
 /*
- * Check if two interfaces (interface_in and interface_out) have a hierarchy
- * link together. This function returns TRUE when interface_in is the
- * daughter of interface_out.
+ * Get the class hierarchy index of a class or an interface. The index is
+ * built on the first access from the index of the superclass and of the
+ * implemented interfaces (or superinterfaces).
  *
- * @param[interface_in]
- * @param[interface_out]
+ * @param[jtype] package and class or interface info.
  *
- * @return returns TRUE when interface_in is the daughter of interface_out
+ * @return the class hierarchy index.
  */
-jbool_t Class_Handler::checkInterfaceCast(
-    const std::pair<Package, const uint8_t *> interface_in,
-    const std::pair<Package, const uint8_t *> interface_out)
-#if !defined(JCVM_ARRAY_SIZE_CHECK) && !defined(JCVM_DYNAMIC_CHECKS_CAP)
-    noexcept
-#endif
-{
+const Package_Registry::TypeInfo &
+Class_Handler::getTypeInfo(const std::pair<Package, const uint8_t *> jtype) {
+  Package_Registry::TypeInfo &type =
+      Package_Registry::getTypeInfo(jtype.first.getPackageID(), jtype.second);
+
+  if (type.isBuilt) {
+    return type;
+  }
+
+  ConstantPool_Handler cp_handler(jtype.first);
+
+  if (IS_CLASS(jtype.second)) {
+    auto claz = reinterpret_cast<const jc_cap_class_info *>(jtype.second);
+
+    if (!claz->isObjectClass()) {
+      auto super_class = cp_handler.classref2class(claz->super_class_ref);
+      const Package_Registry::TypeInfo &super_type =
+          Class_Handler::getTypeInfo(std::make_pair(
+              super_class.first,
+              reinterpret_cast<const uint8_t *>(super_class.second)));
+
+      type.display = super_type.display;
+      type.interfaces = super_type.interfaces;
+    }
+
+    type.display.push_back(jtype.second);
+
+    for (uint8_t index = 0; index < claz->interface_count; ++index) {
+      auto implemented_interface =
+          cp_handler.resolveClassref(claz->interfaces(index).interface);
 
 #ifdef JCVM_DYNAMIC_CHECKS_CAP
 
-  if (!IS_INTERFACE(interface_in.second) ||
-      !IS_INTERFACE(interface_out.second)) {
-    throw Exceptions::SecurityException;
-  }
+      if (!IS_INTERFACE(implemented_interface.second)) {
+        throw Exceptions::SecurityException;
+      }
 
 #endif /* JCVM_DYNAMIC_CHECKS_CAP */
 
-  auto superinterfaces =
-      reinterpret_cast<const jc_cap_interface_info *>(interface_in.second)
-          ->super_interfaces();
+      Class_Handler::addInterfaces(
+          type, Class_Handler::getTypeInfo(implemented_interface));
+    }
+  } else { // is an interface
+    auto superinterfaces =
+        reinterpret_cast<const jc_cap_interface_info *>(jtype.second)
+            ->super_interfaces();
 
-  for (uint8_t j = 0; j < superinterfaces.size(); ++j) {
-    const jc_cap_class_ref super_interface_in = superinterfaces.at(j);
+    type.interface_id = Package_Registry::newInterfaceID();
+    type.interfaces.resize(type.interface_id + 1, false);
+    type.interfaces[type.interface_id] = true;
 
-    auto super_interface_ptr = ConstantPool_Handler(interface_in.first)
-                                   .resolveClassref(super_interface_in);
+    for (uint8_t index = 0; index < superinterfaces.size(); ++index) {
+      auto superinterface =
+          cp_handler.resolveClassref(superinterfaces.at(index));
 
 #ifdef JCVM_DYNAMIC_CHECKS_CAP
 
-    if (!IS_INTERFACE(super_interface_ptr.second)) {
-      throw Exceptions::SecurityException;
-    }
+      if (!IS_INTERFACE(superinterface.second)) {
+        throw Exceptions::SecurityException;
+      }
 
 #endif /* JCVM_DYNAMIC_CHECKS_CAP */
 
-    if ((super_interface_ptr.first == interface_out.first) &&
-        (super_interface_ptr.second == interface_out.second)) {
-      return TRUE;
+      Class_Handler::addInterfaces(type,
+                                   Class_Handler::getTypeInfo(superinterface));
     }
   }
 
-  return FALSE;
+  type.isBuilt = true;
+
+  return type;
 }
 
 /*
@@ -214,242 +246,246 @@ Class_Handler::getObjectClassFromAnObjectRef(const jc_cap_class_ref classref)
 }
 
 /**
- * Get a class public method offset from a class' public method token.
- *
- * @param[public_method_token] public method token to resolve.
+ * Overlay a class method table on a flattened virtual method table. The
+ * methods inherited from the superclass are replaced by the methods
+ * defined in the class.
  *
- * @return the public virtual method offset in the Method component.
+ * @param[vtable] flattened virtual method table to update.
+ * @param[package] package where the class is defined.
+ * @param[method_table_base] first method token of the class method table.
+ * @param[method_table] class method table.
  */
-std::pair<Package, const uint16_t> Class_Handler::getPublicMethodOffset(
-    const jc_cap_virtual_method_ref_info virtual_method_ref_info)
-#if !defined(JCVM_ARRAY_SIZE_CHECK) && !defined(JCVM_DYNAMIC_CHECKS_CAP)
-    noexcept
-#endif
-{
-#ifdef JCVM_DYNAMIC_CHECKS_CAP
-
-  if (virtual_method_ref_info.isPublicMethod()) {
-    throw Exceptions::SecurityException;
+void Class_Handler::fillVTable(
+    std::vector<Package_Registry::VTableEntry> &vtable, const Package &package,
+    const uint8_t method_table_base,
+    const JCVMArray<const uint16_t> method_table) {
+  uint16_t vtable_size = method_table_base + method_table.size();
+
+  if (vtable.size() < vtable_size) {
+    vtable.resize(vtable_size);
   }
 
-#endif /* JCVM_DYNAMIC_CHECKS_CAP */
+  for (uint16_t index = 0; index < method_table.size(); ++index) {
+    uint16_t method_offset = method_table.at(index);
 
-  ConstantPool_Handler cp_handler(this->package);
-  uint8_t method_offset = virtual_method_ref_info.token;
-  auto token = cp_handler.classref2class(virtual_method_ref_info.class_ref);
-
-  // Where is the method offset located?
-  while (!(token.second->isObjectClass()) &&
-         (method_offset < token.second->public_method_table_base)) {
-    // Jump to superclass
-    cp_handler.setPackage(token.first);
-    token = cp_handler.classref2class(token.second->super_class_ref);
+    // 0xFFFF: the method is inherited from the superclass.
+    if (method_offset != (uint16_t)0xFFFF) {
+      Package_Registry::VTableEntry &entry = vtable[method_table_base + index];
+      entry.packageID = package.getPackageID();
+      entry.method = Method_Handler::getMethod(package, HTONS(method_offset));
+    }
   }
+}
 
-#ifdef JCVM_DYNAMIC_CHECKS_CAP
-
-  if (token.second->isObjectClass() &&
-      (method_offset < token.second->public_method_table_base)) {
+/**
+ * Get a flattened virtual method table entry from a method token.
+ *
+ * @param[vtable] flattened virtual method table.
+ * @param[method_token] method token to resolve.
+ *
+ * @return the package and the method (with its header) to call.
+ */
+std::pair<Package, const uint8_t *> Class_Handler::getVTableEntry(
+    const std::vector<Package_Registry::VTableEntry> &vtable,
+    const uint8_t method_token) {
+  if ((method_token >= vtable.size()) ||
+      (vtable[method_token].method == nullptr)) {
+    // No method defined in the class hierarchy for this token
     throw Exceptions::SecurityException;
   }
 
-#endif /* JCVM_DYNAMIC_CHECKS_CAP */
-
-  return this->doGetPublicMethodOffset(token.first, token.second,
-                                       method_offset);
+  const Package_Registry::VTableEntry &entry = vtable[method_token];
+  return std::make_pair(Package(entry.packageID), entry.method);
 }
 
 /**
- * Do get a class public method offset from a class' public method token.
+ * Get the flattened virtual method tables of a class. The tables are built
+ * on the first access from the superclass tables and the class public and
+ * package virtual method tables. The package table only holds the package
+ * methods of the class package: the package methods of a superclass in
+ * another package are found in the superclass package table.
  *
- * @param[package] where is located the method to resolve
- * @param[claz] a pointer to the class where is located the method to resolve
- * @param[public_method_token] public method token to resolve.
+ * @param[claz] package and class info of the class.
  *
- * @return the public virtual method offset in the Method component.
+ * @return the flattened virtual method tables of the class.
  */
-std::pair<Package, const uint16_t>
-Class_Handler::doGetPublicMethodOffset(Package &package,
-                                       const jc_cap_class_info *claz,
-                                       uint8_t public_method_offset)
-#if !defined(JCVM_ARRAY_SIZE_CHECK) && !defined(JCVM_DYNAMIC_CHECKS_CAP)
-    noexcept
-#endif
-{
-  ConstantPool_Handler cp_handler(this->package);
+Package_Registry::VTable &Class_Handler::getVTable(
+    const std::pair<Package, const jc_cap_class_info *> claz) {
+  Package_Registry::VTable &vtable =
+      Package_Registry::getVTable(claz.first.getPackageID(), claz.second);
 
-  uint16_t method_offset = 0xFFFF;
-  const JCVMArray<const uint16_t> public_virtual_method_table =
-      claz->public_virtual_method_table();
-  auto token = std::make_pair(package, claz);
+  if (vtable.isBuilt) {
+    return vtable;
+  }
 
-  do {
-    uint16_t offset = public_method_offset - claz->public_method_table_base;
-    method_offset = public_virtual_method_table.at(offset);
+  if (!claz.second->isObjectClass()) {
+    auto super_class = ConstantPool_Handler(claz.first)
+                           .classref2class(claz.second->super_class_ref);
+    const Package_Registry::VTable &super_vtable =
+        Class_Handler::getVTable(super_class);
 
-    if (method_offset == (uint16_t)0xFFFF) {
-#ifdef JCVM_DYNAMIC_CHECKS_CAP
+    vtable.public_methods = super_vtable.public_methods;
 
-      if (claz->isObjectClass()) {
-        // Behaviour not expected
-        throw Exceptions::SecurityException;
-      }
+    // Package method tokens are only inherited within a package: they are
+    // numbered from 0 again in a subclass of another package.
+    if (super_class.first.getPackageID() == claz.first.getPackageID()) {
+      vtable.package_methods = super_vtable.package_methods;
+    }
+  }
 
-#endif /* JCVM_DYNAMIC_CHECKS_CAP */
+  Class_Handler::fillVTable(vtable.public_methods, claz.first,
+                            claz.second->public_method_table_base,
+                            claz.second->public_virtual_method_table());
+  Class_Handler::fillVTable(vtable.package_methods, claz.first,
+                            claz.second->package_method_table_base,
+                            claz.second->package_virtual_method_table());
 
-      // Jump to superclass
-      cp_handler.setPackage(token.first);
-      token = cp_handler.classref2class(token.second->super_class_ref);
-    }
-  } while (method_offset == (uint16_t)0xFFFF);
+  vtable.isBuilt = true;
 
-  return std::make_pair(token.first, method_offset);
+  return vtable;
 }
 
 /**
- * Get a class package method offset from a class' package method token.
+ * Get a class public or package method from a class' method token.
  *
- * @param[package_method_token] package method token to resolve.
+ * @param[virtual_method_ref_info] class and method token to resolve.
  *
- * @return the package virtual method offset in the Method component. The Cap
- * field is updated to executed the method to call.
+ * @return the package and the method (with its header) to call.
  */
-std::pair<Package, const uint16_t> Class_Handler::getPackageMethodOffset(
-    const jc_cap_virtual_method_ref_info virtual_method_ref_info)
-#if !defined(JCVM_ARRAY_SIZE_CHECK) && !defined(JCVM_DYNAMIC_CHECKS_CAP)
-    noexcept
-#endif
-{
-#ifdef JCVM_DYNAMIC_CHECKS_CAP
-
-  if (!virtual_method_ref_info.isPublicMethod()) {
-    throw Exceptions::SecurityException;
-  }
-
-#endif /* JCVM_DYNAMIC_CHECKS_CAP */
-
+std::pair<Package, const uint8_t *> Class_Handler::getVirtualMethod(
+    const jc_cap_virtual_method_ref_info virtual_method_ref_info) {
   ConstantPool_Handler cp_handler(this->package);
-  uint8_t method_offset_class = virtual_method_ref_info.token;
-  auto token = cp_handler.classref2class(virtual_method_ref_info.class_ref);
+  const Package_Registry::VTable &vtable = Class_Handler::getVTable(
+      cp_handler.classref2class(virtual_method_ref_info.class_ref));
 
-  // Where is the method offset located?
-  while (!(token.second->isObjectClass()) &&
-         (method_offset_class < token.second->package_method_table_base)) {
-    // Jump to superclass
-    cp_handler.setPackage(token.first);
-    token = cp_handler.classref2class(token.second->super_class_ref);
+  if (virtual_method_ref_info.isPublicMethod()) {
+    return Class_Handler::getVTableEntry(vtable.public_methods,
+                                         virtual_method_ref_info.token);
+  } else { // it's a package method
+    return Class_Handler::getVTableEntry(
+        vtable.package_methods, virtual_method_ref_info.token & 0x7F);
   }
-
-  uint16_t method_offset = 0xFFFF;
-  const jc_cap_class_info *claz = token.second;
-  const JCVMArray<const uint16_t> package_virtual_method_table =
-      claz->package_virtual_method_table();
-
-  do {
-    uint16_t offset = method_offset_class - claz->package_method_table_base;
-    method_offset = package_virtual_method_table.at(offset);
-
-    if (method_offset == (uint16_t)0xFFFF) {
-#ifdef JCVM_DYNAMIC_CHECKS_CAP
-
-      if (claz->isObjectClass()) {
-        // Behavior not expected
-        throw Exceptions::SecurityException;
-      }
-
-#endif /* JCVM_DYNAMIC_CHECKS_CAP */
-
-      // Jump to superclass
-      cp_handler.setPackage(token.first);
-      token = cp_handler.classref2class(token.second->super_class_ref);
-    }
-  } while (method_offset == (uint16_t)0xFFFF);
-
-  return std::make_pair(token.first, method_offset);
 }
 
 /**
- * Get a class public or package method offset from a class' method token.
+ * Get the public or package method called by a method token on a receiver
+ * class. A public method token is resolved in the receiver class public
+ * table. A package method is only overridden in the package of the
+ * referenced class: its token is resolved in the package table of the
+ * receiver class, or of its first superclass, in this package.
  *
- * @param[method_token] method token to resolve.
+ * @param[receiver] package and class info of the receiver class.
+ * @param[virtual_method_ref_info] referenced class and method token.
  *
- * @return the public or package virtual method offset in the Method component.
+ * @return the package and the method (with its header) to call.
  */
-std::pair<Package, const uint16_t> Class_Handler::getMethodOffset(
-    const jc_cap_virtual_method_ref_info virtual_method_ref_info)
-#if !defined(JCVM_ARRAY_SIZE_CHECK) && !defined(JCVM_DYNAMIC_CHECKS_CAP)
-    noexcept
-#endif
-{
+std::pair<Package, const uint8_t *> Class_Handler::getVirtualMethod(
+    std::pair<Package, const jc_cap_class_info *> receiver,
+    const jc_cap_virtual_method_ref_info virtual_method_ref_info) {
   if (virtual_method_ref_info.isPublicMethod()) {
-    return this->getPublicMethodOffset(virtual_method_ref_info);
-  } else { // it's a package method
-    return this->getPackageMethodOffset(virtual_method_ref_info);
+    return Class_Handler::getVTableEntry(
+        Class_Handler::getVTable(receiver).public_methods,
+        virtual_method_ref_info.token);
+  }
+
+  const jpackage_ID_t packageID =
+      ConstantPool_Handler(this->package)
+          .classref2class(virtual_method_ref_info.class_ref)
+          .first.getPackageID();
+
+  while (receiver.first.getPackageID() != packageID) {
+    if (receiver.second->isObjectClass()) {
+      // The referenced class is not a superclass of the receiver class
+      throw Exceptions::SecurityException;
+    }
+
+    receiver = ConstantPool_Handler(receiver.first)
+                   .classref2class(receiver.second->super_class_ref);
   }
+
+  return Class_Handler::getVTableEntry(
+      Class_Handler::getVTable(receiver).package_methods,
+      virtual_method_ref_info.token & 0x7F);
 }
 
 /*
- * Get a class' implemented interface method offset from a class' package method
- * token.
+ * Get a class' implemented interface method from an interface method token.
+ * The interface method table of the class is built on the first access for
+ * each implemented interface (including superinterfaces, listed in the class
+ * implemented interfaces).
  *
- * @param[class] class where the method will be resolved.
- * @param[interface] implemented interface.
- * @param[implemented_interface_method_number] implemented interface method
- *                                              number.
- * @return the implemented interface method offset in the method component.
+ * @param[claz] package and class info of the class.
+ * @param[interface] package and interface info of the implemented interface.
+ * @param[interface_method_token] interface method token.
+ * @return the package and the implemented interface method (with its header)
+ * to call.
  */
-std::pair<Package, const uint16_t>
-Class_Handler::getImplementedInterfaceMethodOffset(
-    const jc_cap_class_ref class_ref, const jc_cap_class_ref interface,
-    const uint8_t implemented_interface_method_number, const bool isArray)
-#if !defined(JCVM_ARRAY_SIZE_CHECK) && !defined(JCVM_DYNAMIC_CHECKS_CAP)
-    noexcept
-#endif
-{
-  ConstantPool_Handler cp_handler(this->package);
-  auto claz = (isArray ? this->getObjectClassFromAnObjectRef(class_ref)
-                       : cp_handler.classref2class(class_ref));
+std::pair<Package, const uint8_t *> Class_Handler::getInterfaceMethod(
+    const std::pair<Package, const jc_cap_class_info *> claz,
+    const std::pair<Package, const uint8_t *> interface,
+    const uint8_t interface_method_token) {
+  Package_Registry::VTable &vtable = Class_Handler::getVTable(claz);
+
+  for (const auto &itable : vtable.itables) {
+    if (itable.interface == interface.second) {
+      return Class_Handler::getVTableEntry(itable.methods,
+                                           interface_method_token);
+    }
+  }
+
+  ConstantPool_Handler cp_handler(claz.first);
 
   for (uint16_t index = 0; index < claz.second->interface_count; ++index) {
-    const auto &interfaces = claz.second->interfaces(index);
+    const auto &implemented_interface = claz.second->interfaces(index);
+
+    if (cp_handler.resolveClassref(implemented_interface.interface).second !=
+        interface.second) {
+      continue;
+    }
 
-    if (HTONS(interfaces.interface.internal_classref) ==
-        interface.internal_classref) {
+    Package_Registry::ITable itable;
+    itable.interface = interface.second;
 
-      uint8_t public_method_offset =
-          interfaces.indexes().at(implemented_interface_method_number);
+    const JCVMArray<const uint8_t> indexes = implemented_interface.indexes();
 
-      if (isArray) {
-        return this->doGetPublicMethodOffset(claz.first, claz.second,
-                                             public_method_offset);
-      } else {
-        const jc_cap_virtual_method_ref_info method_ref = {
-            .class_ref = class_ref,
-            .token = public_method_offset,
-        };
+    for (uint16_t method = 0; method < indexes.size(); ++method) {
+      uint8_t public_method_token = indexes.at(method);
 
-        return this->getPublicMethodOffset(method_ref);
+      if (public_method_token >= vtable.public_methods.size()) {
+        throw Exceptions::SecurityException;
       }
+
+      itable.methods.push_back(vtable.public_methods[public_method_token]);
     }
+
+    vtable.itables.push_back(std::move(itable));
+
+    return Class_Handler::getVTableEntry(vtable.itables.back().methods,
+                                         interface_method_token);
   }
 
+  // The interface is not implemented by the class
   throw Exceptions::SecurityException;
 }
 
 /*
- * Get the instance field size for an instantiated class.
+ * Get the instance field size for an instantiated class. The size is
+ * computed once per class and kept in the class instance layout.
  *
  * @param[claz_index] class index used to compute the instance field size
  */
 const uint16_t
-Class_Handler::getInstanceFieldsSize(const jclass_index_t claz_index) const
-#if !defined(JCVM_ARRAY_SIZE_CHECK) && !defined(JCVM_DYNAMIC_CHECKS_CAP)
-    noexcept
-#endif
-{
+Class_Handler::getInstanceFieldsSize(const jclass_index_t claz_index) const {
   auto package = this->package;
   auto claz = ConstantPool_Handler(package).getClassFromClassIndex(claz_index);
 
+  Package_Registry::ClassLayout &layout =
+      Package_Registry::getClassLayout(package.getPackageID(), claz);
+
+  if (layout.isBuilt) {
+    return layout.nb_fields;
+  }
+
   uint16_t instance_size = 0;
 
   do {
@@ -460,6 +496,9 @@ Class_Handler::getInstanceFieldsSize(const jclass_index_t claz_index) const
     claz = pair.second;
   } while (!(claz->isObjectClass()));
 
+  layout.nb_fields = instance_size;
+  layout.isBuilt = true;
+
   return instance_size;
 }
 
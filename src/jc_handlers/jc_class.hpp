@@ -34,50 +34,29 @@
 #include "../jc_utils.hpp"
 #include "../types.hpp"
 #include "jc_component.hpp"
+#include "package_registry.hpp"
 
 #include <utility>
+#include <vector>
 
 namespace jcvm {
 
 class Class_Handler : public Component_Handler {
 private:
-  /// Get a class package method offset from a class' package method token.
-  std::pair<Package, const uint16_t> getPublicMethodOffset(
-      const jc_cap_virtual_method_ref_info virtual_method_ref_info)
-#if !defined(JCVM_ARRAY_SIZE_CHECK) && !defined(JCVM_DYNAMIC_CHECKS_CAP)
-      noexcept
-#endif
-      ;
+  /// Overlay a class method table on a flattened virtual method table.
+  static void
+  fillVTable(std::vector<Package_Registry::VTableEntry> &vtable,
+             const Package &package, const uint8_t method_table_base,
+             const JCVMArray<const uint16_t> method_table);
 
-  /// Do get a class public method offset from a class' public method token.
-  std::pair<Package, const uint16_t>
-  doGetPublicMethodOffset(Package &package, const jc_cap_class_info *claz,
-                          uint8_t public_method_offset)
-#if !defined(JCVM_ARRAY_SIZE_CHECK) && !defined(JCVM_DYNAMIC_CHECKS_CAP)
-      noexcept
-#endif
-      ;
+  /// Get a flattened virtual method table entry from a method token.
+  static std::pair<Package, const uint8_t *>
+  getVTableEntry(const std::vector<Package_Registry::VTableEntry> &vtable,
+                 const uint8_t method_token);
 
-  /// Get a class package method offset from a class' package method token.
-  std::pair<Package, const uint16_t> getPackageMethodOffset(
-      const jc_cap_virtual_method_ref_info virtual_method_ref_info)
-#if !defined(JCVM_ARRAY_SIZE_CHECK) && !defined(JCVM_DYNAMIC_CHECKS_CAP)
-      noexcept
-#endif
-      ;
-
-  /**
-   * Check if two interfaces (interface_in and interface_out) have a hierarchy
-   * link together. This function returns TRUE when interface_in is the
-   * daughter of interface_out.
-   */
-  static jbool_t
-  checkInterfaceCast(const std::pair<Package, const uint8_t *> interface_in,
-                     const std::pair<Package, const uint8_t *> interface_out)
-#if !defined(JCVM_ARRAY_SIZE_CHECK) && !defined(JCVM_DYNAMIC_CHECKS_CAP)
-      noexcept
-#endif
-      ;
+  /// Add the interfaces of a class hierarchy index to another one.
+  static void addInterfaces(Package_Registry::TypeInfo &type,
+                            const Package_Registry::TypeInfo &interfaces);
 
 public:
   Class_Handler(Package package) : Component_Handler(package){};
@@ -91,6 +70,10 @@ public:
 #endif
       ;
 
+  /// Get the class hierarchy index of a class or an interface.
+  static const Package_Registry::TypeInfo &
+  getTypeInfo(const std::pair<Package, const uint8_t *> jtype);
+
   /// Get the reference to the Object class from an objectref.
   std::pair<Package, const jc_cap_class_info *>
   getObjectClassFromAnObjectRef(const jc_cap_class_ref classref)
@@ -99,31 +82,28 @@ public:
 #endif
       ;
 
-  /// Get public or package method offset  from a class' package method token.
-  std::pair<Package, const uint16_t>
-  getMethodOffset(const jc_cap_virtual_method_ref_info virtual_method_ref_info)
-#if !defined(JCVM_ARRAY_SIZE_CHECK) && !defined(JCVM_DYNAMIC_CHECKS_CAP)
-      noexcept
-#endif
-      ;
+  /// Get the flattened virtual method tables of a class.
+  static Package_Registry::VTable &
+  getVTable(const std::pair<Package, const jc_cap_class_info *> claz);
 
-  /// Get a class' implemented interface method offset from a class' package
-  /// method token.
-  std::pair<Package, const uint16_t> getImplementedInterfaceMethodOffset(
-      const jc_cap_class_ref class_ref, const jc_cap_class_ref interface,
-      const uint8_t implemented_interface_method_number,
-      const bool isArray = false)
-#if !defined(JCVM_ARRAY_SIZE_CHECK) && !defined(JCVM_DYNAMIC_CHECKS_CAP)
-      noexcept
-#endif
-      ;
+  /// Get public or package method from a class' method token.
+  std::pair<Package, const uint8_t *> getVirtualMethod(
+      const jc_cap_virtual_method_ref_info virtual_method_ref_info);
+
+  /// Get the public or package method called on a receiver class.
+  std::pair<Package, const uint8_t *> getVirtualMethod(
+      std::pair<Package, const jc_cap_class_info *> receiver,
+      const jc_cap_virtual_method_ref_info virtual_method_ref_info);
+
+  /// Get a class' implemented interface method from an interface method
+  /// token.
+  static std::pair<Package, const uint8_t *>
+  getInterfaceMethod(const std::pair<Package, const jc_cap_class_info *> claz,
+                     const std::pair<Package, const uint8_t *> interface,
+                     const uint8_t interface_method_token);
 
   /// Get the instance field size for an instantiated class.
-  const uint16_t getInstanceFieldsSize(const jclass_index_t claz_index) const
-#if !defined(JCVM_ARRAY_SIZE_CHECK) && !defined(JCVM_DYNAMIC_CHECKS_CAP)
-      noexcept
-#endif
-      ;
+  const uint16_t getInstanceFieldsSize(const jclass_index_t claz_index) const;
 };
 
 } // namespace jcvm
@@ -29,6 +29,7 @@
 #include "jc_class.hpp"
 #include "jc_export.hpp"
 #include "jc_import.hpp"
+#include "jc_method.hpp"
 
 namespace jcvm {
 
@@ -49,20 +50,23 @@ ConstantPool_Handler::getCPEntry(const jc_cp_offset_t offset)
 }
 
 /*
- * Get Class Information (Package & Class indexes) from current constant pool
- * offset.
+ * Resolve a constant pool classref entry. The entry is resolved on the first
+ * access only, then read from the package resolved constant pool.
  *
  * @param[offset] Current constant pool offset
  *
- * @return Class Information (Package & Class indexes) from current constant
- * pool offset.
+ * @return the resolved constant pool entry.
  */
-std::pair<jpackage_ID_t, jclass_index_t>
-ConstantPool_Handler::getClassInformation(const jc_cp_offset_t offset)
-#ifndef JCVM_ARRAY_SIZE_CHECK
-    noexcept
-#endif /* JCVM_ARRAY_SIZE_CHECK */
-{
+const Package_Registry::ResolvedCPEntry &
+ConstantPool_Handler::getResolvedClass(const jc_cp_offset_t offset) {
+  Package_Registry::ResolvedCPEntry &resolved =
+      Package_Registry::getResolvedCPEntry(this->package.getPackageID(),
+                                           offset);
+
+  if (resolved.tag == JC_CP_TAG_CONSTANT_CLASSREF) {
+    return resolved;
+  }
+
   jpackage_ID_t package;
   jclass_index_t claz;
 
@@ -92,7 +96,143 @@ ConstantPool_Handler::getClassInformation(const jc_cp_offset_t offset)
     claz = classref.internal_classref;
   }
 
-  return std::make_pair(package, HTONS(claz));
+  resolved.packageID = package;
+  resolved.offset = HTONS(claz);
+  resolved.target = this->resolveClassref(classref).second;
+  resolved.tag = JC_CP_TAG_CONSTANT_CLASSREF;
+
+  return resolved;
+}
+
+/*
+ * Get Class Information (Package & Class indexes) from current constant pool
+ * offset.
+ *
+ * @param[offset] Current constant pool offset
+ *
+ * @return Class Information (Package & Class indexes) from current constant
+ * pool offset.
+ */
+std::pair<jpackage_ID_t, jclass_index_t>
+ConstantPool_Handler::getClassInformation(const jc_cp_offset_t offset) {
+  auto &resolved = this->getResolvedClass(offset);
+  return std::make_pair(resolved.packageID, resolved.offset);
+}
+
+/*
+ * Get the class or interface referenced by a constant pool classref entry.
+ *
+ * @param[offset] Current constant pool offset
+ *
+ * @return the package and the struct jc_cap_class or struct jc_cap_interface
+ * structure where the class is defined.
+ */
+std::pair<Package, const uint8_t *>
+ConstantPool_Handler::getResolvedClassref(const jc_cp_offset_t offset) {
+  auto &resolved = this->getResolvedClass(offset);
+  return std::make_pair(Package(resolved.packageID), resolved.target);
+}
+
+/*
+ * Get the static method referenced by a constant pool entry. The entry is
+ * resolved on the first access only.
+ *
+ * @param[offset] Current constant pool offset
+ *
+ * @return the package and the method (with its header) to call.
+ */
+std::pair<Package, const uint8_t *>
+ConstantPool_Handler::getResolvedStaticMethod(const jc_cp_offset_t offset) {
+  Package_Registry::ResolvedCPEntry &resolved =
+      Package_Registry::getResolvedCPEntry(this->package.getPackageID(),
+                                           offset);
+
+  if (resolved.tag != JC_CP_TAG_CONSTANT_STATICMETHODREF) {
+    const jc_cap_constant_pool_info cp_entry = this->getCPEntry(offset);
+
+    if (cp_entry.tag != JC_CP_TAG_CONSTANT_STATICMETHODREF) {
+      throw Exceptions::SecurityException;
+    }
+
+    const jc_cap_static_method_ref_info method_ref =
+        cp_entry.info.static_method_ref_info;
+
+    jpackage_ID_t packageID;
+    uint16_t method_offset;
+
+    if (IS_CP_INTERNAL_REF(method_ref.static_method_ref)) {
+      packageID = this->package.getPackageID();
+      method_offset = method_ref.static_method_ref.internal_ref.offset
+                      // remove handler_count element's size
+                      - sizeof(jc_cap_method_component::handler_count);
+    } else { // Is external static method ref
+      Import_Handler imported(this->package);
+      packageID = imported.getPackageIndexFromOffset(
+          method_ref.static_method_ref.external_ref.package_token);
+
+      Package exported_package(packageID);
+      Export_Handler export_handler(exported_package);
+      method_offset = export_handler.getExportedStaticMethodOffset(
+          method_ref.static_method_ref.external_ref.class_token,
+          method_ref.static_method_ref.external_ref.token);
+    }
+
+    resolved.packageID = packageID;
+    resolved.offset = method_offset;
+    resolved.target =
+        Method_Handler::getMethod(Package(packageID), method_offset);
+    resolved.tag = JC_CP_TAG_CONSTANT_STATICMETHODREF;
+  }
+
+  return std::make_pair(Package(resolved.packageID), resolved.target);
+}
+
+/*
+ * Get the static field referenced by a constant pool entry. The entry is
+ * resolved on the first access only.
+ *
+ * @param[offset] Current constant pool offset
+ *
+ * @return the package ID and the static field number in this package.
+ */
+std::pair<jpackage_ID_t, uint8_t>
+ConstantPool_Handler::getResolvedStaticField(const jc_cp_offset_t offset) {
+  Package_Registry::ResolvedCPEntry &resolved =
+      Package_Registry::getResolvedCPEntry(this->package.getPackageID(),
+                                           offset);
+
+  if (resolved.tag != JC_CP_TAG_CONSTANT_STATICFIELDREF) {
+    const jc_cap_static_field_ref_info field_ref =
+        this->getStaticFieldRefInfo(offset);
+
+    jpackage_ID_t packageID;
+    uint8_t fieldNumber;
+
+    if (IS_CP_INTERNAL_REF(field_ref.static_field_ref)) {
+      packageID = this->package.getPackageID();
+      fieldNumber = NTOHS(field_ref.static_field_ref.internal_ref.offset);
+    } else {
+      jc_cap_external_ref external_ref =
+          field_ref.static_field_ref.external_ref;
+
+      /// Package number from the link table.
+      Import_Handler imp(this->package);
+      packageID = imp.getPackageIndexFromOffset(external_ref.package_token);
+
+      /// Looking for the static field nomber in the package.
+      Package exported_package(packageID);
+      Export_Handler export_handler(exported_package);
+      fieldNumber = export_handler.getExportedStaticFieldOffset(
+          external_ref.class_token, external_ref.token);
+    }
+
+    resolved.packageID = packageID;
+    resolved.offset = fieldNumber;
+    resolved.target = nullptr;
+    resolved.tag = JC_CP_TAG_CONSTANT_STATICFIELDREF;
+  }
+
+  return std::make_pair(resolved.packageID, (uint8_t)resolved.offset);
 }
 
 /*
@@ -333,8 +473,8 @@ ConstantPool_Handler::resolveClassref(const jc_cap_class_ref classref)
     noexcept
 #endif
 {
-  Package &package = this->package;
-  auto cap = this->package.getCap();
+  Package package = this->package;
+  const JC_Cap *cap = &(this->package.getCap());
 
   uint16_t class_token;
   const uint8_t *classFound = nullptr;
@@ -343,22 +483,18 @@ ConstantPool_Handler::resolveClassref(const jc_cap_class_ref classref)
   if (classref.isExternalClassRef()) {
     Import_Handler import_handler(package);
 
-    //  High byte is set to one => clear it
-    const uint8_t imported_package_token =
-        classref.external_classref.package_token & 0x7F;
-    auto imported_package_ID =
-        import_handler.getPackageAID(imported_package_token);
-    auto package_index = import_handler.getPackageIndex(imported_package_ID);
+    auto package_index = import_handler.getPackageIndexFromOffset(
+        classref.external_classref.package_token);
 
     package = Package(package_index);
-    cap = package.getCap();
+    cap = &(package.getCap());
 
     class_token = BYTE_TO_SHORT(classref.external_classref.class_token);
   } else { // is internal class_ref
     class_token = HTONS(classref.internal_classref);
   }
 
-  classFound = &(cap.getClass()->claz()[class_token]);
+  classFound = &(cap->getClass()->claz()[class_token]);
 
 #ifdef JCVM_DYNAMIC_CHECKS_CAP
 
@@ -371,7 +507,7 @@ ConstantPool_Handler::resolveClassref(const jc_cap_class_ref classref)
         (((struct jc_cap_interface_info *)classFound)->interface_count);
   }
 
-  if ((class_token + classref_length) > HTONS(cap.getClass()->size)) {
+  if ((class_token + classref_length) > HTONS(cap->getClass()->size)) {
     throw Exceptions::SecurityException;
   }
 
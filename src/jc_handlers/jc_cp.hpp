@@ -36,22 +36,39 @@
 #include "../types.hpp"
 #include "jc_component.hpp"
 #include "package.hpp"
+#include "package_registry.hpp"
 
 #include <utility>
 
 namespace jcvm {
 
 class ConstantPool_Handler : public Component_Handler {
+private:
+  /// Resolve a constant pool classref entry through the resolved constant
+  /// pool.
+  const Package_Registry::ResolvedCPEntry &
+  getResolvedClass(const jc_cp_offset_t offset);
+
 public:
   /// Default constructor
   ConstantPool_Handler(Package package) noexcept : Component_Handler(package){};
 
+  /// Get Class Information (Package & Class indexes) from a constant pool
+  /// classref entry.
   std::pair<jpackage_ID_t, jclass_index_t>
-  getClassInformation(const jc_cp_offset_t instantiated_class)
-#ifndef JCVM_ARRAY_SIZE_CHECK
-      noexcept
-#endif /* JCVM_ARRAY_SIZE_CHECK */
-      ;
+  getClassInformation(const jc_cp_offset_t instantiated_class);
+
+  /// Get the class or interface referenced by a constant pool classref entry.
+  std::pair<Package, const uint8_t *>
+  getResolvedClassref(const jc_cp_offset_t offset);
+
+  /// Get the static method referenced by a constant pool entry.
+  std::pair<Package, const uint8_t *>
+  getResolvedStaticMethod(const jc_cp_offset_t offset);
+
+  /// Get the static field referenced by a constant pool entry.
+  std::pair<jpackage_ID_t, uint8_t>
+  getResolvedStaticField(const jc_cp_offset_t offset);
 
   ///  Get a cp_entry
   const jc_cap_constant_pool_info getCPEntry(const jc_cp_offset_t offset)
@@ -26,6 +26,7 @@
 */
 
 #include "jc_export.hpp"
+#include "package_registry.hpp"
 
 namespace jcvm {
 
@@ -42,18 +43,8 @@ Export_Handler::getExportedClass(const uint16_t class_export_offset) const
     noexcept
 #endif
 {
-  const JC_Cap &cap = this->package.getCap();
-  const jc_cap_export_component *export_component = cap.getExport();
-
-#ifdef JCVM_DYNAMIC_CHECKS_CAP
-
-  if (export_component == nullptr) { // No export component found!
-    throw Exceptions::SecurityException;
-  }
-
-#endif /* JCVM_DYNAMIC_CHECKS_CAP */
-
-  return export_component->classexport(class_export_offset);
+  return Package_Registry::getExportedClass(this->package.getPackageID(),
+                                            class_export_offset);
 }
 
 /*
@@ -69,14 +60,16 @@ Export_Handler::getExportedClassOffset(const uint16_t class_export_offset) const
     noexcept
 #endif
 {
-  auto class_import_info = this->getExportedClass(class_export_offset);
+  const jc_cap_class_export_info &class_export_info =
+      this->getExportedClass(class_export_offset);
 
-  return static_cast<jclass_index_t>(class_import_info.class_offset);
+  return static_cast<jclass_index_t>(class_export_info.class_offset);
 }
 
 /**
  * Get static method offset in the method component from static method offset
- * in the Export component.
+ * in the Export component. The offset is decoded once, when the package is
+ * resolved.
  *
  * @param[class_export_offset] exported class offset to resolve.
  * @param[static_method_offset] static method offset.
@@ -89,18 +82,14 @@ uint16_t Export_Handler::getExportedStaticMethodOffset(
     noexcept
 #endif
 {
-  const jc_cap_class_export_info &exported_class =
-      this->getExportedClass(class_export_offset);
-
-  const JCVMArray<const uint16_t> method_offsets =
-      exported_class.static_method_offsets();
-
-  return HTONS(method_offsets.at(static_method_offset));
+  return Package_Registry::getExportedStaticMethodOffset(
+      this->package.getPackageID(), class_export_offset, static_method_offset);
 }
 
 /**
  * Get static field offset in the Static field component from static method
- * offset in the Export component.
+ * offset in the Export component. The offset is decoded once, when the
+ * package is resolved.
  *
  * @param[class_export_offset] exported class offset to resolve.
  * @param[static_field_offset] static method offset.
@@ -112,13 +101,8 @@ uint16_t Export_Handler::getExportedStaticFieldOffset(
     noexcept
 #endif
 {
-  const jc_cap_class_export_info &exported_class =
-      this->getExportedClass(class_export_offset);
-
-  const JCVMArray<const uint16_t> field_offsets =
-      exported_class.static_field_offsets();
-
-  return HTONS(field_offsets.at(static_field_offset));
+  return Package_Registry::getExportedStaticFieldOffset(
+      this->package.getPackageID(), class_export_offset, static_field_offset);
 }
 
 } // namespace jcvm
@@ -28,7 +28,7 @@
 #include "jc_import.hpp"
 #include "../debug.hpp"
 #include "../jc_cap/jc_cap_import.hpp"
-#include "flashmemory.hpp"
+#include "package_registry.hpp"
 
 namespace jcvm {
 
@@ -78,34 +78,26 @@ const jc_cap_package_info *Import_Handler::getPackageAID(const uint8_t index)
  */
 const jpackage_ID_t
 Import_Handler::getPackageIndex(const jc_cap_package_info *pinfo) {
-  for (jpackage_ID_t index = 0; index < JCVM_MAX_PACKAGES; index++) {
-    if (!FlashMemory_Handler::isPackageExist(index)) {
-      continue;
-    }
+  jpackage_ID_t index = Package_Registry::findPackage(*pinfo);
 
-    Package package = Package(index);
-    JC_Cap cap = package.getCap();
-
-    const jc_cap_package_info &pinfo_to_compare = cap.getHeader()->package;
-
-    if (*pinfo == pinfo_to_compare) {
-      return index;
-    }
+  if (index == PACKAGE_REGISTRY_UNLINKED) {
+    throw Exceptions::RuntimeException;
   }
 
-  throw Exceptions::RuntimeException;
+  return index;
 }
 
 /*
- * Get the package index in the flash from import component offset.
+ * Get the package index in the flash from import component offset. The
+ * import component is linked once by the package registry.
  *
  * @param[offset] Offset of the package information in the current import
- * component
+ * component. The high bit of an external package token is ignored.
  */
 const jpackage_ID_t
 Import_Handler::getPackageIndexFromOffset(const uint8_t offset) {
-  auto aid = this->getPackageAID(offset);
-  return this->getPackageIndex(aid);
+  return Package_Registry::getImportedPackageID(this->package.getPackageID(),
+                                                CLEAR_BYTE_MSB(offset));
 }
 
 } // namespace jcvm
@@ -44,7 +44,25 @@ const uint8_t *Method_Handler::getMethodFromOffset(const uint16_t method_offset)
     noexcept
 #endif
 {
-  auto cap = this->package.getCap();
+  return Method_Handler::getMethod(this->package, method_offset);
+}
+
+/**
+ * Get method from offset in a package method component.
+ *
+ * @param[package] package where the method is located.
+ * @param[method_offset] method offset to resolve.
+ *
+ * @return method from method_offset with the type struct jc_cap_method_info or
+ * struct jc_cap_extended_method_info
+ */
+const uint8_t *Method_Handler::getMethod(const Package &package,
+                                         const uint16_t method_offset)
+#if !defined(JCVM_ARRAY_SIZE_CHECK) && !defined(JCVM_DYNAMIC_CHECKS_CAP)
+    noexcept
+#endif
+{
+  const JC_Cap &cap = package.getCap();
 
 #ifdef JCVM_DYNAMIC_CHECKS_CAP
 
@@ -60,6 +78,23 @@ const uint8_t *Method_Handler::getMethodFromOffset(const uint16_t method_offset)
   return &(methods.at(method_offset - 1));
 }
 
+/**
+ * Get the arguments words of a method.
+ *
+ * @param[method] pointer to the method header.
+ *
+ * @return the method arguments words, including the this reference.
+ */
+uint8_t Method_Handler::getMethodNargs(const uint8_t *const method) noexcept {
+  if (IS_EXTENDED_METHOD(method)) {
+    return reinterpret_cast<const jc_cap_extended_method_info *>(method)
+        ->method_header.nargs;
+  }
+
+  return LOW_NIBBLE(reinterpret_cast<const jc_cap_method_info *>(method)
+                        ->method_header.nargs);
+}
+
 /**
  * Calling a method.
  *
@@ -109,12 +144,9 @@ void Method_Handler::callMethod(const uint8_t *const method_to_call,
 
 #endif /* JCVM_FIREWALL_CHECKS */
 
-  // pushing the new frame
-  this->context.getStack().push_Frame(nargs, max_locals, max_stack, new_pc);
-
-  //  and updating executed package ID.
-
-  this->context.changePackageID(this->package.getPackageID());
+  // pushing the new frame with the executed package ID.
+  this->context.getStack().push_Frame(nargs, max_locals, max_stack, new_pc,
+                                      this->package.getPackageID());
 
   return;
 }
@@ -131,6 +163,17 @@ void Method_Handler::callVirtualMethod(const uint16_t method_offset) {
   return;
 }
 
+/**
+ * Call an already resolved virtual method
+ *
+ * @param[method_to_call] pointer to the method header in the method component
+ *                        of the handler package.
+ */
+void Method_Handler::callVirtualMethod(const uint8_t *const method_to_call) {
+  this->callMethod(method_to_call);
+  return;
+}
+
 /**
  * Call a static method
  *
@@ -143,4 +186,15 @@ void Method_Handler::callStaticMethod(const uint16_t method_offset) {
   return;
 }
 
+/**
+ * Call an already resolved static method
+ *
+ * @param[method_to_call] pointer to the method header in the method component
+ *                        of the handler package.
+ */
+void Method_Handler::callStaticMethod(const uint8_t *const method_to_call) {
+  this->callMethod(method_to_call, TRUE);
+  return;
+}
+
 } // namespace jcvm
@@ -41,13 +41,6 @@ class Method_Handler : public Component_Handler {
 private:
   Context &context;
 
-  /// Get method from offset.
-  const uint8_t *getMethodFromOffset(const uint16_t method_offset)
-#if !defined(JCVM_ARRAY_SIZE_CHECK) && !defined(JCVM_DYNAMIC_CHECKS_CAP)
-      noexcept
-#endif
-      ;
-
   void callMethod(const uint8_t *const method_to_call,
                   const jbool_t isStaticMethod = FALSE)
 #if !defined(JCVM_DYNAMIC_CHECKS_CAP) && !defined(JCVM_FIREWALL_CHECKS)
@@ -60,11 +53,35 @@ public:
   Method_Handler(Context &context) noexcept
       : Component_Handler(context.getCurrentPackage()), context(context){};
 
+  /// Get method from offset.
+  const uint8_t *getMethodFromOffset(const uint16_t method_offset)
+#if !defined(JCVM_ARRAY_SIZE_CHECK) && !defined(JCVM_DYNAMIC_CHECKS_CAP)
+      noexcept
+#endif
+      ;
+
+  /// Get method from offset in a package method component.
+  static const uint8_t *getMethod(const Package &package,
+                                  const uint16_t method_offset)
+#if !defined(JCVM_ARRAY_SIZE_CHECK) && !defined(JCVM_DYNAMIC_CHECKS_CAP)
+      noexcept
+#endif
+      ;
+
+  /// Get the arguments words of a method
+  static uint8_t getMethodNargs(const uint8_t *const method) noexcept;
+
   /// Call a virtual method
   void callVirtualMethod(const uint16_t method_offset);
 
+  /// Call an already resolved virtual method
+  void callVirtualMethod(const uint8_t *const method_to_call);
+
   /// Call a static method
   void callStaticMethod(const uint16_t method_offset);
+
+  /// Call an already resolved static method
+  void callStaticMethod(const uint8_t *const method_to_call);
 };
 
 } // namespace jcvm
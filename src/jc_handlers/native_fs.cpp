@@ -0,0 +1,814 @@
+/*
+** The MIT License (MIT)
+**
+** Copyright (c) 2020, National Cybersecurity Agency of France (ANSSI)
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+** Author:
+**   - Guillaume Bouffard <guillaume.bouffard@ssi.gouv.fr>
+*/
+
+
+#ifdef PC_VERSION
+
+#include "native_fs.hpp"
+#include "../debug.hpp"
+#include "ffi.h"
+
+#ifndef JCVM_NATIVE_FS
+#include "../jc_types/jc_field.hpp"
+#include "../jc_utils.hpp"
+#include "flashmemory.hpp"
+#endif /* !JCVM_NATIVE_FS */
+
+#include <algorithm>
+#include <cstring>
+
+/// Flash memory log header
+#define NATIVE_FS_MAGIC "JCFS"
+#define NATIVE_FS_MAGIC_LENGTH (uint32_t)4 // bytes
+
+/// Tag kinds, first byte of the tags built by the path_* functions
+#define NATIVE_FS_TAG_PACKAGE_LIST (uint8_t)0x01
+#define NATIVE_FS_TAG_CAP (uint8_t)0x02
+#define NATIVE_FS_TAG_STATIC (uint8_t)0x03
+#define NATIVE_FS_TAG_APPLET_FIELD (uint8_t)0x04
+
+/// Fields probed when an instance is imported (field tokens are 1-byte)
+#define NATIVE_FS_IMPORTED_FIELDS (uint16_t)256
+
+namespace jcvm {
+
+uint8_t Native_FS::memory[JCVM_NATIVE_FS_SIZE] = {0};
+uint32_t *Native_FS::length = nullptr;
+std::unordered_map<fs::Tag, Native_FS::Record, fs::TagHash> Native_FS::index;
+bool Native_FS::isLoaded = false;
+bool Native_FS::isCompacting = false;
+uint32_t Native_FS::compaction_read = 0;
+uint32_t Native_FS::compaction_write = 0;
+Native_FS::Stats Native_FS::stats;
+
+/**
+ * Get the record length of a tag data: the tag length, the tag, the data
+ * length and the data.
+ *
+ * @param[tag_length] tag length.
+ * @param[data_length] data length.
+ *
+ * @return the record length.
+ */
+uint32_t Native_FS::recordLength(const uint8_t tag_length,
+                                 const uint32_t data_length) noexcept {
+  return sizeof(uint8_t) + tag_length + sizeof(uint32_t) + data_length;
+}
+
+/**
+ * Read the tag and the data length of a record. A filler record has an
+ * empty tag.
+ *
+ * @param[offset] record offset.
+ * @param[tag] the record tag.
+ *
+ * @return the record data length.
+ */
+uint32_t Native_FS::readRecord(const uint32_t offset, fs::Tag &tag) noexcept {
+  uint32_t data_length = 0;
+
+  tag.len = Native_FS::memory[offset];
+  std::memcpy(tag.value, Native_FS::memory + offset + sizeof(uint8_t),
+              tag.len);
+  tag.rehash();
+  std::memcpy(&data_length,
+              Native_FS::memory + offset + sizeof(uint8_t) + tag.len,
+              sizeof(uint32_t));
+
+  return data_length;
+}
+
+/**
+ * Index a record as the last record of its tag. The previous record of the
+ * tag becomes dead.
+ *
+ * @param[tag] record tag.
+ * @param[record] record to index.
+ */
+void Native_FS::indexRecord(const fs::Tag &tag, const Record &record) {
+  auto [entry, isInserted] = Native_FS::index.try_emplace(tag, record);
+
+  if (!isInserted) {
+    const uint32_t dead_length =
+        Native_FS::recordLength(tag.len, entry->second.length);
+
+    Native_FS::stats.live_bytes -= dead_length;
+    Native_FS::stats.dead_bytes += dead_length;
+    entry->second = record;
+  }
+
+  Native_FS::stats.live_bytes += Native_FS::recordLength(tag.len,
+                                                         record.length);
+}
+
+/**
+ * Cover free space of the log with a filler record, skipped when the log is
+ * scanned.
+ *
+ * @param[offset] free space offset.
+ * @param[filler_length] free space length, at least an empty record length.
+ */
+void Native_FS::writeFiller(const uint32_t offset,
+                           const uint32_t filler_length) noexcept {
+  const uint32_t data_length = filler_length - Native_FS::recordLength(0, 0);
+
+  Native_FS::memory[offset] = 0;
+  std::memcpy(Native_FS::memory + offset + sizeof(uint8_t), &data_length,
+              sizeof(uint32_t));
+}
+
+/**
+ * Get the flash memory.
+ *
+ * @return the flash memory.
+ */
+uint8_t *Native_FS::getMemory() noexcept { return Native_FS::memory; }
+
+/**
+ * Scan the log to index the last record of each tag. An empty flash memory
+ * is formatted, and a truncated last record is dropped.
+ *
+ * @param[used_length] used flash memory length, updated by the next writes
+ * and compactions.
+ *
+ * @return true if the flash memory holds a log.
+ */
+bool Native_FS::load(uint32_t &used_length) {
+  if (Native_FS::isLoaded) {
+    return true;
+  }
+
+  if (used_length == 0) {
+    std::memcpy(Native_FS::memory, NATIVE_FS_MAGIC, NATIVE_FS_MAGIC_LENGTH);
+    used_length = NATIVE_FS_MAGIC_LENGTH;
+  }
+
+  if ((used_length < NATIVE_FS_MAGIC_LENGTH) ||
+      (used_length > JCVM_NATIVE_FS_SIZE) ||
+      (std::memcmp(Native_FS::memory, NATIVE_FS_MAGIC,
+                   NATIVE_FS_MAGIC_LENGTH) != 0)) {
+    TRACE_JCVM_ERR("The flash memory is not a native file system log");
+    return false;
+  }
+
+  uint32_t offset = NATIVE_FS_MAGIC_LENGTH;
+
+  while (offset < used_length) {
+    fs::Tag tag;
+    const uint8_t tag_length = Native_FS::memory[offset];
+
+    if ((tag_length > TAG_MAX_LENGTH) ||
+        ((used_length - offset) < Native_FS::recordLength(tag_length, 0))) {
+      break;
+    }
+
+    const uint32_t data_length = Native_FS::readRecord(offset, tag);
+
+    if ((used_length - offset - Native_FS::recordLength(tag.len, 0)) <
+        data_length) {
+      break;
+    }
+
+    if (tag.len == 0) {
+      // Free space left by an interrupted compaction.
+      Native_FS::stats.dead_bytes += Native_FS::recordLength(0, data_length);
+    } else {
+      Native_FS::indexRecord(tag, {offset, data_length});
+    }
+
+    offset += Native_FS::recordLength(tag.len, data_length);
+  }
+
+  if (offset < used_length) {
+    TRACE_JCVM_ERR("Dropping %u bytes of truncated record",
+                   used_length - offset);
+    used_length = offset;
+  }
+
+  Native_FS::length = &used_length;
+  Native_FS::isLoaded = true;
+
+  return true;
+}
+
+/**
+ * Find the data of a tag.
+ *
+ * @param[tag] tag to find.
+ * @param[length] the found data length.
+ *
+ * @return the tag data, or nullptr if the tag does not exist.
+ */
+uint8_t *Native_FS::find(const fs::Tag &tag, uint32_t &length) {
+  if (!Native_FS::isLoaded) {
+    return nullptr;
+  }
+
+  Native_FS::stats.lookups++;
+
+  auto entry = Native_FS::index.find(tag);
+
+  if (entry == Native_FS::index.end()) {
+    Native_FS::stats.lookup_misses++;
+    return nullptr;
+  }
+
+  length = entry->second.length;
+
+  return Native_FS::memory + entry->second.offset +
+         Native_FS::recordLength(tag.len, 0);
+}
+
+/**
+ * Find an element of a tag data.
+ *
+ * @param[tag] tag to find.
+ * @param[index] element index, in bytes.
+ * @param[length] element length.
+ *
+ * @return the element, or nullptr if the tag does not exist or if the
+ * element is out of the tag data.
+ */
+uint8_t *Native_FS::findElement(const fs::Tag &tag, const uint32_t index,
+                                const uint8_t length) {
+  uint32_t data_length = 0;
+  uint8_t *data = Native_FS::find(tag, data_length);
+
+  if ((data == nullptr) || (index > data_length) ||
+      ((data_length - index) < length)) {
+    return nullptr;
+  }
+
+  return data + index;
+}
+
+/**
+ * Write the whole data of a tag: a new record is appended to the log.
+ *
+ * @param[tag] tag to write.
+ * @param[data] data to write.
+ * @param[length] data length.
+ *
+ * @return true if the record is written, false if the flash memory is full.
+ */
+bool Native_FS::write(const fs::Tag &tag, const uint8_t *data,
+                      const uint32_t length) {
+  if ((tag.len == 0) || (tag.len > TAG_MAX_LENGTH) || !Native_FS::isLoaded) {
+    return false;
+  }
+
+  uint32_t &used_length = *(Native_FS::length);
+  const uint32_t record_length = Native_FS::recordLength(tag.len, length);
+
+  if ((JCVM_NATIVE_FS_SIZE - used_length) < record_length) {
+    TRACE_JCVM_ERR("The native file system is full");
+    return false;
+  }
+
+  uint8_t *record = Native_FS::memory + used_length;
+
+  record[0] = tag.len;
+  std::memcpy(record + sizeof(uint8_t), tag.value, tag.len);
+  std::memcpy(record + sizeof(uint8_t) + tag.len, &length, sizeof(uint32_t));
+  if (length > 0) {
+    std::memmove(record + Native_FS::recordLength(tag.len, 0), data, length);
+  }
+
+  Native_FS::indexRecord(tag, {used_length, length});
+  used_length += record_length;
+
+  Native_FS::stats.writes++;
+  Native_FS::stats.written_bytes += length;
+
+  return true;
+}
+
+/**
+ * Account an element write.
+ *
+ * @param[length] element length.
+ */
+void Native_FS::countElementWrite(const uint8_t length) noexcept {
+  Native_FS::stats.element_writes++;
+  Native_FS::stats.written_bytes += length;
+}
+
+/**
+ * Run a compaction step. A compaction starts when the dead records use more
+ * than JCVM_NATIVE_FS_COMPACTION_THRESHOLD bytes and more than the live
+ * records. Each step slides the next live records, in log order, towards
+ * the log start until JCVM_NATIVE_FS_COMPACTION_STEP bytes are moved, so
+ * that a step takes a bounded time. The records appended meanwhile are
+ * compacted by the next steps.
+ *
+ * The data pointers previously given are invalidated: this must not be
+ * called while a command runs.
+ *
+ * @return true if records are moved.
+ */
+bool Native_FS::compactIfRequired() {
+  if (!Native_FS::isLoaded) {
+    return false;
+  }
+
+  if (!Native_FS::isCompacting) {
+    if ((Native_FS::stats.dead_bytes < JCVM_NATIVE_FS_COMPACTION_THRESHOLD) ||
+        (Native_FS::stats.dead_bytes < Native_FS::stats.live_bytes)) {
+      return false;
+    }
+
+    Native_FS::isCompacting = true;
+    Native_FS::compaction_read = NATIVE_FS_MAGIC_LENGTH;
+    Native_FS::compaction_write = NATIVE_FS_MAGIC_LENGTH;
+  }
+
+  uint32_t &used_length = *(Native_FS::length);
+  uint32_t moved_bytes = 0;
+  bool isMoved = false;
+
+  // The filler record of the previous step is overwritten.
+  Native_FS::stats.dead_bytes -=
+      Native_FS::compaction_read - Native_FS::compaction_write;
+
+  while ((Native_FS::compaction_read < used_length) &&
+         (moved_bytes < JCVM_NATIVE_FS_COMPACTION_STEP)) {
+    fs::Tag tag;
+    const uint32_t data_length =
+        Native_FS::readRecord(Native_FS::compaction_read, tag);
+    const uint32_t record_length = Native_FS::recordLength(tag.len,
+                                                           data_length);
+    auto entry = Native_FS::index.end();
+
+    if (tag.len > 0) {
+      entry = Native_FS::index.find(tag);
+    }
+
+    if ((entry != Native_FS::index.end()) &&
+        (entry->second.offset == Native_FS::compaction_read)) {
+      if (Native_FS::compaction_write != Native_FS::compaction_read) {
+        std::memmove(Native_FS::memory + Native_FS::compaction_write,
+                     Native_FS::memory + Native_FS::compaction_read,
+                     record_length);
+        entry->second.offset = Native_FS::compaction_write;
+        isMoved = true;
+      }
+
+      Native_FS::compaction_write += record_length;
+      moved_bytes += record_length;
+    } else {
+      Native_FS::stats.dead_bytes -= record_length;
+    }
+
+    Native_FS::compaction_read += record_length;
+  }
+
+  Native_FS::stats.compaction_steps++;
+
+  if (Native_FS::compaction_read >= used_length) {
+    TRACE_JCVM_DEBUG("Native file system compacted: %u dead bytes removed",
+                     used_length - Native_FS::compaction_write);
+
+    used_length = Native_FS::compaction_write;
+    Native_FS::isCompacting = false;
+    Native_FS::stats.compactions++;
+  } else if (Native_FS::compaction_write < Native_FS::compaction_read) {
+    const uint32_t filler_length =
+        Native_FS::compaction_read - Native_FS::compaction_write;
+
+    Native_FS::writeFiller(Native_FS::compaction_write, filler_length);
+    Native_FS::stats.dead_bytes += filler_length;
+  }
+
+  return isMoved;
+}
+
+/**
+ * Get the file system statistics.
+ *
+ * @return the file system statistics.
+ */
+const Native_FS::Stats &Native_FS::getStats() noexcept {
+  return Native_FS::stats;
+}
+
+/**
+ * Get the tag of the package list.
+ *
+ * @return the package list tag.
+ */
+fs::Tag Native_FS::getPackageListTag() noexcept {
+  fs::Tag tag;
+
+  tag.append(NATIVE_FS_TAG_PACKAGE_LIST);
+
+  return tag;
+}
+
+/**
+ * Get the tag of a CAP file.
+ *
+ * @param[package] package ID.
+ *
+ * @return the CAP file tag.
+ */
+fs::Tag Native_FS::getCapTag(const uint8_t package) noexcept {
+  fs::Tag tag;
+
+  tag.append(NATIVE_FS_TAG_CAP);
+  tag.append(package);
+
+  return tag;
+}
+
+/**
+ * Get the tag of a static field.
+ *
+ * @param[package] package ID.
+ * @param[static_id] static field index.
+ *
+ * @return the static field tag.
+ */
+fs::Tag Native_FS::getStaticFieldTag(const uint8_t package,
+                                     const uint8_t static_id) noexcept {
+  fs::Tag tag;
+
+  tag.append(NATIVE_FS_TAG_STATIC);
+  tag.append(package);
+  tag.append(static_id);
+
+  return tag;
+}
+
+/**
+ * Get the tag of an applet field.
+ *
+ * @param[applet] applet ID.
+ * @param[package] package ID.
+ * @param[claz] class index.
+ * @param[field] field index.
+ *
+ * @return the applet field tag.
+ */
+fs::Tag Native_FS::getAppletFieldTag(const uint8_t applet,
+                                     const uint8_t package,
+                                     const uint16_t claz,
+                                     const uint8_t field) noexcept {
+  fs::Tag tag;
+
+  tag.append(NATIVE_FS_TAG_APPLET_FIELD);
+  tag.append(applet);
+  tag.append(package);
+  tag.append(static_cast<uint8_t>(claz >> 8));
+  tag.append(static_cast<uint8_t>(claz & 0xFF));
+  tag.append(field);
+
+  return tag;
+}
+
+#ifndef JCVM_NATIVE_FS
+
+/**
+ * Import a Java Card OS tag data in the log. The data of a persistent field
+ * may hold an instance or a reference array, whose fields or elements are
+ * stored at nested tags: they are imported in turn, with the same nested
+ * tag suffix. The fields of an instance are probed, since its class is not
+ * resolved.
+ *
+ * @param[from] Java Card OS tag.
+ * @param[to] native file system tag.
+ * @param[isPersistentField] is the tag data a persistent field?
+ *
+ * @return false if the log is full.
+ */
+bool Native_FS::importTag(const fs::Tag &from, const fs::Tag &to,
+                          const bool isPersistentField) {
+  const uint8_t *data = nullptr;
+  uint32_t data_length = 0;
+
+  if (fs_read_inplace(from.value, from.len, &data, &data_length) != 0) {
+    // Nothing is stored at this tag.
+    return true;
+  }
+
+  if (!Native_FS::write(to, data, data_length)) {
+    return false;
+  }
+
+  uint32_t nb_nested_tags = 0;
+
+  if (isPersistentField && (data_length > 0)) {
+    switch (data[0]) {
+    case FieldType::FIELD_TYPE_OBJECT:
+      nb_nested_tags = NATIVE_FS_IMPORTED_FIELDS;
+      break;
+
+    case FieldType::FIELD_TYPE_ARRAY_OBJECT:
+    case FieldType::FIELD_TYPE_TRANSIENT_ARRAY_OBJECT:
+      if (data_length >= 3) {
+        nb_nested_tags = BYTES_TO_SHORT(data[1], data[2]);
+      }
+      break;
+
+    default:
+      break;
+    }
+  }
+
+  // The JCVM does not write the nested tags which do not fit in a tag.
+  if (((from.len + sizeof(uint16_t)) > TAG_MAX_LENGTH) ||
+      ((to.len + sizeof(uint16_t)) > TAG_MAX_LENGTH)) {
+    return true;
+  }
+
+  for (uint32_t idx = 0; idx < nb_nested_tags; idx++) {
+    if (!Native_FS::importTag(FlashMemory_Handler::computeTag(from, idx),
+                              FlashMemory_Handler::computeTag(to, idx),
+                              true)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Import the data of the Java Card OS file system: the package list, and
+ * the CAP file and the static fields of each package. Applet field tags are
+ * not used by the JCVM and are not imported. Both file systems must be
+ * loaded.
+ *
+ * @return true if the data is imported.
+ */
+bool Native_FS::import() {
+  fs::Tag from;
+
+  if (!Native_FS::isLoaded) {
+    return false;
+  }
+
+  path_package_list(&(from.value), &(from.len));
+  from.rehash();
+
+  if (!Native_FS::importTag(from, Native_FS::getPackageListTag(), false)) {
+    return false;
+  }
+
+  for (uint16_t package = 0; package <= UINT8_MAX; package++) {
+    uint32_t cap_length = 0;
+
+    path_cap(package, &(from.value), &(from.len));
+    from.rehash();
+
+    if (fs_length(from.value, from.len, &cap_length) != 0) {
+      continue;
+    }
+
+    if (!Native_FS::importTag(from, Native_FS::getCapTag(package), false)) {
+      return false;
+    }
+
+    for (uint16_t static_id = 0; static_id <= UINT8_MAX; static_id++) {
+      path_static(package, static_id, &(from.value), &(from.len));
+      from.rehash();
+
+      if (!Native_FS::importTag(
+              from, Native_FS::getStaticFieldTag(package, static_id), true)) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+#endif /* !JCVM_NATIVE_FS */
+
+} // namespace jcvm
+
+#ifdef JCVM_NATIVE_FS
+
+/// Used flash memory length, saved by the PC target.
+extern uint32_t flash_length;
+
+/**
+ * Build a tag from the file system interface arguments.
+ *
+ * @param[tag] tag value.
+ * @param[len] tag length.
+ *
+ * @return the tag.
+ */
+static jcvm::fs::Tag makeTag(const uint8_t *tag, uint8_t len) noexcept {
+  jcvm::fs::Tag fs_tag;
+
+  fs_tag.len = std::min(len, static_cast<uint8_t>(TAG_MAX_LENGTH));
+  std::memcpy(fs_tag.value, tag, fs_tag.len);
+  fs_tag.rehash();
+
+  return fs_tag;
+}
+
+/**
+ * Give a tag to the file system interface caller.
+ *
+ * @param[fs_tag] tag to give.
+ * @param[tag] the tag value.
+ * @param[len] the tag length.
+ */
+static void exportTag(const jcvm::fs::Tag &fs_tag, uint8_t (*tag)[32],
+                      uint8_t *len) noexcept {
+  std::memcpy(*tag, fs_tag.value, fs_tag.len);
+  *len = fs_tag.len;
+}
+
+/**
+ * Read an element of a tag data.
+ *
+ * @param[tag] tag value.
+ * @param[len] tag length.
+ * @param[index] element index, in bytes.
+ * @param[value] the read element.
+ *
+ * @return 0 if the element is read.
+ */
+template <typename T>
+static int readElement(const uint8_t *tag, uint8_t len, uint32_t index,
+                       T *value) {
+  const uint8_t *element =
+      jcvm::Native_FS::findElement(makeTag(tag, len), index, sizeof(T));
+
+  if (element == nullptr) {
+    return -1;
+  }
+
+  std::memcpy(value, element, sizeof(T));
+
+  return 0;
+}
+
+/**
+ * Write an element of a tag data, in place.
+ *
+ * @param[tag] tag value.
+ * @param[len] tag length.
+ * @param[index] element index, in bytes.
+ * @param[value] element to write.
+ *
+ * @return 0 if the element is written.
+ */
+template <typename T>
+static int writeElement(const uint8_t *tag, uint8_t len, uint32_t index,
+                        T value) {
+  uint8_t *element =
+      jcvm::Native_FS::findElement(makeTag(tag, len), index, sizeof(T));
+
+  if (element == nullptr) {
+    return -1;
+  }
+
+  std::memcpy(element, &value, sizeof(T));
+  jcvm::Native_FS::countElementWrite(sizeof(T));
+
+  return 0;
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int fs_init() { return jcvm::Native_FS::load(flash_length) ? 0 : -1; }
+
+uint8_t *flash_pointer() { return jcvm::Native_FS::getMemory(); }
+
+void fs_dump() {
+  const auto &stats = jcvm::Native_FS::getStats();
+
+  TRACE_JCVM_DEBUG("Native file system: %u lookups (%u misses)",
+                   stats.lookups, stats.lookup_misses);
+  TRACE_JCVM_DEBUG("Native file system: %u writes, %u element writes, "
+                   "%u bytes written",
+                   stats.writes, stats.element_writes, stats.written_bytes);
+  TRACE_JCVM_DEBUG("Native file system: %u live bytes, %u dead bytes, "
+                   "%u compactions (%u steps)",
+                   stats.live_bytes, stats.dead_bytes, stats.compactions,
+                   stats.compaction_steps);
+
+  if (stats.live_bytes > 0) {
+    TRACE_JCVM_DEBUG("Native file system: space amplification %u.%02u",
+                     (stats.live_bytes + stats.dead_bytes) / stats.live_bytes,
+                     (((stats.live_bytes + stats.dead_bytes) * 100) /
+                      stats.live_bytes) %
+                         100);
+  }
+}
+
+int fs_length(const uint8_t *tag, uint8_t len, uint32_t *length) {
+  return (jcvm::Native_FS::find(makeTag(tag, len), *length) == nullptr) ? -1
+                                                                        : 0;
+}
+
+int fs_read(const uint8_t *tag, uint8_t len, uint8_t *data,
+            uint32_t length) {
+  uint32_t data_length = 0;
+  const uint8_t *tag_data =
+      jcvm::Native_FS::find(makeTag(tag, len), data_length);
+
+  if ((tag_data == nullptr) || (length > data_length)) {
+    return -1;
+  }
+
+  std::memcpy(data, tag_data, length);
+
+  return 0;
+}
+
+int fs_read_inplace(const uint8_t *tag, uint8_t len, const uint8_t **data,
+                    uint32_t *length) {
+  *data = jcvm::Native_FS::find(makeTag(tag, len), *length);
+
+  return (*data == nullptr) ? -1 : 0;
+}
+
+int fs_write(const uint8_t *tag, uint8_t len, const uint8_t *data,
+             uint32_t length) {
+  return jcvm::Native_FS::write(makeTag(tag, len), data, length) ? 0 : -1;
+}
+
+int fs_read_1b_at(const uint8_t *tag, uint8_t len, uint32_t index,
+                  uint8_t *v) {
+  return readElement(tag, len, index, v);
+}
+
+int fs_read_2b_at(const uint8_t *tag, uint8_t len, uint32_t index,
+                  uint16_t *v) {
+  return readElement(tag, len, index, v);
+}
+
+int fs_read_4b_at(const uint8_t *tag, uint8_t len, uint32_t index,
+                  uint32_t *v) {
+  return readElement(tag, len, index, v);
+}
+
+int fs_write_1b_at(const uint8_t *tag, uint8_t len, uint32_t index,
+                   uint8_t v) {
+  return writeElement(tag, len, index, v);
+}
+
+int fs_write_2b_at(const uint8_t *tag, uint8_t len, uint32_t index,
+                   uint16_t v) {
+  return writeElement(tag, len, index, v);
+}
+
+int fs_write_4b_at(const uint8_t *tag, uint8_t len, uint32_t index,
+                   uint32_t v) {
+  return writeElement(tag, len, index, v);
+}
+
+void path_package_list(uint8_t (*tag)[32], uint8_t *len) {
+  exportTag(jcvm::Native_FS::getPackageListTag(), tag, len);
+}
+
+void path_cap(uint8_t p, uint8_t (*tag)[32], uint8_t *len) {
+  exportTag(jcvm::Native_FS::getCapTag(p), tag, len);
+}
+
+void path_static(uint8_t p, uint8_t s, uint8_t (*tag)[32], uint8_t *len) {
+  exportTag(jcvm::Native_FS::getStaticFieldTag(p, s), tag, len);
+}
+
+void path_applet_field(uint8_t a, uint8_t p, uint16_t c, uint8_t f,
+                       uint8_t (*tag)[32], uint8_t *len) {
+  exportTag(jcvm::Native_FS::getAppletFieldTag(a, p, c, f), tag, len);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JCVM_NATIVE_FS */
+
+#endif /* PC_VERSION */
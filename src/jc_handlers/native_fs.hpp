@@ -0,0 +1,164 @@
+/*
+** The MIT License (MIT)
+**
+** Copyright (c) 2020, National Cybersecurity Agency of France (ANSSI)
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+** Author:
+**   - Guillaume Bouffard <guillaume.bouffard@ssi.gouv.fr>
+*/
+
+
+#ifndef _NATIVE_FS_HPP
+#define _NATIVE_FS_HPP
+
+#include "../jc_config.h"
+#include "../types.hpp"
+#include "fs_tag.hpp"
+
+#include <unordered_map>
+
+namespace jcvm {
+
+/*
+ * In-tree implementation of the file system interface (ffi.h) for the PC
+ * target, selected by JCVM_NATIVE_FS. The other PC builds use it to convert
+ * the Java Card OS flash images.
+ *
+ * The flash memory is a log of records. Each record holds a tag and its
+ * whole data: a whole tag data write appends a new record, and the previous
+ * record of the tag becomes dead. Element writes update the last record in
+ * place. The index of the last record of each tag is built by scanning the
+ * log when the file system is loaded.
+ *
+ * Pointers to the record data are given to the interpretor (CAP files), so
+ * records are never moved while a command runs. The dead records are
+ * removed by an incremental compaction, run by bounded steps between two
+ * commands: the space left between the compacted records and the records
+ * still to compact is covered by a filler record.
+ */
+class Native_FS {
+public:
+  /// File system statistics
+  struct Stats {
+    /// Tag lookups
+    uint32_t lookups = 0;
+    /// Tag lookups of a missing tag
+    uint32_t lookup_misses = 0;
+    /// Whole tag data writes
+    uint32_t writes = 0;
+    /// Element writes
+    uint32_t element_writes = 0;
+    /// Bytes of data written
+    uint32_t written_bytes = 0;
+    /// Completed compactions
+    uint32_t compactions = 0;
+    /// Compaction steps
+    uint32_t compaction_steps = 0;
+    /// Bytes of the live records
+    uint32_t live_bytes = 0;
+    /// Bytes of the dead records and of the filler record
+    uint32_t dead_bytes = 0;
+  };
+
+private:
+  /// Last record of a tag
+  struct Record {
+    /// Record offset in the flash memory
+    uint32_t offset;
+    /// Data length
+    uint32_t length;
+  };
+
+  /// Flash memory, page aligned to map the flash memory file over it
+  alignas(4096) static uint8_t memory[JCVM_NATIVE_FS_SIZE];
+  /// Used flash memory length, bound when the log is loaded
+  static uint32_t *length;
+  /// Last record of each tag
+  static std::unordered_map<fs::Tag, Record, fs::TagHash> index;
+  /// Is the log scanned?
+  static bool isLoaded;
+  /// Is a compaction in progress?
+  static bool isCompacting;
+  /// Offset of the next record to compact
+  static uint32_t compaction_read;
+  /// Offset where the next live record is moved
+  static uint32_t compaction_write;
+  /// File system statistics
+  static Stats stats;
+
+  /// Get the record length of a tag data
+  static uint32_t recordLength(const uint8_t tag_length,
+                               const uint32_t data_length) noexcept;
+  /// Read the tag and the data length of a record
+  static uint32_t readRecord(const uint32_t offset, fs::Tag &tag) noexcept;
+  /// Index a record and account the replaced one as dead
+  static void indexRecord(const fs::Tag &tag, const Record &record);
+  /// Cover free space with a filler record
+  static void writeFiller(const uint32_t offset,
+                          const uint32_t filler_length) noexcept;
+
+#ifndef JCVM_NATIVE_FS
+  /// Import a Java Card OS tag data and the persistent objects it holds
+  static bool importTag(const fs::Tag &from, const fs::Tag &to,
+                        const bool isPersistentField);
+#endif /* !JCVM_NATIVE_FS */
+
+public:
+  /// Get the flash memory
+  static uint8_t *getMemory() noexcept;
+  /// Scan the log, or format an empty flash memory
+  static bool load(uint32_t &used_length);
+  /// Find the data of a tag
+  static uint8_t *find(const fs::Tag &tag, uint32_t &length);
+  /// Find an element of a tag data
+  static uint8_t *findElement(const fs::Tag &tag, const uint32_t index,
+                              const uint8_t length);
+  /// Write the whole data of a tag
+  static bool write(const fs::Tag &tag, const uint8_t *data,
+                    const uint32_t length);
+  /// Account an element write
+  static void countElementWrite(const uint8_t length) noexcept;
+  /// Run a compaction step, if the dead records are worth it
+  static bool compactIfRequired();
+  /// Get the file system statistics
+  static const Stats &getStats() noexcept;
+
+  /// Get the tag of the package list
+  static fs::Tag getPackageListTag() noexcept;
+  /// Get the tag of a CAP file
+  static fs::Tag getCapTag(const uint8_t package) noexcept;
+  /// Get the tag of a static field
+  static fs::Tag getStaticFieldTag(const uint8_t package,
+                                   const uint8_t static_id) noexcept;
+  /// Get the tag of an applet field
+  static fs::Tag getAppletFieldTag(const uint8_t applet, const uint8_t package,
+                                   const uint16_t claz,
+                                   const uint8_t field) noexcept;
+
+#ifndef JCVM_NATIVE_FS
+  /// Import the data of the Java Card OS file system
+  static bool import();
+#endif /* !JCVM_NATIVE_FS */
+};
+
+} // namespace jcvm
+
+#endif /* _NATIVE_FS_HPP */
@@ -28,7 +28,7 @@
 #include "package.hpp"
 #include "../jc_utils.hpp"
 #include "../jcvm_types/jcvmarray.hpp"
-#include "flashmemory.hpp"
+#include "package_registry.hpp"
 
 namespace jcvm {
 
@@ -69,8 +69,10 @@ jpackage_ID_t Package::getPackageID() const noexcept { return this->ID; }
 /**
  * Get CAP File
  *
- * @return Package CAP file.
+ * @return Package CAP file resolved by the package registry.
  */
-JC_Cap Package::getCap() const { return FlashMemory_Handler::getCap(this->ID); }
+const JC_Cap &Package::getCap() const {
+  return Package_Registry::getCap(this->ID);
+}
 
 } // namespace jcvm
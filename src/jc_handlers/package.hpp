@@ -46,7 +46,7 @@ public:
   /// Get Package ID
   jpackage_ID_t getPackageID() const noexcept;
   /// Get CAP File
-  JC_Cap getCap() const;
+  const JC_Cap &getCap() const;
 };
 
 } // namespace jcvm
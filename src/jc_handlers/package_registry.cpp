@@ -0,0 +1,445 @@
+/*
+** The MIT License (MIT)
+**
+** Copyright (c) 2020, National Cybersecurity Agency of France (ANSSI)
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+** Author:
+**   - Guillaume Bouffard <guillaume.bouffard@ssi.gouv.fr>
+*/
+
+#include "package_registry.hpp"
+#include "../exceptions.hpp"
+#include "../jc_cap/jc_cap_import.hpp"
+#include "flashmemory.hpp"
+
+namespace jcvm {
+
+Package_Registry::Entry Package_Registry::entries[JCVM_MAX_PACKAGES];
+uint16_t Package_Registry::nb_interface_ids = 0;
+
+/**
+ * Get a package entry. The CAP file is read and parsed from the flash memory
+ * on the first access only.
+ *
+ * @param[packageID] package ID where the CAP file is located.
+ *
+ * @return the resolved package entry.
+ */
+Package_Registry::Entry &
+Package_Registry::getEntry(const jpackage_ID_t packageID) {
+  if (packageID >= JCVM_MAX_PACKAGES) {
+    throw Exceptions::SecurityException;
+  }
+
+  Entry &entry = Package_Registry::entries[packageID];
+
+  if (!entry.isResolved) {
+    Package_Registry::resolve(packageID, entry);
+  }
+
+  return entry;
+}
+
+/**
+ * Resolve a package CAP file from the flash memory, check its component
+ * table and build its exported classes table. The static field and static
+ * method offsets of the exported classes are decoded once.
+ *
+ * @param[packageID] package ID to resolve.
+ * @param[entry] registry entry to fill.
+ */
+void Package_Registry::resolve(const jpackage_ID_t packageID, Entry &entry) {
+  JC_Cap cap = FlashMemory_Handler::getCap(packageID);
+
+#ifdef JCVM_DYNAMIC_CHECKS_CAP
+
+  // Mandatory components used by the component handlers.
+  if ((cap.getHeader() == nullptr) || (cap.getDirectory() == nullptr) ||
+      (cap.getImport() == nullptr) || (cap.getConstantPool() == nullptr) ||
+      (cap.getClass() == nullptr) || (cap.getMethod() == nullptr)) {
+    throw Exceptions::SecurityException;
+  }
+
+#endif /* JCVM_DYNAMIC_CHECKS_CAP */
+
+  entry.exported_classes.clear();
+
+  const jc_cap_export_component *export_comp = cap.getExport();
+
+  if (export_comp != nullptr) {
+    const uint8_t *class_export = export_comp->class_exports;
+
+    for (uint8_t index = 0; index < export_comp->class_count; index++) {
+      ExportedClass exported_class;
+
+      exported_class.info =
+          reinterpret_cast<const jc_cap_class_export_info *>(class_export);
+
+      const JCVMArray<const uint16_t> field_offsets =
+          exported_class.info->static_field_offsets();
+      const JCVMArray<const uint16_t> method_offsets =
+          exported_class.info->static_method_offsets();
+
+      for (uint8_t field = 0; field < field_offsets.size(); field++) {
+        exported_class.static_field_offsets.push_back(
+            HTONS(field_offsets.at(field)));
+      }
+
+      for (uint8_t method = 0; method < method_offsets.size(); method++) {
+        exported_class.static_method_offsets.push_back(
+            HTONS(method_offsets.at(method)));
+      }
+
+      class_export += exported_class.info->getSizeOf();
+      entry.exported_classes.push_back(std::move(exported_class));
+    }
+  }
+
+  entry.cap = cap;
+  entry.resolved_cp.clear();
+  entry.inline_caches.clear();
+  entry.vtables.clear();
+  entry.types.clear();
+  entry.layouts.clear();
+  entry.isLinked = false;
+  entry.isResolved = true;
+}
+
+/**
+ * Link the imported packages of a package: each package listed in the
+ * import component is searched once in the flash memory.
+ *
+ * @param[entry] registry entry to link.
+ */
+void Package_Registry::link(Entry &entry) {
+  const jc_cap_import_component *import = entry.cap.getImport();
+
+  entry.imported_packages.clear();
+
+  if (import != nullptr) {
+    uint16_t pos = 0;
+
+    for (uint8_t index = 0; index < import->count; index++) {
+      auto package_info = reinterpret_cast<const jc_cap_package_info *>(
+          &import->imported_packages[pos]);
+      entry.imported_packages.push_back(
+          Package_Registry::findPackage(*package_info));
+      pos += package_info->size();
+    }
+  }
+
+  entry.isLinked = true;
+}
+
+/**
+ * Get the resolved CAP file of a package.
+ *
+ * @param[packageID] package ID where the CAP file is located.
+ *
+ * @return the resolved CAP file.
+ */
+const JC_Cap &Package_Registry::getCap(const jpackage_ID_t packageID) {
+  return Package_Registry::getEntry(packageID).cap;
+}
+
+/**
+ * Get an exported class from its class export token.
+ *
+ * @param[packageID] package ID which exports the class.
+ * @param[class_token] class export token.
+ *
+ * @return the exported class information.
+ */
+const jc_cap_class_export_info &
+Package_Registry::getExportedClass(const jpackage_ID_t packageID,
+                                   const uint16_t class_token) {
+  const ExportedClass &exported_class =
+      Package_Registry::getExportedClassEntry(packageID, class_token);
+
+  return *(exported_class.info);
+}
+
+/**
+ * Get an exported class entry from its class export token.
+ *
+ * @param[packageID] package ID which exports the class.
+ * @param[class_token] class export token.
+ *
+ * @return the exported class entry.
+ */
+const Package_Registry::ExportedClass &
+Package_Registry::getExportedClassEntry(const jpackage_ID_t packageID,
+                                        const uint16_t class_token) {
+  const Entry &entry = Package_Registry::getEntry(packageID);
+
+  if (class_token >= entry.exported_classes.size()) {
+    // No export component found or unknown exported class!
+    throw Exceptions::SecurityException;
+  }
+
+  return entry.exported_classes[class_token];
+}
+
+/**
+ * Get the offset of an exported static field in the static field component.
+ *
+ * @param[packageID] package ID which exports the class.
+ * @param[class_token] class export token.
+ * @param[field_token] static field token in the exported class.
+ *
+ * @return the static field offset, in host order.
+ */
+uint16_t Package_Registry::getExportedStaticFieldOffset(
+    const jpackage_ID_t packageID, const uint16_t class_token,
+    const uint8_t field_token) {
+  const ExportedClass &exported_class =
+      Package_Registry::getExportedClassEntry(packageID, class_token);
+
+  if (field_token >= exported_class.static_field_offsets.size()) {
+    throw Exceptions::SecurityException;
+  }
+
+  return exported_class.static_field_offsets[field_token];
+}
+
+/**
+ * Get the offset of an exported static method in the method component.
+ *
+ * @param[packageID] package ID which exports the class.
+ * @param[class_token] class export token.
+ * @param[method_token] static method token in the exported class.
+ *
+ * @return the static method offset, in host order.
+ */
+uint16_t Package_Registry::getExportedStaticMethodOffset(
+    const jpackage_ID_t packageID, const uint16_t class_token,
+    const uint8_t method_token) {
+  const ExportedClass &exported_class =
+      Package_Registry::getExportedClassEntry(packageID, class_token);
+
+  if (method_token >= exported_class.static_method_offsets.size()) {
+    throw Exceptions::SecurityException;
+  }
+
+  return exported_class.static_method_offsets[method_token];
+}
+
+/**
+ * Get the package ID of an imported package. The import component is linked
+ * on the first access only.
+ *
+ * @param[packageID] package ID which imports the package.
+ * @param[import_offset] imported package offset in the import component.
+ *
+ * @return the package ID of the imported package.
+ */
+jpackage_ID_t
+Package_Registry::getImportedPackageID(const jpackage_ID_t packageID,
+                                       const uint8_t import_offset) {
+  Entry &entry = Package_Registry::getEntry(packageID);
+
+  if (!entry.isLinked) {
+    Package_Registry::link(entry);
+  }
+
+  if (import_offset >= entry.imported_packages.size()) {
+    throw Exceptions::SecurityException;
+  }
+
+  jpackage_ID_t imported_package = entry.imported_packages[import_offset];
+
+  if (imported_package == PACKAGE_REGISTRY_UNLINKED) {
+    throw Exceptions::RuntimeException;
+  }
+
+  return imported_package;
+}
+
+/**
+ * Get a resolved constant pool entry. The resolved constant pool is allocated
+ * on the first access only; its entries are filled by the constant pool
+ * handler when they are first resolved.
+ *
+ * @param[packageID] package ID where the constant pool is located.
+ * @param[offset] constant pool offset.
+ *
+ * @return the resolved constant pool entry.
+ */
+Package_Registry::ResolvedCPEntry &
+Package_Registry::getResolvedCPEntry(const jpackage_ID_t packageID,
+                                     const jc_cp_offset_t offset) {
+  Entry &entry = Package_Registry::getEntry(packageID);
+
+  const jc_cap_constant_pool_component *constant_pool =
+      entry.cap.getConstantPool();
+
+  if (entry.resolved_cp.empty() && (constant_pool != nullptr)) {
+    entry.resolved_cp.resize(constant_pool->constantpool().size());
+  }
+
+  if (offset >= entry.resolved_cp.size()) {
+    throw Exceptions::SecurityException;
+  }
+
+  return entry.resolved_cp[offset];
+}
+
+/**
+ * Get the inline cache of a call site. An empty inline cache is created on
+ * the first access.
+ *
+ * @param[packageID] package ID where the call site is located.
+ * @param[call_site] call site bytecode address in the method component.
+ *
+ * @return the inline cache of the call site.
+ */
+InlineCache &Package_Registry::getInlineCache(const jpackage_ID_t packageID,
+                                              const uint8_t *const call_site) {
+  return Package_Registry::getEntry(packageID).inline_caches[call_site];
+}
+
+/**
+ * Get the virtual method tables of a class. Empty tables are created on the
+ * first access; they are built by the class handler.
+ *
+ * @param[packageID] package ID where the class is located.
+ * @param[claz] class in the package class component.
+ *
+ * @return the virtual method tables of the class.
+ */
+Package_Registry::VTable &
+Package_Registry::getVTable(const jpackage_ID_t packageID,
+                            const jc_cap_class_info *const claz) {
+  return Package_Registry::getEntry(packageID).vtables[claz];
+}
+
+/**
+ * Get the class hierarchy index of a class or an interface. An empty index
+ * is created on the first access; it is built by the class handler.
+ *
+ * @param[packageID] package ID where the class or the interface is located.
+ * @param[jtype] class or interface in the package class component.
+ *
+ * @return the class hierarchy index of the class or the interface.
+ */
+Package_Registry::TypeInfo &
+Package_Registry::getTypeInfo(const jpackage_ID_t packageID,
+                              const uint8_t *const jtype) {
+  return Package_Registry::getEntry(packageID).types[jtype];
+}
+
+/**
+ * Get the instance layout of a class. An empty layout is created on the
+ * first access; it is computed by the class handler.
+ *
+ * @param[packageID] package ID where the class is located.
+ * @param[claz] class in the package class component.
+ *
+ * @return the instance layout of the class.
+ */
+Package_Registry::ClassLayout &
+Package_Registry::getClassLayout(const jpackage_ID_t packageID,
+                                 const jc_cap_class_info *const claz) {
+  return Package_Registry::getEntry(packageID).layouts[claz];
+}
+
+/**
+ * Give an interface ID to an interface. The interface IDs index the
+ * implemented interfaces of the class hierarchy indexes.
+ *
+ * @return a new interface ID.
+ */
+uint16_t Package_Registry::newInterfaceID() {
+  if (Package_Registry::nb_interface_ids == UINT16_MAX) {
+    throw Exceptions::FullMemoryException;
+  }
+
+  return Package_Registry::nb_interface_ids++;
+}
+
+/**
+ * Find the package ID of an installed package.
+ *
+ * @param[pinfo] package information to find.
+ *
+ * @return the package ID or PACKAGE_REGISTRY_UNLINKED if the package is not
+ * installed.
+ */
+jpackage_ID_t Package_Registry::findPackage(const jc_cap_package_info &pinfo) {
+  for (jpackage_ID_t index = 0; index < JCVM_MAX_PACKAGES; index++) {
+    if (!FlashMemory_Handler::isPackageExist(index)) {
+      continue;
+    }
+
+    const JC_Cap &cap = Package_Registry::getCap(index);
+
+    if (pinfo == cap.getHeader()->package) {
+      return index;
+    }
+  }
+
+  return PACKAGE_REGISTRY_UNLINKED;
+}
+
+/**
+ * Drop the resolved CAP file of a package. It will be resolved again on the
+ * next access. As the package set is updated, all the link tables, the
+ * resolved constant pools, the inline caches, the virtual method tables and
+ * the class hierarchy indexes, which may point to this package, are dropped
+ * too.
+ *
+ * @param[packageID] package ID to drop.
+ */
+void Package_Registry::invalidate(const jpackage_ID_t packageID) noexcept {
+  if (packageID < JCVM_MAX_PACKAGES) {
+    Package_Registry::entries[packageID].isResolved = false;
+  }
+
+  for (auto &entry : Package_Registry::entries) {
+    entry.isLinked = false;
+    entry.resolved_cp.clear();
+    entry.inline_caches.clear();
+    entry.vtables.clear();
+    entry.types.clear();
+    entry.layouts.clear();
+  }
+
+  Package_Registry::nb_interface_ids = 0;
+}
+
+/**
+ * Drop all the resolved CAP files.
+ */
+void Package_Registry::invalidateAll() noexcept {
+  for (auto &entry : Package_Registry::entries) {
+    entry.isResolved = false;
+    entry.isLinked = false;
+    entry.resolved_cp.clear();
+    entry.inline_caches.clear();
+    entry.vtables.clear();
+    entry.types.clear();
+    entry.layouts.clear();
+  }
+
+  Package_Registry::nb_interface_ids = 0;
+}
+
+} // namespace jcvm
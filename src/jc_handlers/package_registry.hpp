@@ -0,0 +1,219 @@
+/*
+** The MIT License (MIT)
+**
+** Copyright (c) 2020, National Cybersecurity Agency of France (ANSSI)
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+** Author:
+**   - Guillaume Bouffard <guillaume.bouffard@ssi.gouv.fr>
+*/
+
+#ifndef _PACKAGE_REGISTRY_HPP
+#define _PACKAGE_REGISTRY_HPP
+
+#include "../jc_cap/jc_cap_export.hpp"
+#include "../jc_cap/jc_cap_header.hpp"
+#include "../jc_config.h"
+#include "../types.hpp"
+#include "inline_cache.hpp"
+#include "jc_cap.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace jcvm {
+
+/// Link table value for an imported package not found in the flash memory.
+#define PACKAGE_REGISTRY_UNLINKED (jpackage_ID_t)0xFF
+
+/*
+ * The package registry keeps, for each installed package, the CAP file
+ * component table resolved once from the flash memory. Handlers get the
+ * component pointers from here instead of parsing the CAP file on each
+ * lookup. An entry is dropped when the package set is updated.
+ *
+ * Each entry also holds the exported classes table, with the static field
+ * and static method offsets of each exported class in host order, the link
+ * table which
+ * maps each imported package to its package ID, the resolved constant
+ * pool, filled entry by entry when the bytecodes first resolve them, the
+ * inline caches of its virtual and interface call sites, the flattened
+ * virtual and interface method tables of its classes, the class
+ * hierarchy index of its classes and interfaces and the instance layout of
+ * its classes.
+ */
+class Package_Registry {
+public:
+  /// Resolved constant pool entry
+  struct ResolvedCPEntry {
+    /// Constant pool tag the entry was resolved for, 0 when unresolved
+    uint8_t tag = 0;
+    /// Package ID where the resolved target is located
+    jpackage_ID_t packageID = 0;
+    /// Class index or static field offset in the target package
+    uint16_t offset = 0;
+    /// Class info or method info (with its header) in the target package
+    const uint8_t *target = nullptr;
+  };
+
+  /// Flattened virtual method table entry
+  struct VTableEntry {
+    /// Package ID where the method is located
+    jpackage_ID_t packageID = 0;
+    /// Method (with its header), nullptr when the token is not used
+    const uint8_t *method = nullptr;
+  };
+
+  /// Interface method table of a class for one implemented interface
+  struct ITable {
+    /// Implemented interface info
+    const uint8_t *interface = nullptr;
+    /// Implementing methods, indexed by interface method token
+    std::vector<VTableEntry> methods;
+  };
+
+  /// Class hierarchy index of a class or an interface
+  struct TypeInfo {
+    /// Is the class hierarchy index already built?
+    bool isBuilt = false;
+    /// Superclasses display, from the Object class to the class itself
+    std::vector<const uint8_t *> display;
+    /// Interface ID, for an interface only
+    uint16_t interface_id = 0;
+    /// Implemented interfaces and superinterfaces, indexed by interface ID
+    std::vector<bool> interfaces;
+  };
+
+  /// Flattened virtual method tables of a class
+  struct VTable {
+    /// Is the virtual method table already built?
+    bool isBuilt = false;
+    /// Public virtual methods, indexed by public method token
+    std::vector<VTableEntry> public_methods;
+    /// Package virtual methods, indexed by package method token
+    std::vector<VTableEntry> package_methods;
+    /// Interface method tables, built for each interface on first use
+    std::vector<ITable> itables;
+  };
+
+  /// Instance layout of a class
+  struct ClassLayout {
+    /// Is the instance layout already computed?
+    bool isBuilt = false;
+    /// Number of instance field words, including the superclasses ones
+    uint16_t nb_fields = 0;
+  };
+
+private:
+  /// Exported class
+  struct ExportedClass {
+    /// Class export information in the export component
+    const jc_cap_class_export_info *info = nullptr;
+    /// Static field offsets in the static field component, in host order
+    std::vector<uint16_t> static_field_offsets;
+    /// Static method offsets in the method component, in host order
+    std::vector<uint16_t> static_method_offsets;
+  };
+
+  /// Resolved package entry
+  struct Entry {
+    /// Is the CAP file already resolved?
+    bool isResolved = false;
+    /// Resolved CAP file component table
+    JC_Cap cap;
+    /// Exported classes, indexed by class export token
+    std::vector<ExportedClass> exported_classes;
+    /// Is the import component already linked?
+    bool isLinked = false;
+    /// Imported package IDs, indexed by import component offset
+    std::vector<jpackage_ID_t> imported_packages;
+    /// Resolved constant pool, indexed by constant pool offset
+    std::vector<ResolvedCPEntry> resolved_cp;
+    /// Inline caches, indexed by call site
+    std::unordered_map<const uint8_t *, InlineCache> inline_caches;
+    /// Virtual method tables, indexed by class
+    std::unordered_map<const jc_cap_class_info *, VTable> vtables;
+    /// Class hierarchy indexes, indexed by class or interface
+    std::unordered_map<const uint8_t *, TypeInfo> types;
+    /// Instance layouts, indexed by class
+    std::unordered_map<const jc_cap_class_info *, ClassLayout> layouts;
+  };
+
+  /// Resolved packages, indexed by package ID
+  static Entry entries[JCVM_MAX_PACKAGES];
+  /// Number of interface IDs given to the interfaces
+  static uint16_t nb_interface_ids;
+
+  /// Get a package entry
+  static Entry &getEntry(const jpackage_ID_t packageID);
+  /// Resolve and check a package CAP file
+  static void resolve(const jpackage_ID_t packageID, Entry &entry);
+  /// Link the imported packages of a package
+  static void link(Entry &entry);
+  /// Get an exported class entry from its class export token
+  static const ExportedClass &
+  getExportedClassEntry(const jpackage_ID_t packageID,
+                        const uint16_t class_token);
+
+public:
+  /// Get the resolved CAP file of a package
+  static const JC_Cap &getCap(const jpackage_ID_t packageID);
+  /// Get an exported class from its class export token
+  static const jc_cap_class_export_info &
+  getExportedClass(const jpackage_ID_t packageID, const uint16_t class_token);
+  /// Get the offset of an exported static field in the static field component
+  static uint16_t getExportedStaticFieldOffset(const jpackage_ID_t packageID,
+                                               const uint16_t class_token,
+                                               const uint8_t field_token);
+  /// Get the offset of an exported static method in the method component
+  static uint16_t getExportedStaticMethodOffset(const jpackage_ID_t packageID,
+                                                const uint16_t class_token,
+                                                const uint8_t method_token);
+  /// Get the package ID of an imported package
+  static jpackage_ID_t getImportedPackageID(const jpackage_ID_t packageID,
+                                            const uint8_t import_offset);
+  /// Get a resolved constant pool entry
+  static ResolvedCPEntry &getResolvedCPEntry(const jpackage_ID_t packageID,
+                                             const jc_cp_offset_t offset);
+  /// Get the inline cache of a call site
+  static InlineCache &getInlineCache(const jpackage_ID_t packageID,
+                                     const uint8_t *const call_site);
+  /// Get the virtual method tables of a class
+  static VTable &getVTable(const jpackage_ID_t packageID,
+                           const jc_cap_class_info *const claz);
+  /// Get the class hierarchy index of a class or an interface
+  static TypeInfo &getTypeInfo(const jpackage_ID_t packageID,
+                               const uint8_t *const jtype);
+  /// Get the instance layout of a class
+  static ClassLayout &getClassLayout(const jpackage_ID_t packageID,
+                                     const jc_cap_class_info *const claz);
+  /// Give an interface ID to an interface
+  static uint16_t newInterfaceID();
+  /// Find the package ID of an installed package
+  static jpackage_ID_t findPackage(const jc_cap_package_info &pinfo);
+  /// Drop the resolved CAP file of a package
+  static void invalidate(const jpackage_ID_t packageID) noexcept;
+  /// Drop all the resolved CAP files
+  static void invalidateAll() noexcept;
+};
+
+} // namespace jcvm
+
+#endif /* _PACKAGE_REGISTRY_HPP */
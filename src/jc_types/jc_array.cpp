@@ -43,10 +43,12 @@ namespace jcvm {
  * Constructor
  */
 JC_Array::JC_Array(Heap &owner, const uint16_t size, const jc_array_type type,
-                   const bool isTransientArray)
+                   const bool isTransientArray, const ClearEvent event)
     : JC_Object(owner, !isTransientArray), type(type), reference_type(0xFFFF),
-      array(size * JC_Array::getEntrySize(type)),
-      isTransient(isTransientArray) {
+      length(size), tag_length(0),
+      array(size * JC_Array::getEntrySize(type)), isTransient(isTransientArray),
+      clear(event),
+      epoch(Transient_Memory::getEpoch(event)) {
 #ifdef JCVM_SECURE_HEAP_ACCESS
 
   switch (this->type) {
@@ -73,10 +75,12 @@ JC_Array::JC_Array(Heap &owner, const uint16_t size, const jc_array_type type,
  */
 JC_Array::JC_Array(Heap &owner, const uint16_t size, const jc_array_type type,
                    const jc_cp_offset_t reference_type,
-                   const bool isTransientArray)
+                   const bool isTransientArray, const ClearEvent event)
     : JC_Object(owner, !isTransientArray), type(type),
       reference_type(reference_type), isTransient(isTransientArray),
-      array(size * JC_Array::getEntrySize(type)) {}
+      length(size), tag_length(0), array(size * JC_Array::getEntrySize(type)),
+      clear(event),
+      epoch(Transient_Memory::getEpoch(event)) {}
 
 /**
  * Constructor
@@ -84,42 +88,44 @@ JC_Array::JC_Array(Heap &owner, const uint16_t size, const jc_array_type type,
 JC_Array::JC_Array(Heap &owner, const jc_array_type type,
                    const jc_cp_offset_t reference_type, const fs::Tag &tag,
                    const bool isTransientArray, const ClearEvent event,
-                   const uint16_t length) noexcept
+                   const uint16_t length)
     : JC_Object(owner, true), type(type), reference_type(reference_type),
-      array(tag.len + length * JC_Array::getEntrySize(type) + sizeof(uint8_t),
-            new uint8_t[tag.len + length + sizeof(uint8_t)]),
-      isTransient(isTransientArray), clear(event) {
-  this->array[0] = tag.len;
-
-  for (uint8_t idx = 0; idx < tag.len; idx++) {
-    this->array[idx + 1] = tag.value[idx];
-  }
+      length(length), tag_length(tag.storedLength()),
+      array(tag_length +
+            (isTransientArray ? length * JC_Array::getEntrySize(type) : 0)),
+      isTransient(isTransientArray), clear(event),
+      epoch(Transient_Memory::getEpoch(event)) {
+  tag.store(this->array.data());
 }
 
 /*
- * Default destructor
+ * Compute tag value. The tag is stored with its key: it is not hashed again.
+ *
+ * @return tag value
  */
-JC_Array::~JC_Array() noexcept {
-  if (this->isTransientArray()) {
-    delete[] this->array.data();
-  }
+fs::Tag JC_Array::computeTag() const noexcept {
+  return fs::Tag::load(this->array.data());
 }
 
 /*
- * Compute tag value
- *
- * @return tag value
+ * Zero the transient array data if its clear event occurred since the data
+ * was last touched.
  */
-fs::Tag JC_Array::computeTag() const noexcept {
-  fs::Tag out;
+void JC_Array::clearIfRequired() const noexcept {
+  const uint32_t current_epoch = Transient_Memory::getEpoch(this->clear);
 
-  out.len = this->array[0];
+  if (!this->isTransientArray() || (this->epoch == current_epoch)) {
+    return;
+  }
+
+  // Transient data is located after the tag of the persistent arrays.
+  uint8_t *data = this->array.data();
 
-  for (uint8_t idx = 0; idx < out.len; idx++) {
-    out.value[idx] = this->array[idx + 1];
+  for (uint16_t idx = this->tag_length; idx < this->array.size(); idx++) {
+    data[idx] = 0;
   }
 
-  return out;
+  this->epoch = current_epoch;
 }
 
 /**
@@ -191,29 +197,12 @@ jc_cp_offset_t JC_Array::getReferenceType() const
 }
 
 /**
- * Get array size.
+ * Get array size. The size of a persistent array is read once from the flash
+ * memory, when the array is loaded in the heap.
  *
  * @return array size.
  */
-uint16_t JC_Array::size() const {
-  uint32_t length = 0;
-
-  if (this->isTransientArray()) {
-    fs::Tag tag = this->computeTag();
-
-    length = this->array.size() - tag.len - sizeof(tag.len);
-  } else if (this->isPersistent()) {
-    fs::Tag tag = this->computeTag();
-
-    if (fs_length(tag.value, tag.len, &length)) {
-      throw Exceptions::IOException;
-    }
-  } else {
-    length = this->array.size();
-  }
-
-  return (uint16_t)(length / JC_Array::getEntrySize(this->type));
-}
+uint16_t JC_Array::size() const noexcept { return this->length; }
 
 /**
  * Fetch a byte or a boolean element from an array.
@@ -241,20 +230,25 @@ jbyte_t JC_Array::getByteEntry(const uint16_t index)
 
 #endif /* JCVM_SECURE_HEAP_ACCESS */
 
-  if (this->isPersistent()) {
-    auto tag = this->computeTag();
+  this->clearIfRequired();
 
+  if (this->isPersistent()) {
     if (this->isTransientArray()) {
       const uint16_t offset = (uint16_t)(index * sizeof(jbyte_t));
 
-      return this->array[tag.len + sizeof(tag.len) + offset];
+      return this->array[this->tag_length + offset];
     } else {
-      return FlashMemory_Handler::getPersistentField_Array_Byte(tag, index
 #ifdef JCVM_SECURE_HEAP_ACCESS
-                                                                ,
-                                                                this->getOwner()
-#endif /* JCVM_SECURE_HEAP_ACESS */
-      );
+
+      if (index >= this->length) {
+        throw Exceptions::SecurityException;
+      }
+
+#endif /* JCVM_SECURE_HEAP_ACCESS */
+
+      const fs::Tag tag = this->computeTag();
+
+      return FlashMemory_Handler::getPersistentField_Array_Byte(tag, index);
     }
   } else {
     const uint16_t offset = (uint16_t)(index * sizeof(jbyte_t));
@@ -282,23 +276,26 @@ jshort_t JC_Array::getShortEntry(const uint16_t index)
 
 #endif /* JCVM_SECURE_HEAP_ACCESS */
 
-  if (this->isPersistent()) {
-    auto tag = this->computeTag();
+  this->clearIfRequired();
 
+  if (this->isPersistent()) {
     if (this->isTransientArray()) {
       const uint16_t offset = (uint16_t)(index * sizeof(jshort_t));
 
-      return BYTES_TO_SHORT(
-          this->array[tag.len + sizeof(tag.len) + offset],
-          this->array[tag.len + sizeof(tag.len) + offset + 1]);
+      return BYTES_TO_SHORT(this->array[this->tag_length + offset],
+                            this->array[this->tag_length + offset + 1]);
     } else {
-      return FlashMemory_Handler::getPersistentField_Array_Short(
-          tag, index
 #ifdef JCVM_SECURE_HEAP_ACCESS
-          ,
-          this->getOwner()
-#endif /* JCVM_SECURE_HEAP_ACESS */
-      );
+
+      if (index >= this->length) {
+        throw Exceptions::SecurityException;
+      }
+
+#endif /* JCVM_SECURE_HEAP_ACCESS */
+
+      const fs::Tag tag = this->computeTag();
+
+      return FlashMemory_Handler::getPersistentField_Array_Short(tag, index);
     }
   } else {
     const uint16_t offset = (uint16_t)(index * sizeof(jshort_t));
@@ -329,23 +326,28 @@ jint_t JC_Array::getIntEntry(const uint16_t index)
 
 #endif /* JCVM_SECURE_HEAP_ACCESS */
 
-  if (this->isPersistent()) {
-    auto tag = this->computeTag();
+  this->clearIfRequired();
 
+  if (this->isPersistent()) {
     if (this->isTransientArray()) {
       const uint16_t offset = (uint16_t)(index * sizeof(jint_t));
 
-      return BYTES_TO_INT(this->array[tag.len + sizeof(tag.len) + offset],
-                          this->array[tag.len + sizeof(tag.len) + offset + 1],
-                          this->array[tag.len + sizeof(tag.len) + offset + 2],
-                          this->array[tag.len + sizeof(tag.len) + offset + 3]);
+      return BYTES_TO_INT(this->array[this->tag_length + offset],
+                          this->array[this->tag_length + offset + 1],
+                          this->array[this->tag_length + offset + 2],
+                          this->array[this->tag_length + offset + 3]);
     } else {
-      return FlashMemory_Handler::getPersistentField_Array_Int(tag, index
 #ifdef JCVM_SECURE_HEAP_ACCESS
-                                                               ,
-                                                               this->getOwner()
-#endif /* JCVM_SECURE_HEAP_ACESS */
-      );
+
+      if (index >= this->length) {
+        throw Exceptions::SecurityException;
+      }
+
+#endif /* JCVM_SECURE_HEAP_ACCESS */
+
+      const fs::Tag tag = this->computeTag();
+
+      return FlashMemory_Handler::getPersistentField_Array_Int(tag, index);
     }
   } else {
     const uint16_t offset = (uint16_t)(index * sizeof(jint_t));
@@ -376,16 +378,25 @@ jref_t JC_Array::getReferenceEntry(const uint16_t index)
 
 #endif /* JCVM_SECURE_HEAP_ACCESS */
 
-  if (this->isPersistent()) {
-    auto tag = this->computeTag();
+  this->clearIfRequired();
 
+  if (this->isPersistent()) {
     if (this->isTransientArray()) {
       const uint16_t offset = (uint16_t)(index * sizeof(jref_t));
 
-      return BYTES_TO_SHORT(
-          this->array[tag.len + sizeof(tag.len) + offset],
-          this->array[tag.len + sizeof(tag.len) + offset + 1]);
+      return BYTES_TO_SHORT(this->array[this->tag_length + offset],
+                            this->array[this->tag_length + offset + 1]);
     } else {
+#ifdef JCVM_SECURE_HEAP_ACCESS
+
+      if (index >= this->length) {
+        throw Exceptions::SecurityException;
+      }
+
+#endif /* JCVM_SECURE_HEAP_ACCESS */
+
+      const fs::Tag tag = this->computeTag();
+
       return FlashMemory_Handler::getPersistentField_Array_Reference(
           tag, index, this->getOwner());
     }
@@ -421,25 +432,35 @@ void JC_Array::setByteEntry(const uint16_t index, const jbyte_t value)
 
 #endif /* JCVM_SECURE_HEAP_ACCESS */
 
-  if (this->isPersistent()) {
-    auto tag = this->computeTag();
+  this->clearIfRequired();
 
+  if (this->isPersistent()) {
     if (this->isTransientArray()) {
       const uint16_t offset = (uint16_t)(index * sizeof(jbyte_t));
 
-      this->array[tag.len + sizeof(tag.len) + offset] = value;
+      this->array[this->tag_length + offset] = value;
     } else {
-      FlashMemory_Handler::setPersistentField_Array_Byte(tag, index, value
 #ifdef JCVM_SECURE_HEAP_ACCESS
-                                                         ,
-                                                         this->getOwner()
-#endif /* JCVM_SECURE_HEAP_ACESS */
-      );
+
+      if (index >= this->length) {
+        throw Exceptions::SecurityException;
+      }
+
+#endif /* JCVM_SECURE_HEAP_ACCESS */
+
+      const fs::Tag tag = this->computeTag();
+
+      this->getOwner().removeStoredObject(tag);
+      FlashMemory_Handler::setPersistentField_Array_Byte(tag, index, value);
     }
   } else {
     const uint16_t offset = (uint16_t)(index * sizeof(jbyte_t));
 
     this->array[offset] = value;
+
+    if (!this->isTransientArray()) {
+      this->markModified();
+    }
   }
 }
 
@@ -462,28 +483,37 @@ void JC_Array::setShortEntry(const uint16_t index, const jshort_t value)
 
 #endif /* JCVM_SECURE_HEAP_ACCESS */
 
-  if (this->isPersistent()) {
-    auto tag = this->computeTag();
+  this->clearIfRequired();
 
+  if (this->isPersistent()) {
     if (this->isTransientArray()) {
       const uint16_t offset = (uint16_t)(index * sizeof(jshort_t));
 
-      this->array[tag.len + sizeof(tag.len) + offset] = HIGH_BYTE_SHORT(value);
-      this->array[tag.len + sizeof(tag.len) + offset + 1] =
-          LOW_BYTE_SHORT(value);
+      this->array[this->tag_length + offset] = HIGH_BYTE_SHORT(value);
+      this->array[this->tag_length + offset + 1] = LOW_BYTE_SHORT(value);
     } else {
-      FlashMemory_Handler::setPersistentField_Array_Short(tag, index, value
 #ifdef JCVM_SECURE_HEAP_ACCESS
-                                                          ,
-                                                          this->getOwner()
-#endif /* JCVM_SECURE_HEAP_ACESS */
-      );
+
+      if (index >= this->length) {
+        throw Exceptions::SecurityException;
+      }
+
+#endif /* JCVM_SECURE_HEAP_ACCESS */
+
+      const fs::Tag tag = this->computeTag();
+
+      this->getOwner().removeStoredObject(tag);
+      FlashMemory_Handler::setPersistentField_Array_Short(tag, index, value);
     }
   } else {
     const uint16_t offset = (uint16_t)(index * sizeof(jshort_t));
 
     this->array[offset] = HIGH_BYTE_SHORT(value);
     this->array[offset + 1] = LOW_BYTE_SHORT(value);
+
+    if (!this->isTransientArray()) {
+      this->markModified();
+    }
   }
 }
 
@@ -507,27 +537,33 @@ void JC_Array::setIntEntry(const uint16_t index, const jint_t value)
 
 #endif /* JCVM_SECURE_HEAP_ACCESS */
 
-  if (this->isPersistent()) {
-    auto tag = this->computeTag();
+  this->clearIfRequired();
 
+  if (this->isPersistent()) {
     if (this->isTransientArray()) {
       const uint16_t offset = (uint16_t)(index * sizeof(jint_t));
 
-      this->array[tag.len + sizeof(tag.len) + offset] =
+      this->array[this->tag_length + offset] =
           HIGH_BYTE_SHORT(INT_2_MSSHORTS(value));
-      this->array[tag.len + sizeof(tag.len) + offset + 1] =
+      this->array[this->tag_length + offset + 1] =
           LOW_BYTE_SHORT(INT_2_MSSHORTS(value));
-      this->array[tag.len + sizeof(tag.len) + offset + 2] =
+      this->array[this->tag_length + offset + 2] =
           HIGH_BYTE_SHORT(INT_2_LSSHORTS(value));
-      this->array[tag.len + sizeof(tag.len) + offset + 3] =
+      this->array[this->tag_length + offset + 3] =
           LOW_BYTE_SHORT(INT_2_LSSHORTS(value));
     } else {
-      FlashMemory_Handler::setPersistentField_Array_Int(tag, index, value
 #ifdef JCVM_SECURE_HEAP_ACCESS
-                                                        ,
-                                                        this->getOwner()
-#endif /* JCVM_SECURE_HEAP_ACESS */
-      );
+
+      if (index >= this->length) {
+        throw Exceptions::SecurityException;
+      }
+
+#endif /* JCVM_SECURE_HEAP_ACCESS */
+
+      const fs::Tag tag = this->computeTag();
+
+      this->getOwner().removeStoredObject(tag);
+      FlashMemory_Handler::setPersistentField_Array_Int(tag, index, value);
     }
   } else {
     const uint16_t offset = (uint16_t)(index * sizeof(jint_t));
@@ -536,6 +572,10 @@ void JC_Array::setIntEntry(const uint16_t index, const jint_t value)
     this->array[offset + 1] = LOW_BYTE_SHORT(INT_2_MSSHORTS(value));
     this->array[offset + 2] = HIGH_BYTE_SHORT(INT_2_LSSHORTS(value));
     this->array[offset + 3] = LOW_BYTE_SHORT(INT_2_LSSHORTS(value));
+
+    if (!this->isTransientArray()) {
+      this->markModified();
+    }
   }
 }
 #endif /* JCVM_INT_SUPPORTED */
@@ -582,10 +622,9 @@ void JC_Array::setReferenceEntry(const uint16_t index, const jref_t value
         reinterpret_cast<const uint8_t *>(
             ConstantPool_Handler(instanceref_to_add->getPackageID())
                 .getClassFromClassIndex(instanceref_to_add->getClassIndex())));
-    auto classref_out = cp_handler.getClassRef(this->reference_type);
+    auto classref_out = cp_handler.getResolvedClassref(this->reference_type);
 
-    if (class_handler.docheckcast(
-            classref_in, cp_handler.resolveClassref(classref_out)) == FALSE) {
+    if (class_handler.docheckcast(classref_in, classref_out) == FALSE) {
       throw Exceptions::ArrayStoreException;
     }
   } else {
@@ -615,12 +654,10 @@ void JC_Array::setReferenceEntry(const uint16_t index, const jref_t value
     case jc_array_type::JAVA_ARRAY_T_REFERENCE: {
 
       auto classref_in =
-          cp_handler.getClassRef(arrayref_to_add->getReferenceType());
-      auto classref_out = cp_handler.getClassRef(this->reference_type);
+          cp_handler.getResolvedClassref(arrayref_to_add->getReferenceType());
+      auto classref_out = cp_handler.getResolvedClassref(this->reference_type);
 
-      if (class_handler.docheckcast(cp_handler.resolveClassref(classref_in),
-                                    cp_handler.resolveClassref(classref_out)) ==
-          FALSE) {
+      if (class_handler.docheckcast(classref_in, classref_out) == FALSE) {
         throw Exceptions::ArrayStoreException;
       }
     }
@@ -634,17 +671,28 @@ void JC_Array::setReferenceEntry(const uint16_t index, const jref_t value
 
 #endif /* JCVM_FIREWALL_CHECKS */
 
-  if (this->isPersistent()) {
-    auto tag = this->computeTag();
+  this->clearIfRequired();
 
+  if (this->isPersistent()) {
     if (this->isTransientArray()) {
       const uint16_t offset = (uint16_t)(index * sizeof(jref_t));
 
-      this->array[tag.len + sizeof(tag.len) + offset] =
+      this->array[this->tag_length + offset] =
           HIGH_BYTE_SHORT(value.compact());
-      this->array[tag.len + sizeof(tag.len) + offset + 1] =
+      this->array[this->tag_length + offset + 1] =
           LOW_BYTE_SHORT(value.compact());
     } else {
+#ifdef JCVM_SECURE_HEAP_ACCESS
+
+      if (index >= this->length) {
+        throw Exceptions::SecurityException;
+      }
+
+#endif /* JCVM_SECURE_HEAP_ACCESS */
+
+      const fs::Tag tag = this->computeTag();
+
+      this->getOwner().removeStoredObject(tag);
       FlashMemory_Handler::setPersistentField_Array_Reference(tag, index, value,
                                                               this->getOwner());
     }
@@ -663,12 +711,11 @@ void JC_Array::setReferenceEntry(const uint16_t index, const jref_t value
  * @return Const pointer to array data
  */
 const uint8_t *JC_Array::getData() const {
+  this->clearIfRequired();
 
   if (this->isPersistent()) {
-    auto tag = this->computeTag();
-
     if (this->isTransientArray()) {
-      return &(this->array.data()[tag.len + sizeof(tag.len)]);
+      return &(this->array.data()[this->tag_length]);
     } else {
       throw Exceptions::RuntimeException;
     }
@@ -693,4 +740,68 @@ const ClearEvent JC_Array::getClearEvent() const noexcept {
   return this->clear;
 }
 
+/**
+ * Get the field type of a field holding this array.
+ *
+ * @return the array field type.
+ */
+FieldType JC_Array::getFieldType() const {
+  FieldType field_type;
+
+  switch (this->type) {
+  case JAVA_ARRAY_T_BOOLEAN:
+    if (this->isTransientArray()) {
+      field_type = FieldType::FIELD_TYPE_TRANSIENT_ARRAY_BOOLEAN;
+    } else {
+      field_type = FieldType::FIELD_TYPE_ARRAY_BOOLEAN;
+    }
+
+    break;
+
+  case JAVA_ARRAY_T_BYTE:
+    if (this->isTransientArray()) {
+      field_type = FieldType::FIELD_TYPE_TRANSIENT_ARRAY_BYTE;
+    } else {
+      field_type = FieldType::FIELD_TYPE_ARRAY_BYTE;
+    }
+
+    break;
+
+  case JAVA_ARRAY_T_SHORT:
+    if (this->isTransientArray()) {
+      field_type = FieldType::FIELD_TYPE_TRANSIENT_ARRAY_SHORT;
+    } else {
+      field_type = FieldType::FIELD_TYPE_ARRAY_SHORT;
+    }
+
+    break;
+
+#ifdef JCVM_INT_SUPPORTED
+
+  case JAVA_ARRAY_T_INT:
+    if (this->isTransientArray()) {
+      field_type = FieldType::FIELD_TYPE_TRANSIENT_ARRAY_INT;
+    } else {
+      field_type = FieldType::FIELD_TYPE_ARRAY_INT;
+    }
+
+    break;
+#endif /* JCVM_INT_SUPPORTED */
+
+  case JAVA_ARRAY_T_REFERENCE:
+    if (this->isTransientArray()) {
+      field_type = FieldType::FIELD_TYPE_TRANSIENT_ARRAY_OBJECT;
+    } else {
+      field_type = FieldType::FIELD_TYPE_ARRAY_OBJECT;
+    }
+
+    break;
+
+  default:
+    throw Exceptions::SecurityException;
+  }
+
+  return field_type;
+}
+
 } // namespace jcvm
@@ -31,26 +31,18 @@
 #include "../jc_config.h"
 #include "../jc_handlers/flashmemory.hpp"
 #include "../jcvm_types/jcvmarray.hpp"
+#include "../transient_memory.hpp"
 #include "../types.hpp"
 #include "jc_array_type.hpp"
+#include "jc_field.hpp"
 #include "jc_object.hpp"
 #include "jref_t.hpp"
 
-#ifdef JCVM_FIREWALL_CHECKS
-#include "../context.hpp"
-#endif /* JCVM_FIREWALL_CHECKS */
-
 namespace jcvm {
 
 /// Fast forward declation.
 class Context;
 
-enum ClearEvent : uint8_t {
-  CLEAR_ON_SELECT = (uint8_t)1,
-  CLEAR_ON_DESELECT = (uint8_t)2,
-  None = (uint8_t)0xFF,
-};
-
 class JC_Array : public JC_Object {
 private:
   /// Is a transient array?
@@ -61,10 +53,19 @@ private:
    * cp_offset is a 2-byte offset in the constant pool component.
    */
   const jc_cp_offset_t reference_type;
-  /// Data
-  JCVMArray<uint8_t> array;
+  /// Number of entries, read once from the flash memory for persistent arrays
+  const uint16_t length;
+  /// Length of the tag stored before the data of persistent arrays
+  const uint8_t tag_length;
+  /// Data, lazily zeroed on the first access after a clear event
+  mutable JCVMArray<uint8_t> array;
   /// When to clear data
   ClearEvent clear;
+  /// Clear event epoch when the data was last touched
+  mutable uint32_t epoch;
+
+  /// Zero the transient data if its clear event occurred since last access
+  void clearIfRequired() const noexcept;
 
   ///  Get an entry size from the size type.
   static const uint16_t getEntrySize(const jc_array_type type);
@@ -77,18 +78,20 @@ public:
   uint16_t getEntrySize() const;
 
   JC_Array(Heap &owner, const uint16_t size, const jc_array_type type,
-           const bool isTransientArray = false);
+           const bool isTransientArray = false,
+           const ClearEvent event = ClearEvent::None);
   JC_Array(Heap &owner, const uint16_t size, const jc_array_type type,
-           const jc_cp_offset_t reference_type, const bool isTransient = false);
+           const jc_cp_offset_t reference_type, const bool isTransient = false,
+           const ClearEvent event = ClearEvent::None);
   /// Constructor for static array?
   JC_Array(Heap &owner, const jc_array_type type,
            const jc_cp_offset_t reference_type, const fs::Tag &tag,
            const bool isTransientArray,
            const ClearEvent event = ClearEvent::None,
-           const uint16_t length = 0) noexcept;
+           const uint16_t length = 0);
 
-  /// Default destructor
-  ~JC_Array() noexcept;
+  /// Move constructor
+  JC_Array(JC_Array &&) noexcept = default;
 
   /// Get array type
   jc_array_type getType() const noexcept;
@@ -99,7 +102,7 @@ public:
 #endif /* JCVM_SECURE_HEAP_ACCESS */
       ;
   /// Get array size
-  uint16_t size() const;
+  uint16_t size() const noexcept;
 
   /// Fetch a byte or a boolean element from an array.
   jbyte_t getByteEntry(const uint16_t index)
@@ -168,6 +171,9 @@ public:
 
   /// Get clear event
   const ClearEvent getClearEvent() const noexcept;
+
+  /// Get the field type of a field holding this array
+  FieldType getFieldType() const;
 };
 
 } // namespace jcvm
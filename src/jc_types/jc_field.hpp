@@ -64,10 +64,54 @@ enum FieldType : uint8_t {
 
 }; // namespace jcvm
 
-struct jc_field_t {
-  FieldType type;
-  jword_t value;
-};
+/// Packed field type of an uninitialized field.
+#define FIELD_TYPE_PACKED_UNINITIALIZED (uint8_t)0x0F
+
+/*
+ * Pack a field type on 4 bits. Each scalar type is encoded once as a value,
+ * once as an array element type and once as a transient array element type.
+ *
+ * @param[type] field type to pack.
+ * @return the packed field type.
+ */
+inline uint8_t packFieldType(const FieldType type) noexcept {
+  if (type == FIELD_TYPE_UNINITIALIZED) {
+    return FIELD_TYPE_PACKED_UNINITIALIZED;
+  }
+
+  const uint8_t kind = (type & (1 << 6)) ? 2 : ((type & (1 << 7)) ? 1 : 0);
+
+  return (uint8_t)((type & 0x07) + 5 * kind);
+}
+
+/*
+ * Unpack a 4-bit field type.
+ *
+ * @param[packed] packed field type.
+ * @return the field type.
+ */
+inline FieldType unpackFieldType(const uint8_t packed) noexcept {
+  if (packed >= FIELD_TYPE_PACKED_UNINITIALIZED) {
+    return FIELD_TYPE_UNINITIALIZED;
+  }
+
+  const uint8_t kind = packed / 5;
+  const uint8_t flags = (kind == 2) ? ((1 << 7) | (1 << 6))
+                                    : ((kind == 1) ? (1 << 7) : 0);
+
+  return static_cast<FieldType>(flags | (packed % 5));
+}
+
+/*
+ * Is a field type a reference to an instance or an array?
+ *
+ * @param[type] field type to check.
+ * @return true if the field holds a reference.
+ */
+inline bool isReferenceFieldType(const FieldType type) noexcept {
+  return (type == FIELD_TYPE_OBJECT) ||
+         ((type != FIELD_TYPE_UNINITIALIZED) && (type & (1 << 7)));
+}
 
 } // namespace jcvm
 
@@ -42,8 +42,13 @@ namespace jcvm {
  * @param[instantiated_class] Constant Pool token to the instantiated class.
  */
 JC_Instance::JC_Instance(Heap &owner, const Package &package_owner,
-                         const jc_cp_offset_t instantiated_class) noexcept
-    : JC_Object(owner, false) {
+                         const jc_cp_offset_t instantiated_class)
+    : JC_Object(owner, false), fields(0)
+#ifdef JCVM_TYPED_HEAP
+      ,
+      field_types(0)
+#endif /* JCVM_TYPED_HEAP */
+{
   ConstantPool_Handler cp(package_owner);
   std::pair<jpackage_ID_t, jclass_index_t> pair =
       cp.getClassInformation(instantiated_class);
@@ -53,7 +58,13 @@ JC_Instance::JC_Instance(Heap &owner, const Package &package_owner,
 
   Class_Handler class_handler(this->packageID);
   uint16_t fields_size = class_handler.getInstanceFieldsSize(this->claz);
-  this->fields = new JCVMArray<jc_field_t>(fields_size);
+  this->fields = JCVMArray<jword_t>(fields_size);
+
+#ifdef JCVM_TYPED_HEAP
+  this->field_types = JCVMArray<uint8_t>((fields_size + 1) / 2);
+  this->field_types.fill((FIELD_TYPE_PACKED_UNINITIALIZED << 4) |
+                         FIELD_TYPE_PACKED_UNINITIALIZED);
+#endif /* JCVM_TYPED_HEAP */
 }
 
 /**
@@ -64,12 +75,19 @@ JC_Instance::JC_Instance(Heap &owner, const Package &package_owner,
  * @param[claz] class index
  */
 JC_Instance::JC_Instance(Heap &owner, const jpackage_ID_t packageID,
-                         const jclass_index_t claz) noexcept
-    : JC_Object(owner, false), packageID(packageID), claz(claz) {
-  Class_Handler class_handler(this->packageID);
-  uint16_t fields_size = class_handler.getInstanceFieldsSize(this->claz);
-  this->fields = new JCVMArray<jc_field_t>(fields_size);
-};
+                         const jclass_index_t claz)
+    : JC_Object(owner, false), packageID(packageID), claz(claz),
+      fields(Class_Handler(packageID).getInstanceFieldsSize(claz))
+#ifdef JCVM_TYPED_HEAP
+      ,
+      field_types((this->fields.size() + 1) / 2)
+#endif /* JCVM_TYPED_HEAP */
+{
+#ifdef JCVM_TYPED_HEAP
+  this->field_types.fill((FIELD_TYPE_PACKED_UNINITIALIZED << 4) |
+                         FIELD_TYPE_PACKED_UNINITIALIZED);
+#endif /* JCVM_TYPED_HEAP */
+}
 
 /**
  * Default constructor.
@@ -82,42 +100,57 @@ JC_Instance::JC_Instance(Heap &owner, const jpackage_ID_t packageID,
  */
 JC_Instance::JC_Instance(Heap &owner, const jpackage_ID_t packageID,
                          const jclass_index_t claz_index,
-                         const fs::Tag &tag) noexcept
-    : JC_Object(owner, true), packageID(packageID), claz(claz) {
-
-  jc_field_t field_tag[tag.len];
-
-  for (uint8_t idx = 0; idx < tag.len; idx++) {
-    field_tag[idx].value = tag.value[idx];
-  }
-
-  this->fields = new JCVMArray<jc_field_t>(tag.len, field_tag);
+                         const fs::Tag &tag)
+    : JC_Object(owner, true), packageID(packageID), claz(claz_index),
+      fields((tag.storedLength() + sizeof(jword_t) - 1) / sizeof(jword_t))
+#ifdef JCVM_TYPED_HEAP
+      ,
+      field_types(0)
+#endif /* JCVM_TYPED_HEAP */
+{
+  // The tag is stored with its key in the field words.
+  tag.store(reinterpret_cast<uint8_t *>(this->fields.data()));
 }
 
-/*
- * Default destructor
+/**
+ * Move constructor. The moved instance loses its fields.
+ *
+ * @param[instance] instance to move.
  */
-JC_Instance::~JC_Instance() noexcept {
-  if (this->fields != nullptr) {
-    delete this->fields;
-  }
+JC_Instance::JC_Instance(JC_Instance &&instance) noexcept
+    : JC_Object(instance), packageID(instance.packageID), claz(instance.claz),
+      fields(std::move(instance.fields))
+#ifdef JCVM_TYPED_HEAP
+      ,
+      field_types(std::move(instance.field_types))
+#endif /* JCVM_TYPED_HEAP */
+{
 }
 
 /**
- * Recompute instance Tag
+ * Recompute instance Tag. The tag is stored with its key: the field tags are
+ * appended to it without hashing it again.
  *
  * @return original instance tag
  */
 fs::Tag JC_Instance::recomputeOriginalTag() const noexcept {
-  fs::Tag tag;
+  return fs::Tag::load(
+      reinterpret_cast<const uint8_t *>(this->fields.data()));
+}
 
-  tag.len = this->fields->size();
+/**
+ * Get the tag of a persistent field to write. The RAM object stored at the
+ * instance tag, if any, is no more the instance data.
+ *
+ * @param[index] index of the instance field to write.
+ * @return the field tag.
+ */
+fs::Tag JC_Instance::getWrittenFieldTag(const uint16_t index) {
+  const fs::Tag tag = this->recomputeOriginalTag();
 
-  for (decltype(this->fields->size()) idx; idx < this->fields->size(); idx++) {
-    tag.value[idx] = static_cast<uint8_t>(this->fields->at(idx).value);
-  }
+  this->getOwner().removeStoredObject(tag);
 
-  return tag;
+  return FlashMemory_Handler::computeTag(tag, index);
 }
 
 /*
@@ -171,10 +204,15 @@ const jbyte_t JC_Instance::getField_Byte(const uint16_t index) {
   } else {
 
 #ifdef JCVM_TYPED_HEAP
-    // TODO: the instance data value type should be verified.
+    const FieldType type = this->getFieldType(index);
+
+    if ((type != FIELD_TYPE_BYTE) && (type != FIELD_TYPE_BOOLEAN) &&
+        (type != FIELD_TYPE_UNINITIALIZED)) {
+      throw Exceptions::SecurityException;
+    }
 #endif /* JCVM_TYPED_HEAP */
 
-    return (jbyte_t)(this->fields->at(index).value);
+    return (jbyte_t)(this->fields.at(index));
   }
 }
 
@@ -193,10 +231,14 @@ const jshort_t JC_Instance::getField_Short(const uint16_t index) {
   } else {
 
 #ifdef JCVM_TYPED_HEAP
-    // TODO: the instance data value type should be verified.
+    const FieldType type = this->getFieldType(index);
+
+    if ((type != FIELD_TYPE_SHORT) && (type != FIELD_TYPE_UNINITIALIZED)) {
+      throw Exceptions::SecurityException;
+    }
 #endif /* JCVM_TYPED_HEAP */
 
-    return (jshort_t)(this->fields->at(index).value);
+    return (jshort_t)(this->fields.at(index));
   }
 }
 
@@ -215,12 +257,16 @@ const jint_t JC_Instance::getField_Int(const uint16_t index) {
     return FlashMemory_Handler::getPersistentField_Int(tag);
   } else {
 
-    const jword_t field_high_part = this->fields->at(index).value;
+    const jword_t field_high_part = this->fields.at(index);
     const jword_t field_low_part =
-        this->fields->at((uint16_t)(index + 1)).value;
+        this->fields.at((uint16_t)(index + 1));
 
 #ifdef JCVM_TYPED_HEAP
-    // TODO: the instance data value type should be verified.
+    const FieldType type = this->getFieldType(index);
+
+    if ((type != FIELD_TYPE_INT) && (type != FIELD_TYPE_UNINITIALIZED)) {
+      throw Exceptions::SecurityException;
+    }
 #endif /* JCVM_TYPED_HEAP */
 
     return (jint_t)(SHORTS_TO_INT(field_high_part, field_low_part));
@@ -239,14 +285,19 @@ const jref_t JC_Instance::getField_Reference(const uint16_t index) {
     fs::Tag tag =
         FlashMemory_Handler::computeTag(this->recomputeOriginalTag(), index);
 
-    FlashMemory_Handler::getPersistentField_Reference(tag, this->getOwner());
+    return FlashMemory_Handler::getPersistentField_Reference(tag,
+                                                             this->getOwner());
   } else {
 
 #ifdef JCVM_TYPED_HEAP
-    // TODO: the instance data value type should be verified.
+    const FieldType type = this->getFieldType(index);
+
+    if (!isReferenceFieldType(type) && (type != FIELD_TYPE_UNINITIALIZED)) {
+      throw Exceptions::SecurityException;
+    }
 #endif /* JCVM_TYPED_HEAP */
 
-    return jref_t(this->fields->at(index).value);
+    return jref_t(this->fields.at(index));
   }
 }
 
@@ -258,17 +309,17 @@ const jref_t JC_Instance::getField_Reference(const uint16_t index) {
  */
 void JC_Instance::setField_Byte(uint16_t index, jbyte_t value) {
   if (this->isPersistent()) {
-    fs::Tag tag =
-        FlashMemory_Handler::computeTag(this->recomputeOriginalTag(), index);
+    fs::Tag tag = this->getWrittenFieldTag(index);
 
     FlashMemory_Handler::setPersistentField_Byte(tag, value);
   } else {
 
 #ifdef JCVM_TYPED_HEAP
-    // TODO: the instance data value type should be saved.
+    this->setFieldType(index, FIELD_TYPE_BYTE);
 #endif /* JCVM_TYPED_HEAP */
 
-    this->fields->at(index).value = (jword_t)(BYTE_TO_WORD(value));
+    this->fields.at(index) = (jword_t)(BYTE_TO_WORD(value));
+    this->markModified();
   }
 }
 
@@ -280,17 +331,17 @@ void JC_Instance::setField_Byte(uint16_t index, jbyte_t value) {
  */
 void JC_Instance::setField_Short(const uint16_t index, const jshort_t value) {
   if (this->isPersistent()) {
-    fs::Tag tag =
-        FlashMemory_Handler::computeTag(this->recomputeOriginalTag(), index);
+    fs::Tag tag = this->getWrittenFieldTag(index);
 
     FlashMemory_Handler::setPersistentField_Short(tag, value);
   } else {
 
 #ifdef JCVM_TYPED_HEAP
-    // TODO: the instance data value type should be saved.
+    this->setFieldType(index, FIELD_TYPE_SHORT);
 #endif /* JCVM_TYPED_HEAP */
 
-    this->fields->at(index).value = (jword_t)(value);
+    this->fields.at(index) = (jword_t)(value);
+    this->markModified();
   }
 }
 
@@ -303,19 +354,20 @@ void JC_Instance::setField_Short(const uint16_t index, const jshort_t value) {
  */
 void JC_Instance::setField_Int(const uint16_t index, const jint_t value) {
   if (this->isPersistent()) {
-    fs::Tag tag =
-        FlashMemory_Handler::computeTag(this->recomputeOriginalTag(), index);
+    fs::Tag tag = this->getWrittenFieldTag(index);
 
     FlashMemory_Handler::setPersistentField_Int(tag, value);
   } else {
 
 #ifdef JCVM_TYPED_HEAP
-    // TODO: the instance data value type should be saved.
+    this->setFieldType(index, FIELD_TYPE_INT);
+    this->setFieldType((uint16_t)(index + 1), FIELD_TYPE_INT);
 #endif /* JCVM_TYPED_HEAP */
 
-    this->fields->at(index).value = (jword_t)(INT_2_MSSHORTS(value));
-    this->fields->at((uint16_t)(index + 1)).value =
+    this->fields.at(index) = (jword_t)(INT_2_MSSHORTS(value));
+    this->fields.at((uint16_t)(index + 1)) =
         (jword_t)(INT_2_LSSHORTS(value));
+    this->markModified();
   }
 }
 
@@ -329,40 +381,68 @@ void JC_Instance::setField_Int(const uint16_t index, const jint_t value) {
  */
 void JC_Instance::setField_Reference(const uint16_t index, const jref_t ref) {
   if (this->isPersistent()) {
-    fs::Tag tag =
-        FlashMemory_Handler::computeTag(this->recomputeOriginalTag(), index);
+    fs::Tag tag = this->getWrittenFieldTag(index);
 
-    if (ref.isArray()) {
-      auto array = this->getOwner().getArray(ref);
-      FlashMemory_Handler::setPersistentField_Array(tag, *array,
-                                                    this->getOwner());
-    } else {
-      auto instance = this->getOwner().getInstance(ref);
-      FlashMemory_Handler::setPersistentField_Instance(tag, *instance,
-                                                       this->getOwner());
-    }
+    FlashMemory_Handler::setPersistentField_Reference(tag, ref,
+                                                      this->getOwner());
   } else {
 
 #ifdef JCVM_TYPED_HEAP
-    // TODO: the instance data value type should be saved.
+    if (ref.isArray() && !ref.isNullPointer()) {
+      this->setFieldType(index,
+                         this->getOwner().getArray(ref)->getFieldType());
+    } else {
+      this->setFieldType(index, FIELD_TYPE_OBJECT);
+    }
 #endif /* JCVM_TYPED_HEAP */
 
-    this->fields->at(index).value = (jword_t)(ref.compact());
+    this->fields.at(index) = (jword_t)(ref.compact());
+    this->markModified();
   }
 }
 
+#ifdef JCVM_TYPED_HEAP
+/**
+ * Set the type of an instance field.
+ *
+ * @param[index] index of the instance field.
+ * @param[type] new field type.
+ */
+void JC_Instance::setFieldType(const uint16_t index, const FieldType type) {
+  uint8_t &packed = this->field_types.at((uint16_t)(index / 2));
+  const uint8_t shift = (index % 2) ? 4 : 0;
+
+  packed = (uint8_t)((packed & ~(0x0F << shift)) |
+                     (packFieldType(type) << shift));
+}
+
+/**
+ * Get the type of an instance field.
+ *
+ * @param[index] index of the instance field.
+ * @return the field type, FIELD_TYPE_UNINITIALIZED if the field was never
+ * set.
+ */
+FieldType JC_Instance::getFieldType(const uint16_t index) const {
+  const uint8_t packed = this->field_types.at((uint16_t)(index / 2));
+  const uint8_t shift = (index % 2) ? 4 : 0;
+
+  return unpackFieldType((uint8_t)((packed >> shift) & 0x0F));
+}
+
+#endif /* JCVM_TYPED_HEAP */
+
 /**
  * Get the number of instance field.
  *
  * @return the number of instance field.
  */
-auto JC_Instance::getNumberOfFields() const noexcept
-    -> decltype(fields->size()) {
+auto JC_Instance::getNumberOfFields() const -> decltype(fields.size()) {
   if (this->isPersistent()) {
     Class_Handler class_handler(this->packageID);
     return class_handler.getInstanceFieldsSize(this->claz);
   } else {
-    return this->fields->size();
+    return this->fields.size();
   }
 }
 
@@ -372,11 +452,11 @@ auto JC_Instance::getNumberOfFields() const noexcept
  *
  * @return the number of instance field.
  */
-auto JC_Instance::getFields() const noexcept -> decltype(fields) {
+const JCVMArray<jword_t> *JC_Instance::getFields() const noexcept {
   if (this->isPersistent()) {
     throw Exceptions::NotYetImplemented;
   } else {
-    return this->fields;
+    return &this->fields;
   }
 }
 
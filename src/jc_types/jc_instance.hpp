@@ -51,20 +51,32 @@ private:
   /**
    * Instance fields' values. Each element are encoded on one words (SHORT
    * and REFERENCE). According to the specification, the INTEGER, are
-   * encoded on 2 words.
+   * encoded on 2 words. The field words are allocated in one block, the
+   * instance header is stored in place in the heap.
    */
-  JCVMArray<jc_field_t> *fields = nullptr; // instance_length-length array
+  JCVMArray<jword_t> fields; // instance_length-length array
+
+#ifdef JCVM_TYPED_HEAP
+  /// Instance fields' types, packed on 4 bits, two per byte.
+  JCVMArray<uint8_t> field_types; // (instance_length + 1) / 2-length array
+
+  /// Set the type of an instance field.
+  void setFieldType(const uint16_t index, const FieldType type);
+#endif /* JCVM_TYPED_HEAP */
 
   fs::Tag recomputeOriginalTag() const noexcept;
+  /// Get the tag of a persistent field to write.
+  fs::Tag getWrittenFieldTag(const uint16_t index);
 
 public:
   JC_Instance(Heap &owner, const Package &package_owner,
-              const jc_cp_offset_t instantiated_class) noexcept;
+              const jc_cp_offset_t instantiated_class);
   JC_Instance(Heap &owner, const jpackage_ID_t packageID,
-              const jclass_index_t claz_index) noexcept;
+              const jclass_index_t claz_index);
   JC_Instance(Heap &owner, const jpackage_ID_t packageID,
-              const jclass_index_t claz_index, const fs::Tag &tag) noexcept;
-  ~JC_Instance() noexcept;
+              const jclass_index_t claz_index, const fs::Tag &tag);
+  JC_Instance(JC_Instance &&instance) noexcept;
+  JC_Instance(const JC_Instance &) = delete;
 
   /// Get package ID
   jpackage_ID_t getPackageID() const noexcept;
@@ -98,9 +110,13 @@ public:
   void setField_Reference(uint16_t index, jref_t ref);
 
   ///  Get the number of instance field.
-  auto getNumberOfFields() const noexcept -> decltype(fields->size());
+  auto getNumberOfFields() const -> decltype(fields.size());
   /// Get fields arrays
-  auto getFields() const noexcept -> decltype(fields);
+  const JCVMArray<jword_t> *getFields() const noexcept;
+#ifdef JCVM_TYPED_HEAP
+  /// Get the type of an instance field.
+  FieldType getFieldType(const uint16_t index) const;
+#endif /* JCVM_TYPED_HEAP */
 };
 
 } // namespace jcvm
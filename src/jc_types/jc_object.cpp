@@ -54,4 +54,17 @@ void JC_Object::setPersistent(const bool persistant) noexcept {
  */
 Heap &JC_Object::getOwner() noexcept { return this->owner; }
 
+/*
+ * Get the number of modifications of a RAM object. A RAM object stored in
+ * the persistent memory is not stored again while its version is unchanged.
+ *
+ * @return the object version.
+ */
+uint32_t JC_Object::getVersion() const noexcept { return this->version; }
+
+/*
+ * Record a modification of a RAM object.
+ */
+void JC_Object::markModified() noexcept { this->version++; }
+
 } // namespace jcvm
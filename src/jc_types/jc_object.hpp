@@ -43,6 +43,8 @@ private:
   bool is_persistent;
   /// Is a static (aka in flash memory) object?
   bool is_static;
+  /// Number of modifications of a RAM object
+  uint32_t version = 0;
 
 public:
   /// Default constructor
@@ -56,6 +58,11 @@ public:
 
   /// Get heap owner.
   Heap &getOwner() noexcept;
+
+  /// Get the number of modifications of a RAM object
+  uint32_t getVersion() const noexcept;
+  /// Record a modification of a RAM object
+  void markModified() noexcept;
 };
 
 } // namespace jcvm
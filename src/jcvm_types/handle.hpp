@@ -0,0 +1,69 @@
+/*
+** The MIT License (MIT)
+**
+** Copyright (c) 2020, National Cybersecurity Agency of France (ANSSI)
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+** Author:
+**   - Guillaume Bouffard <guillaume.bouffard@ssi.gouv.fr>
+*/
+
+#ifndef _HANDLE_HPP
+#define _HANDLE_HPP
+
+#include "../jc_config.h"
+#include "../types.hpp"
+
+namespace jcvm {
+
+/*
+ * Non-owning handle to an object owned by a heap. Copying a handle costs a
+ * pointer copy. A handle stays valid until its object is reclaimed.
+ */
+template <class T> class Handle {
+private:
+  T *object;
+
+public:
+  /*
+   * Default constructor.
+   *
+   * @param[object] handled object.
+   */
+  Handle(T &object) noexcept : object(&object) {}
+
+  /*
+   * Access to the handled object members.
+   *
+   * @return pointer to the handled object.
+   */
+  T *operator->() const noexcept { return this->object; }
+
+  /*
+   * Access to the handled object.
+   *
+   * @return the handled object.
+   */
+  T &operator*() const noexcept { return *this->object; }
+};
+
+} // namespace jcvm
+
+#endif /* _HANDLE_HPP */
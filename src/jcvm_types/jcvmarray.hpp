@@ -29,8 +29,11 @@
 #define _JCVMARRAY_HPP
 
 #include "../jc_config.h"
+#include "../slab_allocator.hpp"
 #include "../types.hpp"
 
+#include <memory>
+
 #ifdef JCVM_ARRAY_SIZE_CHECK
 #include "../exceptions.hpp"
 #endif /* JCVM_ARRAY_SIZE_CHECK */
@@ -43,18 +46,33 @@ private:
   bool allocated_data;
   T *array;
 
+  /*
+   * Give back the allocated data to the slab allocator.
+   */
+  void release() noexcept {
+    if (this->allocated_data) {
+      std::destroy_n(this->array, this->length);
+      Slab_Allocator::deallocate(
+          const_cast<void *>(static_cast<const void *>(this->array)),
+          this->length * sizeof(T));
+    }
+  }
+
 public:
   /*
-   * Default class constructor.
+   * Default class constructor. The data is allocated from the slab
+   * allocator.
    */
-  JCVMArray(const uint16_t length) noexcept {
+  JCVMArray(const uint16_t length) {
     this->length = length;
+    this->array = nullptr;
+    this->allocated_data = false;
 
     if (this->length > 0) {
-      this->array = new T[length]{};
+      this->array = static_cast<T *>(
+          Slab_Allocator::allocate(this->length * sizeof(T)));
+      std::uninitialized_value_construct_n(this->array, this->length);
       this->allocated_data = true;
-    } else {
-      this->allocated_data = false;
     }
   }
 
@@ -65,14 +83,48 @@ public:
   }
 
   /*
-   * Default class destructor.
+   * Move constructor. The moved array loses its data.
+   *
+   * @param[other] array to move.
    */
-  ~JCVMArray() noexcept {
-    if (this->allocated_data) {
-      delete[] this->array;
+  JCVMArray(JCVMArray &&other) noexcept
+      : length(other.length), allocated_data(other.allocated_data),
+        array(other.array) {
+    other.length = 0;
+    other.allocated_data = false;
+    other.array = nullptr;
+  }
+
+  /*
+   * Move assignment. The moved array loses its data.
+   *
+   * @param[other] array to move.
+   * @return this array.
+   */
+  JCVMArray &operator=(JCVMArray &&other) noexcept {
+    if (this != &other) {
+      this->release();
+
+      this->length = other.length;
+      this->allocated_data = other.allocated_data;
+      this->array = other.array;
+
+      other.length = 0;
+      other.allocated_data = false;
+      other.array = nullptr;
     }
+
+    return *this;
   }
 
+  JCVMArray(const JCVMArray &) = delete;
+  JCVMArray &operator=(const JCVMArray &) = delete;
+
+  /*
+   * Default class destructor.
+   */
+  ~JCVMArray() noexcept { this->release(); }
+
   /*
    * Access specified element with bounds checking.
    *
@@ -173,7 +225,7 @@ public:
     T *word = this->array;
 
     for (int index = 0; index < this->size(); ++index) {
-      *word = value;
+      *word++ = value;
     }
   }
 };
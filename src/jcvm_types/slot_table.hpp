@@ -0,0 +1,165 @@
+/*
+** The MIT License (MIT)
+**
+** Copyright (c) 2020, National Cybersecurity Agency of France (ANSSI)
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+** Author:
+**   - Guillaume Bouffard <guillaume.bouffard@ssi.gouv.fr>
+*/
+
+#ifndef _SLOT_TABLE_HPP
+#define _SLOT_TABLE_HPP
+
+#include "../exceptions.hpp"
+#include "../jc_config.h"
+#include "../types.hpp"
+
+#include <deque>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace jcvm {
+
+/// Maximal handle value (a Java Card reference offset is a 15-bit value).
+#define SLOT_TABLE_MAX_HANDLE (uint16_t)0x7FFF
+
+/*
+ * Table of elements accessed through 1-based handles in constant time.
+ * Elements are stored in place and are never moved: a reference to an
+ * element stays valid until the element is removed. Removed slots are
+ * reused by the next additions.
+ */
+template <class T> class SlotTable {
+private:
+  /// Slot element, empty when the slot is free.
+  using Slot = std::optional<T>;
+
+  /// Slots, indexed by handle - 1.
+  std::deque<Slot> slots;
+  /// Handles of the free slots.
+  std::vector<uint16_t> free_handles;
+
+public:
+  /*
+   * Construct an element in place in the table.
+   *
+   * @param[args] arguments forwarded to the element constructor.
+   * @return the handle to the added element.
+   */
+  template <class... Args> uint16_t emplace(Args &&...args) {
+    uint16_t handle;
+
+    if (this->free_handles.empty()) {
+      if (this->slots.size() >= SLOT_TABLE_MAX_HANDLE) {
+        throw Exceptions::FullMemoryException;
+      }
+
+      this->slots.emplace_back(std::in_place, std::forward<Args>(args)...);
+      handle = static_cast<uint16_t>(this->slots.size());
+    } else {
+      handle = this->free_handles.back();
+
+      this->slots[handle - 1].emplace(std::forward<Args>(args)...);
+      this->free_handles.pop_back();
+    }
+
+    return handle;
+  }
+
+  /*
+   * Add an element in the table.
+   *
+   * @param[value] element to add.
+   * @return the handle to the added element.
+   */
+  uint16_t add(T value) { return this->emplace(std::move(value)); }
+
+  /*
+   * Remove an element from the table. Its slot will be reused.
+   *
+   * @param[handle] handle to the element to remove.
+   */
+  void remove(const uint16_t handle) {
+    if (!this->contains(handle)) {
+      throw Exceptions::SecurityException;
+    }
+
+    this->slots[handle - 1].reset();
+    this->free_handles.push_back(handle);
+  }
+
+  /*
+   * Is a handle associated to an element?
+   *
+   * @param[handle] handle to check.
+   * @return true if the handle is associated to an element.
+   */
+  bool contains(const uint16_t handle) const noexcept {
+    return (handle > 0) && (handle <= this->slots.size()) &&
+           this->slots[handle - 1].has_value();
+  }
+
+  /*
+   * Access specified element with bounds checking.
+   *
+   * @param[handle] handle to the element.
+   * @return the element.
+   */
+  T &at(const uint16_t handle)
+#ifndef JCVM_ARRAY_SIZE_CHECK
+      noexcept
+#endif /* JCVM_ARRAY_SIZE_CHECK */
+  {
+#ifdef JCVM_ARRAY_SIZE_CHECK
+
+    if (!this->contains(handle)) {
+      throw Exceptions::IndexOutOfBoundsException;
+    }
+
+#endif /* JCVM_ARRAY_SIZE_CHECK */
+
+    return *this->slots[handle - 1];
+  }
+
+  /*
+   * Get the number of elements in the table.
+   *
+   * @return the number of elements.
+   */
+  uint16_t size() const noexcept {
+    return static_cast<uint16_t>(this->slots.size() -
+                                 this->free_handles.size());
+  }
+
+  /*
+   * Get the highest handle value ever given by the table.
+   *
+   * @return the highest handle value.
+   */
+  uint16_t capacity() const noexcept {
+    return static_cast<uint16_t>(this->slots.size());
+  }
+};
+
+} // namespace jcvm
+
+#endif /* _SLOT_TABLE_HPP */
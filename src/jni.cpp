@@ -27,12 +27,209 @@
 
 #include "context.hpp"
 #include "exceptions.hpp"
+#include "jc_handlers/flashmemory.hpp"
 #include "jc_types/jc_array.hpp"
 #include "jc_types/jc_array_type.hpp"
 #include "jc_types/jref_t.hpp"
+#include "transient_memory.hpp"
 #include "types.hpp"
 
+#include <vector>
+
 namespace jcvm {
+
+/**
+ * Create a transient array in the running context heap.
+ *
+ * @param[length] array length.
+ * @param[event] event clearing the array data.
+ * @param[type] array type.
+ *
+ * @return the created array.
+ */
+static Handle<JC_Array> makeTransientArray(const jshort_t length,
+                                           const jbyte_t event,
+                                           const jc_array_type type) {
+  if (length < 0) {
+    throw Exceptions::NegativeArraySizeException;
+  }
+
+  if (!Transient_Memory::isClearEvent((uint8_t)event)) {
+    throw Exceptions::SystemException;
+  }
+
+  Context &context = Context::getRunningContext();
+  Heap &heap = context.getHeap();
+
+  context.collectGarbageIfRequired();
+
+  jref_t array_ref;
+
+  if (type == jc_array_type::JAVA_ARRAY_T_REFERENCE) {
+    array_ref = heap.addArray(JC_Array(heap, length, type, 0xFFFF, true,
+                                       static_cast<ClearEvent>(event)));
+  } else {
+    array_ref = heap.addArray(
+        JC_Array(heap, length, type, true, static_cast<ClearEvent>(event)));
+  }
+
+  return heap.getArray(array_ref);
+}
+
+/*
+ * Leave the persistent writes out of the transaction in progress while the
+ * guard is alive. The writes are atomic again when the guard is destroyed,
+ * even if the non-atomic write throws.
+ */
+class NonAtomic_Writes {
+public:
+  NonAtomic_Writes() noexcept { FlashMemory_Handler::setNonAtomicWrites(true); }
+  ~NonAtomic_Writes() noexcept {
+    FlashMemory_Handler::setNonAtomicWrites(false);
+  }
+
+  NonAtomic_Writes(const NonAtomic_Writes &) = delete;
+  NonAtomic_Writes &operator=(const NonAtomic_Writes &) = delete;
+};
+
+/**
+ * Get a primitive array element, as an unsigned value.
+ *
+ * @param[array] primitive array.
+ * @param[index] element index.
+ *
+ * @return the element value.
+ */
+static uint32_t getPrimitiveEntry(JC_Array &array, const uint16_t index) {
+  switch (array.getType()) {
+  case jc_array_type::JAVA_ARRAY_T_BOOLEAN:
+  case jc_array_type::JAVA_ARRAY_T_BYTE:
+    return (uint8_t)array.getByteEntry(index);
+
+  case jc_array_type::JAVA_ARRAY_T_SHORT:
+    return (uint16_t)array.getShortEntry(index);
+
+#ifdef JCVM_INT_SUPPORTED
+  case jc_array_type::JAVA_ARRAY_T_INT:
+    return (uint32_t)array.getIntEntry(index);
+#endif /* JCVM_INT_SUPPORTED */
+
+  default:
+    throw Exceptions::UtilException;
+  }
+}
+
+/**
+ * Set a primitive array element from an unsigned value.
+ *
+ * @param[array] primitive array.
+ * @param[index] element index.
+ * @param[value] element value.
+ */
+static void setPrimitiveEntry(JC_Array &array, const uint16_t index,
+                              const uint32_t value) {
+  switch (array.getType()) {
+  case jc_array_type::JAVA_ARRAY_T_BOOLEAN:
+  case jc_array_type::JAVA_ARRAY_T_BYTE:
+    array.setByteEntry(index, (jbyte_t)value);
+    break;
+
+  case jc_array_type::JAVA_ARRAY_T_SHORT:
+    array.setShortEntry(index, (jshort_t)value);
+    break;
+
+#ifdef JCVM_INT_SUPPORTED
+  case jc_array_type::JAVA_ARRAY_T_INT:
+    array.setIntEntry(index, (jint_t)value);
+    break;
+#endif /* JCVM_INT_SUPPORTED */
+
+  default:
+    throw Exceptions::UtilException;
+  }
+}
+
+/**
+ * Copy the elements of a primitive array into another primitive array,
+ * repacking them when the element sizes differ. The source elements are
+ * read as big-endian bytes, which are packed into the destination
+ * elements. Overlapping copies behave as if the source elements were first
+ * copied into a temporary buffer.
+ *
+ * @param[src] source array.
+ * @param[srcOff] offset of the first source element.
+ * @param[srcLen] number of source elements.
+ * @param[dest] destination array.
+ * @param[destOff] offset of the first destination element.
+ *
+ * @return destOff plus the number of destination elements written.
+ */
+static jshort_t arrayCopyRepack(const jref_t src, const jshort_t srcOff,
+                                const jshort_t srcLen, const jref_t dest,
+                                const jshort_t destOff) {
+  if (src.isNullPointer() || dest.isNullPointer()) {
+    throw Exceptions::NullPointerException;
+  }
+
+  if (!src.isArray() || !dest.isArray()) {
+    throw Exceptions::UtilException;
+  }
+
+  Heap &heap = Context::getRunningContext().getHeap();
+  auto src_array = heap.getArray(src);
+  auto dest_array = heap.getArray(dest);
+
+  if ((src_array->getType() == jc_array_type::JAVA_ARRAY_T_REFERENCE) ||
+      (dest_array->getType() == jc_array_type::JAVA_ARRAY_T_REFERENCE)) {
+    throw Exceptions::UtilException;
+  }
+
+  if ((srcOff < 0) || (srcLen < 0) || (destOff < 0) ||
+      ((uint32_t)srcOff + (uint32_t)srcLen > src_array->size())) {
+    throw Exceptions::ArrayIndexOutOfBoundsException;
+  }
+
+  const uint16_t src_entry_size = src_array->getEntrySize();
+  const uint16_t dest_entry_size = dest_array->getEntrySize();
+  const uint32_t nb_bytes = (uint32_t)srcLen * src_entry_size;
+
+  if ((nb_bytes % dest_entry_size) != 0) {
+    throw Exceptions::UtilException;
+  }
+
+  const uint32_t destLen = nb_bytes / dest_entry_size;
+
+  if ((uint32_t)destOff + destLen > dest_array->size()) {
+    throw Exceptions::ArrayIndexOutOfBoundsException;
+  }
+
+  std::vector<uint8_t> data;
+  data.reserve(nb_bytes);
+
+  for (uint16_t index = 0; index < srcLen; index++) {
+    const uint32_t value =
+        getPrimitiveEntry(*src_array, (uint16_t)(srcOff + index));
+
+    for (uint16_t byte = src_entry_size; byte > 0; byte--) {
+      data.push_back((uint8_t)(value >> (8 * (byte - 1))));
+    }
+  }
+
+  auto it = data.cbegin();
+
+  for (uint16_t index = 0; index < destLen; index++) {
+    uint32_t value = 0;
+
+    for (uint16_t byte = 0; byte < dest_entry_size; byte++) {
+      value = (value << 8) | *it++;
+    }
+
+    setPrimitiveEntry(*dest_array, (uint16_t)(destOff + index), value);
+  }
+
+  return (jshort_t)(destOff + destLen);
+}
+
 jshort_t fr_gouv_ssi_nativeimpl_NativeImplementation_arrayCopyRepack(
     jref_t, jshort_t, jshort_t, jref_t, jshort_t) {
   // TODO: to implement;
@@ -40,9 +237,11 @@ jshort_t fr_gouv_ssi_nativeimpl_NativeImplementation_arrayCopyRepack(
 };
 
 jshort_t fr_gouv_ssi_nativeimpl_NativeImplementation_arrayCopyRepackNonAtomic(
-    jref_t, jshort_t, jshort_t, jref_t, jshort_t) {
-  // TODO: to implement;
-  throw Exceptions::NotYetImplemented;
+    jref_t src, jshort_t srcOff, jshort_t srcLen, jref_t dest,
+    jshort_t destOff) {
+  NonAtomic_Writes nonAtomicWrites;
+
+  return arrayCopyRepack(src, srcOff, srcLen, dest, destOff);
 }
 
 jshort_t fr_gouv_ssi_nativeimpl_NativeImplementation_arrayFillGeneric(
@@ -64,7 +263,7 @@ jbyte_t fr_gouv_ssi_nativeimpl_NativeImplementation_arrayCompareGeneric(
 }
 
 jshort_t fr_gouv_ssi_nativeimpl_NativeImplementation_arrayFindGeneric(
-    jref_t, jshort_t, std::shared_ptr<JC_Array>, jbyte_t, jshort_t) {
+    jref_t, jshort_t, Handle<JC_Array>, jbyte_t, jshort_t) {
   // TODO: to implement;
   throw Exceptions::NotYetImplemented;
 }
@@ -74,37 +273,42 @@ jbool_t fr_gouv_ssi_nativeimpl_NativeImplementation_selectingApplet() {
   throw Exceptions::NotYetImplemented;
 }
 
-jbyte_t fr_gouv_ssi_nativeimpl_NativeImplementation_isTransient(jref_t) {
-  // TODO: to implement;
-  throw Exceptions::NotYetImplemented;
+jbyte_t
+fr_gouv_ssi_nativeimpl_NativeImplementation_isTransient(jref_t objectref) {
+  if (!objectref.isNullPointer() && objectref.isArray()) {
+    auto array = Context::getRunningContext().getHeap().getArray(objectref);
+
+    if (array->isTransientArray()) {
+      return array->getClearEvent();
+    }
+  }
+
+  return 0; // NOT_A_TRANSIENT_OBJECT
 }
 
-std::shared_ptr<JC_Array>
-fr_gouv_ssi_nativeimpl_NativeImplementation_makeTransientBooleanArray(jshort_t,
-                                                                      jbyte_t) {
-  // TODO: to implement;
-  throw Exceptions::NotYetImplemented;
+Handle<JC_Array>
+fr_gouv_ssi_nativeimpl_NativeImplementation_makeTransientBooleanArray(
+    jshort_t length, jbyte_t event) {
+  return makeTransientArray(length, event, jc_array_type::JAVA_ARRAY_T_BOOLEAN);
 }
 
-std::shared_ptr<JC_Array>
-fr_gouv_ssi_nativeimpl_NativeImplementation_makeTransientByteArray(jshort_t,
-                                                                   jbyte_t) {
-  // TODO: to implement;
-  throw Exceptions::NotYetImplemented;
+Handle<JC_Array>
+fr_gouv_ssi_nativeimpl_NativeImplementation_makeTransientByteArray(
+    jshort_t length, jbyte_t event) {
+  return makeTransientArray(length, event, jc_array_type::JAVA_ARRAY_T_BYTE);
 }
 
-std::shared_ptr<JC_Array>
-fr_gouv_ssi_nativeimpl_NativeImplementation_makeTransientShortArray(jshort_t,
-                                                                    jbyte_t) {
-  // TODO: to implement;
-  throw Exceptions::NotYetImplemented;
+Handle<JC_Array>
+fr_gouv_ssi_nativeimpl_NativeImplementation_makeTransientShortArray(
+    jshort_t length, jbyte_t event) {
+  return makeTransientArray(length, event, jc_array_type::JAVA_ARRAY_T_SHORT);
 }
 
-std::shared_ptr<JC_Array>
-fr_gouv_ssi_nativeimpl_NativeImplementation_makeTransientObjectArray(jshort_t,
-                                                                     jbyte_t) {
-  // TODO: to implement;
-  throw Exceptions::NotYetImplemented;
+Handle<JC_Array>
+fr_gouv_ssi_nativeimpl_NativeImplementation_makeTransientObjectArray(
+    jshort_t length, jbyte_t event) {
+  return makeTransientArray(length, event,
+                            jc_array_type::JAVA_ARRAY_T_REFERENCE);
 }
 
 jref_t fr_gouv_ssi_nativeimpl_NativeImplementation_makeGlobalArray(jbyte_t,
@@ -119,33 +323,28 @@ jref_t fr_gouv_ssi_nativeimpl_NativeImplementation_getAID() {
 }
 
 void fr_gouv_ssi_nativeimpl_NativeImplementation_beginTransaction() {
-  // TODO: to implement;
-  throw Exceptions::NotYetImplemented;
+  FlashMemory_Handler::beginTransaction();
 }
 
 void fr_gouv_ssi_nativeimpl_NativeImplementation_abortTransaction() {
-  // TODO: to implement;
-  throw Exceptions::NotYetImplemented;
+  FlashMemory_Handler::abortTransaction(
+      Context::getRunningContext().getHeap());
 }
 
 void fr_gouv_ssi_nativeimpl_NativeImplementation_commitTransaction() {
-  // TODO: to implement;
-  throw Exceptions::NotYetImplemented;
+  FlashMemory_Handler::commitTransaction();
 }
 
 jbyte_t fr_gouv_ssi_nativeimpl_NativeImplementation_getTransactionDepth() {
-  // TODO: to implement;
-  throw Exceptions::NotYetImplemented;
+  return FlashMemory_Handler::getTransactionDepth();
 }
 
 jshort_t fr_gouv_ssi_nativeimpl_NativeImplementation_getUnusedCommitCapacity() {
-  // TODO: to implement;
-  throw Exceptions::NotYetImplemented;
+  return FlashMemory_Handler::getUnusedCommitCapacity();
 }
 
 jshort_t fr_gouv_ssi_nativeimpl_NativeImplementation_getMaxCommitCapacity() {
-  // TODO: to implement;
-  throw Exceptions::NotYetImplemented;
+  return FlashMemory_Handler::getMaxCommitCapacity();
 }
 
 jref_t fr_gouv_ssi_nativeimpl_NativeImplementation_getPreviousContextAID() {
@@ -160,7 +359,7 @@ fr_gouv_ssi_nativeimpl_NativeImplementation_getAvailableMemory(jbyte_t) {
 }
 
 void fr_gouv_ssi_nativeimpl_NativeImplementation_getAvailableMemory(
-    std::shared_ptr<JC_Array>, jshort_t, jshort_t, jbyte_t) {
+    Handle<JC_Array>, jshort_t, jshort_t, jbyte_t) {
   // TODO: to implement;
   throw Exceptions::NotYetImplemented;
 }
@@ -174,13 +373,11 @@ fr_gouv_ssi_nativeimpl_NativeImplementation_getAppletShareableInterfaceObject(
 
 jbool_t
 fr_gouv_ssi_nativeimpl_NativeImplementation_isObjectDeletionSupported() {
-  // TODO: to implement;
-  throw Exceptions::NotYetImplemented;
+  return TRUE;
 }
 
 void fr_gouv_ssi_nativeimpl_NativeImplementation_requestObjectDeletion() {
-  // TODO: to implement;
-  throw Exceptions::NotYetImplemented;
+  Context::getRunningContext().collectGarbage();
 }
 
 jbyte_t fr_gouv_ssi_nativeimpl_NativeImplementation_getAssignedChannel() {
@@ -221,11 +418,14 @@ jshort_t fr_gouv_ssi_nativeimpl_NativeImplementation_clearArray(jref_t) {
   throw Exceptions::NotYetImplemented;
 }
 
-std::shared_ptr<JC_Array>
-fr_gouv_ssi_nativeimpl_NativeImplementation_makeTransientIntArray(jshort_t,
-                                                                  jbyte_t) {
-  // TODO: to implement;
-  throw Exceptions::NotYetImplemented;
+Handle<JC_Array>
+fr_gouv_ssi_nativeimpl_NativeImplementation_makeTransientIntArray(
+    jshort_t length, jbyte_t event) {
+#ifdef JCVM_INT_SUPPORTED
+  return makeTransientArray(length, event, jc_array_type::JAVA_ARRAY_T_INT);
+#else
+  throw Exceptions::SecurityException;
+#endif /* JCVM_INT_SUPPORTED */
 }
 
 } // namespace jcvm
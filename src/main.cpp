@@ -25,12 +25,20 @@
 **   - Guillaume Bouffard <guillaume.bouffard@ssi.gouv.fr>
 */
 
+#include "context.hpp"
 #include "debug.hpp"
 #include "interpretor.hpp"
 #include "jc_config.h"
+#include "transient_memory.hpp"
 #include "types.hpp"
 
 #include "jc_handlers/flashmemory.hpp"
+#include "jc_handlers/flashmemory_cache.hpp"
+
+#ifdef JCVM_NATIVE_FS
+#include "jc_handlers/native_fs.hpp"
+#include "jc_handlers/package_registry.hpp"
+#endif /* JCVM_NATIVE_FS */
 
 #ifdef PC_VERSION
 extern int main_pc(int argc, char *argv[]);
@@ -65,7 +73,33 @@ void runtime(uint8_t id_package, uint8_t id_class, uint8_t id_method) {
   jcvm::Interpretor interpretor(id_applet,
                                 static_cast<jcvm::jpackage_ID_t>(id_package),
                                 id_class, id_method, true);
+
+  // The applet is selected for the method execution and deselected after.
+  jcvm::Transient_Memory::clear(jcvm::ClearEvent::CLEAR_ON_SELECT);
   interpretor.run();
+  jcvm::Transient_Memory::clear(jcvm::ClearEvent::CLEAR_ON_DESELECT);
+
+  // A transaction left in progress is aborted, and the pending persistent
+  // writes are written back once the command ends.
+  try {
+    if (jcvm::FlashMemory_Handler::getTransactionDepth() > 0) {
+      jcvm::FlashMemory_Handler::abortTransaction(
+          jcvm::Context::getRunningContext().getHeap());
+    }
+
+    jcvm::FlashMemory_Cache::flush();
+  } catch (jcvm::Exceptions e) {
+    TRACE_JCVM_ERR("Unable to write back the persistent fields");
+  }
+
+#ifdef JCVM_NATIVE_FS
+  // The compaction moves the CAP files: the resolved ones are outdated, and
+  // the flash memory file is compared to find the moved records.
+  if (jcvm::Native_FS::compactIfRequired()) {
+    jcvm::Package_Registry::invalidateAll();
+    jcvm::FlashMemory_Cache::markMoved();
+  }
+#endif /* JCVM_NATIVE_FS */
 }
 
 #ifdef __cplusplus
@@ -40,17 +40,190 @@
 #endif /* DEBUG */
 
 #include "jc_handlers/flashmemory.hpp"
+#include "jc_handlers/flashmemory_cache.hpp"
+#include "jc_handlers/native_fs.hpp"
 #include <algorithm>
 #include <boost/program_options.hpp>
-#include <fstream>
-#include <iterator>
+#include <cstring>
+#include <fcntl.h>
 #include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <vector>
 
+#ifdef JCVM_NATIVE_FS
+/// Remote calls handled by the in-tree emulator
+#define REMOTE_CALL_JCRE 0
+#define REMOTE_CALL_RUNTIME 2
+#endif /* JCVM_NATIVE_FS */
+
 bool isSaving = false;
 uint8_t *flash = nullptr;
 uint32_t flash_length = 0;
 std::string flash_filename;
+#ifndef JCVM_NATIVE_FS
+std::string native_filename;
+#endif /* !JCVM_NATIVE_FS */
+
+/// Flash memory file descriptor.
+static int flash_fd = -1;
+/// Flash memory file content, mapped at load time.
+static const uint8_t *flash_image = nullptr;
+/// Flash memory file length.
+static size_t flash_image_length = 0;
+/// Flash memory length mapped from the file.
+static size_t flash_mapped_length = 0;
+
+/**
+ * Map the whole pages of the flash memory file over the flash memory, copied
+ * on write, so that only the pages read by the commands are loaded. The last
+ * bytes of the file, or the whole file if the flash memory is not page
+ * aligned, are copied.
+ */
+static void mapFlashImage() {
+  const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+  if ((reinterpret_cast<uintptr_t>(flash) % page_size) == 0) {
+    const size_t mapped_length =
+        flash_image_length - (flash_image_length % page_size);
+
+    if ((mapped_length > 0) &&
+        (mmap(flash, mapped_length, PROT_READ | PROT_WRITE,
+              MAP_PRIVATE | MAP_FIXED, flash_fd, 0) != MAP_FAILED)) {
+      flash_mapped_length = mapped_length;
+    }
+  }
+
+  std::memcpy(flash + flash_mapped_length, flash_image + flash_mapped_length,
+              flash_image_length - flash_mapped_length);
+}
+
+/**
+ * Load the flash memory file. The file is mapped in memory, to compare it
+ * with the saved flash memory, and mapped over the flash memory.
+ *
+ * @return true if the flash memory file is loaded.
+ */
+static bool loadFlashImage() {
+  struct stat file_stat;
+
+  flash_fd = open(flash_filename.c_str(), isSaving ? O_RDWR : O_RDONLY);
+
+  if ((flash_fd < 0) || (fstat(flash_fd, &file_stat) != 0)) {
+    return false;
+  }
+
+  flash_image_length = static_cast<size_t>(file_stat.st_size);
+  flash = flash_pointer();
+
+#ifdef JCVM_NATIVE_FS
+  if (flash_image_length > JCVM_NATIVE_FS_SIZE) {
+    return false;
+  }
+#endif /* JCVM_NATIVE_FS */
+
+  if (flash_image_length > 0) {
+    void *image = mmap(nullptr, flash_image_length, PROT_READ, MAP_PRIVATE,
+                       flash_fd, 0);
+
+    if (image == MAP_FAILED) {
+      return false;
+    }
+
+    flash_image = static_cast<const uint8_t *>(image);
+    mapFlashImage();
+  }
+
+  flash_length = static_cast<uint32_t>(flash_image_length);
+
+  return true;
+}
+
+/**
+ * Save the flash memory in its file. Only the chunks modified by the writes
+ * to the file system are written. When data of the file system were moved,
+ * the chunks which differ from the loaded file are written instead.
+ *
+ * The flash memory pages mapped beyond a shrunk file are replaced by
+ * anonymous pages before the file is truncated, since they would no longer
+ * be backed.
+ *
+ * @return true if the flash memory file is saved.
+ */
+static bool saveFlashImage() {
+  const bool isCompared = jcvm::FlashMemory_Cache::isMoved();
+
+  for (uint32_t offset = 0; offset < flash_length;
+       offset += FS_CACHE_MODIFIED_CHUNK_SIZE) {
+    const uint32_t chunk_length =
+        std::min(FS_CACHE_MODIFIED_CHUNK_SIZE, flash_length - offset);
+
+    if (isCompared
+            ? (((offset + chunk_length) <= flash_image_length) &&
+               (std::memcmp(flash + offset, flash_image + offset,
+                            chunk_length) == 0))
+            : !jcvm::FlashMemory_Cache::isModified(offset)) {
+      continue;
+    }
+
+    if (pwrite(flash_fd, flash + offset, chunk_length, offset) !=
+        static_cast<ssize_t>(chunk_length)) {
+      return false;
+    }
+  }
+
+  if (flash_length < flash_image_length) {
+    const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t unbacked_offset =
+        ((flash_length + page_size - 1) / page_size) * page_size;
+
+    if ((unbacked_offset < flash_mapped_length) &&
+        (mmap(flash + unbacked_offset, flash_mapped_length - unbacked_offset,
+              PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED | MAP_ANONYMOUS,
+              -1, 0) == MAP_FAILED)) {
+      return false;
+    }
+
+    if (ftruncate(flash_fd, flash_length) != 0) {
+      return false;
+    }
+  }
+
+  return fsync(flash_fd) == 0;
+}
+
+#ifndef JCVM_NATIVE_FS
+
+/**
+ * Convert the loaded flash memory to the in-tree file system format, used by
+ * the builds without the Java Card OS (see CHOUPI_NATIVE_FS build option).
+ *
+ * @return true if the converted flash memory file is written.
+ */
+static bool convertFlashImage() {
+  uint32_t native_length = 0;
+
+  if ((fs_init() != 0) || !jcvm::Native_FS::load(native_length) ||
+      !jcvm::Native_FS::import()) {
+    return false;
+  }
+
+  const int native_fd =
+      open(native_filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+  if (native_fd < 0) {
+    return false;
+  }
+
+  const bool isWritten =
+      write(native_fd, jcvm::Native_FS::getMemory(), native_length) ==
+      static_cast<ssize_t>(native_length);
+
+  return (close(native_fd) == 0) && isWritten;
+}
+
+#endif /* !JCVM_NATIVE_FS */
 
 int main_pc(int argc, char *argv[]) {
 
@@ -66,6 +239,13 @@ int main_pc(int argc, char *argv[]) {
                ->required()
                ->value_name("MEMORY_FILENAME"),
            "Flash Memory")("save,s", "Save modifications on MEMORY_FILENAME");
+#ifndef JCVM_NATIVE_FS
+  desc.add_options()(
+      "convert,c",
+      boost::program_options::value<std::string>(&native_filename)
+          ->value_name("NATIVE_FILENAME"),
+      "Convert MEMORY_FILENAME for the in-tree file system");
+#endif /* !JCVM_NATIVE_FS */
 
   boost::program_options::variables_map parameters;
 
@@ -127,27 +307,29 @@ int main_pc(int argc, char *argv[]) {
             << std::endl;
 #endif /* DEBUG */
 
-  auto file_memory_in = std::ifstream(flash_filename, std::ifstream::binary);
-  flash = flash_pointer();
-
-  if (file_memory_in.is_open()) {
-    uint8_t *last = std::copy(std::istreambuf_iterator<char>(file_memory_in),
-                              std::istreambuf_iterator<char>(), flash);
-    flash_length = (last - flash);
+  isSaving = parameters.count("save");
 
+  if (!loadFlashImage()) {
 #ifdef DEBUG
-    TRACE_JCVM_ERR("Flash length = %u Byte", flash_length);
-#endif /* DEBUG */
-  } else {
-#ifdef DEBUG
-    TRACE_JCVM_ERR("ERROR: Unable to open %s", flash_filename);
+    TRACE_JCVM_ERR("ERROR: Unable to open %s", flash_filename.c_str());
 #endif /* DEBUG */
     return EXIT_FAILURE;
   }
 
-  file_memory_in.close();
+#ifdef DEBUG
+  TRACE_JCVM_ERR("Flash length = %u Byte", flash_length);
+#endif /* DEBUG */
+
+#ifndef JCVM_NATIVE_FS
+  if (parameters.count("convert")) {
+    if (!convertFlashImage()) {
+      TRACE_JCVM_ERR("ERROR: Unable to convert %s", flash_filename.c_str());
+      return EXIT_FAILURE;
+    }
 
-  isSaving = parameters.count("save");
+    return EXIT_SUCCESS;
+  }
+#endif /* !JCVM_NATIVE_FS */
 
   // running emulator
   run_emulator();
@@ -172,15 +354,52 @@ int starting_jcre() {
   if (isSaving) {
     TRACE_JCVM_DEBUG("Saving memory in FLASH_MEMORY file");
 
-    auto flash_memory_out =
-        std::ofstream(flash_filename, std::ofstream::binary);
-    std::ostream_iterator<char> output(flash_memory_out);
-    std::copy(flash, flash + flash_length, output);
-    flash_memory_out.close();
+    if (!saveFlashImage()) {
+      TRACE_JCVM_ERR("ERROR: Unable to save %s", flash_filename.c_str());
+    }
   }
 
   return 0;
 }
+
+#ifdef JCVM_NATIVE_FS
+
+/*
+ * Start the Java Card Runtime Environment. Unlike the Java Card OS one, the
+ * in-tree emulator runs the JCRE in the process, without MPU emulation.
+ */
+void run_emulator() {
+  if (fs_init() != 0) {
+    TRACE_JCVM_ERR("FAILED TO INITIALIZE FS DRIVER");
+    return;
+  }
+
+  remote_call(REMOTE_CALL_JCRE, 0, 0);
+}
+
+/*
+ * Call the JCRE, or a Java Card method encoded as
+ * (package << 16) | (class << 8) | method.
+ */
+void remote_call(int call, uint32_t arg1, uint32_t) {
+  switch (call) {
+  case REMOTE_CALL_JCRE:
+    starting_jcre();
+    break;
+
+  case REMOTE_CALL_RUNTIME:
+    runtime(static_cast<uint8_t>(arg1 >> 16), static_cast<uint8_t>(arg1 >> 8),
+            static_cast<uint8_t>(arg1));
+    break;
+
+  default:
+    TRACE_JCVM_ERR("Unknown remote call %d", call);
+    break;
+  }
+}
+
+#endif /* JCVM_NATIVE_FS */
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,107 @@
+/*
+** The MIT License (MIT)
+**
+** Copyright (c) 2020, National Cybersecurity Agency of France (ANSSI)
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+** Author:
+**   - Guillaume Bouffard <guillaume.bouffard@ssi.gouv.fr>
+*/
+
+
+#ifndef _NATIVE_OS_FFI_H
+#define _NATIVE_OS_FFI_H
+
+/*
+ * Java Card OS interface used by the JCVM, implemented in-tree when the
+ * Java Card OS is not linked (JCVM_NATIVE_FS builds, see the
+ * CHOUPI_NATIVE_FS build option):
+ * - the file system and the tag builders by jc_handlers/native_fs.cpp,
+ * - the emulator entry points by main_pc.cpp.
+ * The JCVM entry points called by the emulator are declared as well.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Load the file system
+int fs_init();
+/// Get the flash memory
+uint8_t *flash_pointer();
+/// Print the file system statistics
+void fs_dump();
+
+/// Get the length of a tag data
+int fs_length(const uint8_t *tag, uint8_t len, uint32_t *length);
+/// Read a tag data
+int fs_read(const uint8_t *tag, uint8_t len, uint8_t *data, uint32_t length);
+/// Read a tag data in place
+int fs_read_inplace(const uint8_t *tag, uint8_t len, const uint8_t **data,
+                    uint32_t *length);
+/// Write a tag data
+int fs_write(const uint8_t *tag, uint8_t len, const uint8_t *data,
+             uint32_t length);
+/// Read a 1-byte element of a tag data
+int fs_read_1b_at(const uint8_t *tag, uint8_t len, uint32_t index,
+                  uint8_t *v);
+/// Read a 2-byte element of a tag data
+int fs_read_2b_at(const uint8_t *tag, uint8_t len, uint32_t index,
+                  uint16_t *v);
+/// Read a 4-byte element of a tag data
+int fs_read_4b_at(const uint8_t *tag, uint8_t len, uint32_t index,
+                  uint32_t *v);
+/// Write a 1-byte element of a tag data
+int fs_write_1b_at(const uint8_t *tag, uint8_t len, uint32_t index,
+                   uint8_t v);
+/// Write a 2-byte element of a tag data
+int fs_write_2b_at(const uint8_t *tag, uint8_t len, uint32_t index,
+                   uint16_t v);
+/// Write a 4-byte element of a tag data
+int fs_write_4b_at(const uint8_t *tag, uint8_t len, uint32_t index,
+                   uint32_t v);
+
+/// Build the tag of the package list
+void path_package_list(uint8_t (*tag)[32], uint8_t *len);
+/// Build the tag of a CAP file
+void path_cap(uint8_t p, uint8_t (*tag)[32], uint8_t *len);
+/// Build the tag of a static field
+void path_static(uint8_t p, uint8_t s, uint8_t (*tag)[32], uint8_t *len);
+/// Build the tag of an applet field
+void path_applet_field(uint8_t a, uint8_t p, uint16_t c, uint8_t f,
+                       uint8_t (*tag)[32], uint8_t *len);
+
+/// Start the Java Card Runtime Environment
+void run_emulator();
+/// Call the JCRE (0) or a Java Card method (2)
+void remote_call(int call, uint32_t arg1, uint32_t arg2);
+
+/// JCRE entry point, implemented by the JCVM
+int starting_jcre();
+/// Java Card method entry point, implemented by the JCVM
+void runtime(uint8_t id_package, uint8_t id_class, uint8_t id_method);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _NATIVE_OS_FFI_H */
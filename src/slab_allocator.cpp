@@ -0,0 +1,268 @@
+/*
+** The MIT License (MIT)
+**
+** Copyright (c) 2020, National Cybersecurity Agency of France (ANSSI)
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+** Author:
+**   - Guillaume Bouffard <guillaume.bouffard@ssi.gouv.fr>
+*/
+
+#include "slab_allocator.hpp"
+#include "exceptions.hpp"
+
+#include <cstdint>
+#include <new>
+
+namespace jcvm {
+
+const uint16_t Slab_Allocator::block_sizes[SLAB_NB_SIZE_CLASSES] = {
+    8, 16, 32, 64, 128,
+    264, // APDU buffer (5-byte header and 256-byte data)
+};
+Slab_Allocator::FreeBlock *Slab_Allocator::free_blocks[SLAB_NB_SIZE_CLASSES] =
+    {};
+std::vector<Slab_Allocator::Slab> Slab_Allocator::slabs[SLAB_NB_SIZE_CLASSES];
+Slab_Allocator::Stats Slab_Allocator::stats;
+
+/**
+ * Get the size class of a block size.
+ *
+ * @param[size] block size.
+ *
+ * @return the smallest size class where the block fits in, or
+ * SLAB_NB_SIZE_CLASSES if the block is bigger than all the size classes
+ * which fit in a slab.
+ */
+uint8_t Slab_Allocator::getSizeClass(const size_t size) noexcept {
+  uint8_t size_class = 0;
+
+  while ((size_class < SLAB_NB_SIZE_CLASSES) &&
+         (Slab_Allocator::block_sizes[size_class] < size)) {
+    size_class++;
+  }
+
+  if ((size_class < SLAB_NB_SIZE_CLASSES) &&
+      (Slab_Allocator::block_sizes[size_class] > SLAB_SIZE)) {
+    return SLAB_NB_SIZE_CLASSES;
+  }
+
+  return size_class;
+}
+
+/**
+ * Get the length of the slabs of a size class.
+ *
+ * @param[size_class] size class.
+ *
+ * @return the bytes of the blocks which fit in a slab.
+ */
+uint16_t Slab_Allocator::getSlabLength(const uint8_t size_class) noexcept {
+  const uint16_t block_size = Slab_Allocator::block_sizes[size_class];
+
+  return (SLAB_SIZE / block_size) * block_size;
+}
+
+/**
+ * Find the slab of an allocated or free block.
+ *
+ * @param[size_class] size class of the block.
+ * @param[block] block to find.
+ *
+ * @return the slab where the block is.
+ */
+Slab_Allocator::Slab &
+Slab_Allocator::findSlab(const uint8_t size_class, const void *block) noexcept {
+  const uintptr_t address = reinterpret_cast<uintptr_t>(block);
+  const uint16_t slab_length = Slab_Allocator::getSlabLength(size_class);
+
+  for (auto &slab : Slab_Allocator::slabs[size_class]) {
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(slab.memory);
+
+    if ((address >= begin) && (address < (begin + slab_length))) {
+      return slab;
+    }
+  }
+
+  // Blocks are only taken from the slabs of their size class.
+  return Slab_Allocator::slabs[size_class].back();
+}
+
+/**
+ * Reserve memory for the heap objects. The empty slabs are released if the
+ * reserved memory would exceed JCVM_MAX_HEAP_SIZE.
+ *
+ * @param[length] bytes to reserve.
+ */
+void Slab_Allocator::reserve(const size_t length) {
+  if ((Slab_Allocator::stats.reserved_bytes + length) > JCVM_MAX_HEAP_SIZE) {
+    Slab_Allocator::releaseEmptySlabs();
+  }
+
+  if ((Slab_Allocator::stats.reserved_bytes + length) > JCVM_MAX_HEAP_SIZE) {
+    throw Exceptions::FullMemoryException;
+  }
+
+  Slab_Allocator::stats.reserved_bytes += length;
+}
+
+/**
+ * Split a new slab into free blocks of a size class. Slabs are kept until
+ * all their blocks are freed and the empty slabs are released.
+ *
+ * @param[size_class] size class to grow.
+ */
+void Slab_Allocator::grow(const uint8_t size_class) {
+  const uint16_t block_size = Slab_Allocator::block_sizes[size_class];
+  const uint16_t slab_length = Slab_Allocator::getSlabLength(size_class);
+
+  Slab_Allocator::reserve(slab_length);
+
+  uint8_t *slab = static_cast<uint8_t *>(::operator new(slab_length));
+
+  for (uint16_t offset = 0; offset < slab_length; offset += block_size) {
+    FreeBlock *block = reinterpret_cast<FreeBlock *>(slab + offset);
+
+    block->next = Slab_Allocator::free_blocks[size_class];
+    Slab_Allocator::free_blocks[size_class] = block;
+  }
+
+  Slab_Allocator::slabs[size_class].push_back({slab, 0});
+  Slab_Allocator::stats.size_classes[size_class].nb_slabs++;
+}
+
+/**
+ * Allocate a block.
+ *
+ * @param[size] requested block size.
+ *
+ * @return the allocated block.
+ */
+void *Slab_Allocator::allocate(const size_t size) {
+  const uint8_t size_class = Slab_Allocator::getSizeClass(size);
+  const size_t block_size = (size_class < SLAB_NB_SIZE_CLASSES)
+                                ? Slab_Allocator::block_sizes[size_class]
+                                : size;
+  void *block = nullptr;
+
+  if (size_class < SLAB_NB_SIZE_CLASSES) {
+    if (Slab_Allocator::free_blocks[size_class] == nullptr) {
+      Slab_Allocator::grow(size_class);
+    }
+
+    FreeBlock *free_block = Slab_Allocator::free_blocks[size_class];
+    Slab_Allocator::free_blocks[size_class] = free_block->next;
+    Slab_Allocator::findSlab(size_class, free_block).nb_used_blocks++;
+    Slab_Allocator::stats.size_classes[size_class].nb_used_blocks++;
+    block = free_block;
+  } else {
+    Slab_Allocator::reserve(block_size);
+    block = ::operator new(block_size);
+  }
+
+  Slab_Allocator::stats.requested_bytes += size;
+  Slab_Allocator::stats.used_bytes += block_size;
+
+  return block;
+}
+
+/**
+ * Free a block. Small blocks are given back to the free blocks of their size
+ * class.
+ *
+ * @param[block] block to free.
+ * @param[size] requested size of the block to free.
+ */
+void Slab_Allocator::deallocate(void *const block, const size_t size) noexcept {
+  const uint8_t size_class = Slab_Allocator::getSizeClass(size);
+  size_t block_size = size;
+
+  if (size_class < SLAB_NB_SIZE_CLASSES) {
+    FreeBlock *free_block = static_cast<FreeBlock *>(block);
+
+    block_size = Slab_Allocator::block_sizes[size_class];
+    free_block->next = Slab_Allocator::free_blocks[size_class];
+    Slab_Allocator::free_blocks[size_class] = free_block;
+    Slab_Allocator::findSlab(size_class, free_block).nb_used_blocks--;
+    Slab_Allocator::stats.size_classes[size_class].nb_used_blocks--;
+  } else {
+    ::operator delete(block);
+    Slab_Allocator::stats.reserved_bytes -= block_size;
+  }
+
+  Slab_Allocator::stats.requested_bytes -= size;
+  Slab_Allocator::stats.used_bytes -= block_size;
+}
+
+/**
+ * Release the slabs without allocated blocks: their free blocks are dropped
+ * from the free blocks of their size class.
+ */
+void Slab_Allocator::releaseEmptySlabs() noexcept {
+  for (uint8_t size_class = 0; size_class < SLAB_NB_SIZE_CLASSES;
+       size_class++) {
+    const uint16_t slab_length = Slab_Allocator::getSlabLength(size_class);
+    auto &class_slabs = Slab_Allocator::slabs[size_class];
+
+    for (auto slab = class_slabs.begin(); slab != class_slabs.end();) {
+      if (slab->nb_used_blocks != 0) {
+        ++slab;
+        continue;
+      }
+
+      const uintptr_t begin = reinterpret_cast<uintptr_t>(slab->memory);
+      FreeBlock **link = &(Slab_Allocator::free_blocks[size_class]);
+
+      while (*link != nullptr) {
+        const uintptr_t address = reinterpret_cast<uintptr_t>(*link);
+
+        if ((address >= begin) && (address < (begin + slab_length))) {
+          *link = (*link)->next;
+        } else {
+          link = &((*link)->next);
+        }
+      }
+
+      ::operator delete(slab->memory);
+      Slab_Allocator::stats.reserved_bytes -= slab_length;
+      Slab_Allocator::stats.size_classes[size_class].nb_slabs--;
+      slab = class_slabs.erase(slab);
+    }
+  }
+}
+
+/**
+ * Get the allocator statistics. The internal fragmentation is
+ * used_bytes - requested_bytes, the free memory kept in the slabs is
+ * reserved_bytes - used_bytes.
+ *
+ * @return the allocator statistics.
+ */
+const Slab_Allocator::Stats &Slab_Allocator::getStats() noexcept {
+  for (uint8_t size_class = 0; size_class < SLAB_NB_SIZE_CLASSES;
+       size_class++) {
+    Slab_Allocator::stats.size_classes[size_class].block_size =
+        Slab_Allocator::block_sizes[size_class];
+  }
+
+  return Slab_Allocator::stats;
+}
+
+} // namespace jcvm
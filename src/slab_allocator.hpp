@@ -0,0 +1,129 @@
+/*
+** The MIT License (MIT)
+**
+** Copyright (c) 2020, National Cybersecurity Agency of France (ANSSI)
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+** Author:
+**   - Guillaume Bouffard <guillaume.bouffard@ssi.gouv.fr>
+*/
+
+#ifndef _SLAB_ALLOCATOR_HPP
+#define _SLAB_ALLOCATOR_HPP
+
+#include "jc_config.h"
+#include "types.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace jcvm {
+
+/// Number of block size classes.
+#define SLAB_NB_SIZE_CLASSES (uint8_t)6
+/// Size of the memory chunk split into blocks of one size class: a quarter
+/// of the heap, up to 1 KB. The size classes bigger than a slab are not used.
+#define SLAB_SIZE                                                              \
+  (uint16_t)(((JCVM_MAX_HEAP_SIZE >> 2) < 1024) ? (JCVM_MAX_HEAP_SIZE >> 2)    \
+                                                : 1024) // bytes
+
+/*
+ * Allocator of the Java Card heap object bodies (array data and instance
+ * fields). Blocks are taken from per size class slabs, sized for the usual
+ * Java Card arrays (small short arrays up to APDU-sized byte buffers), and
+ * freed blocks are reused by the next allocations of the same size class.
+ * Bigger blocks are allocated from the general-purpose allocator.
+ *
+ * The memory reserved for the Java Card heap objects, slabs and big blocks,
+ * is bounded by JCVM_MAX_HEAP_SIZE. The empty slabs are released after each
+ * garbage collection, and when the bound is reached.
+ */
+class Slab_Allocator {
+public:
+  /// Size class statistics
+  struct SizeClassStats {
+    /// Block size
+    uint16_t block_size = 0;
+    /// Number of slabs
+    uint16_t nb_slabs = 0;
+    /// Number of allocated blocks
+    uint16_t nb_used_blocks = 0;
+  };
+
+  /// Allocator statistics
+  struct Stats {
+    /// Requested bytes of the allocated blocks
+    uint32_t requested_bytes = 0;
+    /// Bytes of the allocated blocks
+    uint32_t used_bytes = 0;
+    /// Bytes of the slabs and of the big blocks, bounded by JCVM_MAX_HEAP_SIZE
+    uint32_t reserved_bytes = 0;
+    /// Size classes statistics
+    SizeClassStats size_classes[SLAB_NB_SIZE_CLASSES];
+  };
+
+private:
+  /// Free block, linked to the next free block of its size class
+  struct FreeBlock {
+    FreeBlock *next;
+  };
+
+  /// Slab of a size class
+  struct Slab {
+    /// Slab memory
+    uint8_t *memory;
+    /// Number of allocated blocks
+    uint16_t nb_used_blocks;
+  };
+
+  /// Block sizes of the size classes
+  static const uint16_t block_sizes[SLAB_NB_SIZE_CLASSES];
+  /// Free blocks, by size class
+  static FreeBlock *free_blocks[SLAB_NB_SIZE_CLASSES];
+  /// Slabs, by size class
+  static std::vector<Slab> slabs[SLAB_NB_SIZE_CLASSES];
+  /// Allocator statistics
+  static Stats stats;
+
+  /// Get the size class of a block size, SLAB_NB_SIZE_CLASSES for big blocks
+  static uint8_t getSizeClass(const size_t size) noexcept;
+  /// Get the length of the slabs of a size class
+  static uint16_t getSlabLength(const uint8_t size_class) noexcept;
+  /// Find the slab of a block
+  static Slab &findSlab(const uint8_t size_class, const void *block) noexcept;
+  /// Reserve memory for the heap objects
+  static void reserve(const size_t length);
+  /// Split a new slab into free blocks
+  static void grow(const uint8_t size_class);
+
+public:
+  /// Allocate a block
+  static void *allocate(const size_t size);
+  /// Free a block
+  static void deallocate(void *const block, const size_t size) noexcept;
+  /// Release the slabs without allocated blocks
+  static void releaseEmptySlabs() noexcept;
+  /// Get the allocator statistics
+  static const Stats &getStats() noexcept;
+};
+
+} // namespace jcvm
+
+#endif /* _SLAB_ALLOCATOR_HPP */
@@ -40,17 +40,29 @@ namespace jcvm {
  * parameters.
  * @param[max_operand_stack] number of max. operand stack element required
  *                           to execute this function.
+ * @param[pc] first bytecode of the invoked method.
+ * @param[packageID] package ID where the invoked method is located.
  * @return void.
  */
 void Stack::push_Frame(const uint8_t nargs, const uint8_t max_locals,
-                       const uint8_t max_operand_stack, const uint8_t *pc)
+                       const uint8_t max_operand_stack, const uint8_t *pc,
+                       const jpackage_ID_t packageID)
 #if !defined(JCRE_STACK_OVERFLOW_PROTECTION) && !defined(JCVM_ARRAY_SIZE_CHECK)
     noexcept
 #endif
 {
   jword_t *new_fp, *new_op, *new_tos, *new_eos;
 
-  if (this->frames.empty()) { // the first frame is pushing.
+#ifdef JCRE_STACK_OVERFLOW_PROTECTION
+
+  if (this->nb_frames >= JCVM_MAX_FRAMES) {
+    // Too many nested frames!!!!
+    throw Exceptions::StackOverflowException;
+  }
+
+#endif /* JCRE_STACK_OVERFLOW_PROTECTION */
+
+  if (this->empty()) { // the first frame is pushing.
     new_fp = &(this->jc_stack[0]);
   } else {
 
@@ -85,7 +97,9 @@ void Stack::push_Frame(const uint8_t nargs, const uint8_t max_locals,
   new_tos = new_op;
   new_eos = new_tos + max_operand_stack;
 
-  this->frames.emplace_front(new_fp, new_op, new_tos, new_eos, new_pc);
+  this->frames[this->nb_frames] =
+      Frame(new_fp, new_op, new_tos, new_eos, new_pc, packageID);
+  this->nb_frames++;
 
   // cleaning the local variables area
   for (auto word = (new_fp + nargs); word < new_op; word++) {
@@ -97,18 +111,18 @@ void Stack::push_Frame(const uint8_t nargs, const uint8_t max_locals,
  * Popping the current frame.
  */
 void Stack::pop_Frame() {
-  if (this->frames.empty()) {
+  if (this->empty()) {
     throw Exceptions::SecurityException;
   }
 
-  this->frames.pop_front();
+  this->nb_frames--;
   return;
 }
 
 /**
  * The stack is empty? (no pushed Java Card frame)
  */
-bool Stack::empty() noexcept { return this->frames.empty(); }
+bool Stack::empty() noexcept { return (this->nb_frames == 0); }
 
 /**
  * Pushing a byte to the operand stack
@@ -526,12 +540,12 @@ pc_t &Stack::getPC() {
  *
  * @return the saved pc index.
  */
-uint8_t Stack::savePC() noexcept {
+uint8_t Stack::savePC() {
   Frame &current_frame = this->getCurrentFrame();
   return current_frame.savePC();
 }
 
-pc_t &Stack::restorePC(const uint8_t index) {
+pc_t Stack::restorePC(const uint8_t index) {
   Frame &current_frame = this->getCurrentFrame();
   return current_frame.restorePC(index);
 }
@@ -541,6 +555,31 @@ pc_t &Stack::restorePC(const uint8_t index) {
  *
  * @return the current frame.
  */
-Frame &Stack::getCurrentFrame() { return *(this->frames.begin()); }
+Frame &Stack::getCurrentFrame() {
+  return this->frames[this->nb_frames - 1];
+}
+
+/**
+ * Get the first word of the Java Card stack. Frames are pushed contiguously
+ * from this word.
+ *
+ * @return the first stack word.
+ */
+const jword_t *Stack::begin() const noexcept { return this->jc_stack; }
+
+/**
+ * Get the word after the top of the current operand stack. The words from
+ * begin() to end() hold the locals and the operand stacks of all the pushed
+ * frames.
+ *
+ * @return the end of the used stack words.
+ */
+const jword_t *Stack::end() const noexcept {
+  if (this->nb_frames == 0) {
+    return this->jc_stack;
+  }
+
+  return this->frames[this->nb_frames - 1].getTOS();
+}
 
 } // namespace jcvm
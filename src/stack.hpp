@@ -34,7 +34,7 @@
 #include "jc_types/jref_t.hpp"
 #include "types.hpp"
 
-// TODO: Move the PC to the context.hpp file (in the packagesID list)
+#include <utility>
 
 namespace jcvm {
 
@@ -59,12 +59,16 @@ static_assert(sizeof(std::declval<jref_t &>().compact()) == sizeof(jword_t),
 class Stack {
 private:
   jword_t jc_stack[JCVM_STACK_SIZE];
-  List<Frame> frames;
+  /// Pushed frames, the last pushed one is the current frame.
+  Frame frames[JCVM_MAX_FRAMES];
+  /// Number of pushed frames.
+  uint8_t nb_frames = 0;
 
 public:
   // Pushing a new frame regarding the invoked method header.
   void push_Frame(const uint8_t nargs, const uint8_t max_locals,
-                  const uint8_t max_operand_stack, const uint8_t *pc)
+                  const uint8_t max_operand_stack, const uint8_t *pc,
+                  const jpackage_ID_t packageID)
 #if !defined(JCRE_STACK_OVERFLOW_PROTECTION) && !defined(JCVM_ARRAY_SIZE_CHECK)
       noexcept
 #endif
@@ -149,11 +153,16 @@ public:
   ///  Get the current PC value
   pc_t &getPC();
   /// Save PC value for jsr instruction
-  uint8_t savePC() noexcept;
+  uint8_t savePC();
   /// Restore PC value for ret instruction
-  pc_t &restorePC(const uint8_t index);
+  pc_t restorePC(const uint8_t index);
   /// Get the current frame
   Frame &getCurrentFrame();
+
+  /// Get the first word of the Java Card stack
+  const jword_t *begin() const noexcept;
+  /// Get the word after the top of the current operand stack
+  const jword_t *end() const noexcept;
 };
 
 } // namespace jcvm
@@ -0,0 +1,75 @@
+/*
+** The MIT License (MIT)
+**
+** Copyright (c) 2020, National Cybersecurity Agency of France (ANSSI)
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+** Author:
+**   - Guillaume Bouffard <guillaume.bouffard@ssi.gouv.fr>
+*/
+
+
+#include "transient_memory.hpp"
+
+namespace jcvm {
+
+uint32_t Transient_Memory::epochs[TRANSIENT_NB_CLEAR_EVENTS] = {};
+
+/**
+ * Is a valid clear event?
+ *
+ * @param[event] event to check.
+ *
+ * @return true if the event is CLEAR_ON_SELECT or CLEAR_ON_DESELECT.
+ */
+bool Transient_Memory::isClearEvent(const uint8_t event) noexcept {
+  return (event == ClearEvent::CLEAR_ON_SELECT) ||
+         (event == ClearEvent::CLEAR_ON_DESELECT);
+}
+
+/**
+ * Get the current epoch of a clear event.
+ *
+ * @param[event] clear event.
+ *
+ * @return the clear event epoch, or 0 if the event is not a clear event.
+ */
+uint32_t Transient_Memory::getEpoch(const ClearEvent event) noexcept {
+  if (!Transient_Memory::isClearEvent(event)) {
+    return 0;
+  }
+
+  return Transient_Memory::epochs[event - ClearEvent::CLEAR_ON_SELECT];
+}
+
+/**
+ * Clear the transient arrays of a clear event. The arrays are not touched:
+ * they are zeroed when they are accessed for the first time in the new
+ * epoch.
+ *
+ * @param[event] clear event.
+ */
+void Transient_Memory::clear(const ClearEvent event) noexcept {
+  if (Transient_Memory::isClearEvent(event)) {
+    Transient_Memory::epochs[event - ClearEvent::CLEAR_ON_SELECT]++;
+  }
+}
+
+} // namespace jcvm
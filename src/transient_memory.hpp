@@ -0,0 +1,68 @@
+/*
+** The MIT License (MIT)
+**
+** Copyright (c) 2020, National Cybersecurity Agency of France (ANSSI)
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+** Author:
+**   - Guillaume Bouffard <guillaume.bouffard@ssi.gouv.fr>
+*/
+
+
+#ifndef _TRANSIENT_MEMORY_HPP
+#define _TRANSIENT_MEMORY_HPP
+
+#include "jc_config.h"
+#include "types.hpp"
+
+namespace jcvm {
+
+enum ClearEvent : uint8_t {
+  CLEAR_ON_SELECT = (uint8_t)1,
+  CLEAR_ON_DESELECT = (uint8_t)2,
+  None = (uint8_t)0xFF,
+};
+
+/// Number of clear events.
+#define TRANSIENT_NB_CLEAR_EVENTS (uint8_t)2
+
+/*
+ * Clearing state of the transient arrays. Each clear event has an epoch
+ * counter: clearing the transient arrays of an event only increments its
+ * counter. A transient array records the epoch it was last cleared in, and
+ * its data is zeroed the first time it is touched in a later epoch.
+ */
+class Transient_Memory {
+private:
+  /// Current epochs, by clear event
+  static uint32_t epochs[TRANSIENT_NB_CLEAR_EVENTS];
+
+public:
+  /// Is a valid clear event?
+  static bool isClearEvent(const uint8_t event) noexcept;
+  /// Get the current epoch of a clear event, 0 for ClearEvent::None
+  static uint32_t getEpoch(const ClearEvent event) noexcept;
+  /// Clear the transient arrays of a clear event
+  static void clear(const ClearEvent event) noexcept;
+};
+
+} // namespace jcvm
+
+#endif /* _TRANSIENT_MEMORY_HPP */
@@ -0,0 +1,318 @@
+/*
+** The MIT License (MIT)
+**
+** Copyright (c) 2020, National Cybersecurity Agency of France (ANSSI)
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+** Author:
+**   - Guillaume Bouffard <guillaume.bouffard@ssi.gouv.fr>
+*/
+
+
+/*
+ * Class handler tests, on CAP files installed in the in-tree file system: the
+ * virtual method tables of a class hierarchy spread over two packages.
+ */
+
+#include "jc_handlers/jc_class.hpp"
+#include "context.hpp"
+#include "ffi.h"
+#include "jc_handlers/flashmemory.hpp"
+#include "jc_handlers/flashmemory_cache.hpp"
+#include "jc_handlers/jc_cp.hpp"
+#include "jc_handlers/jc_method.hpp"
+#include "test.hpp"
+
+#include <cstdint>
+#include <vector>
+
+/// Used flash memory length, defined by the PC target.
+uint32_t flash_length = 0;
+
+namespace jcvm {
+
+/// Native methods, generated with the ROM mask: none are called here.
+void callJCNativeMethod(Context &, jshort_t) {
+  throw Exceptions::SecurityException;
+}
+
+} // namespace jcvm
+
+using namespace jcvm;
+
+/// Package of the superclass A
+#define PACKAGE_A (jpackage_ID_t)0
+/// Package of the subclass B, which imports the package A
+#define PACKAGE_B (jpackage_ID_t)1
+
+/// Offsets of the methods of a package, in its method component.
+#define PUBLIC_METHOD_OFFSET (uint16_t)1
+#define PACKAGE_METHOD_OFFSET (uint16_t)4
+
+/**
+ * Append a CAP file component to a CAP file.
+ *
+ * @param[cap] CAP file to update.
+ * @param[tag] component tag.
+ * @param[info] component content.
+ */
+static void addComponent(std::vector<uint8_t> &cap, const uint8_t tag,
+                         const std::vector<uint8_t> &info) {
+  cap.push_back(tag);
+  cap.push_back((uint8_t)(info.size() >> 8));
+  cap.push_back((uint8_t)info.size());
+  cap.insert(cap.end(), info.begin(), info.end());
+}
+
+/**
+ * Get the package information of a test package.
+ *
+ * @param[packageID] test package ID.
+ *
+ * @return the minor and major versions, and the AID of the package.
+ */
+static std::vector<uint8_t> getPackageInfo(const jpackage_ID_t packageID) {
+  return {0x00, 0x01, 0x05, 0xA0,
+          0x00, 0x00, 0x00, (uint8_t)(0x10 + packageID)};
+}
+
+/**
+ * Build the CAP file of a test package, with a single class defining a
+ * public method and package methods: two in the package A, one in the
+ * package B. The class of the package B extends the class of the package A.
+ *
+ * @param[packageID] test package ID.
+ *
+ * @return the CAP file.
+ */
+static std::vector<uint8_t> buildCap(const jpackage_ID_t packageID) {
+  std::vector<uint8_t> cap;
+  std::vector<uint8_t> header = {0xDE, 0xCA, 0xFF, 0xED, 0x01, 0x02, 0x00};
+  const std::vector<uint8_t> package_info = getPackageInfo(packageID);
+  std::vector<uint8_t> import = {0x00};
+  // The directory content is not used by the class handler.
+  const std::vector<uint8_t> directory(sizeof(jc_cap_directory_component) - 3,
+                                       0);
+
+  header.insert(header.end(), package_info.begin(), package_info.end());
+
+  if (packageID == PACKAGE_B) {
+    const std::vector<uint8_t> imported = getPackageInfo(PACKAGE_A);
+
+    import[0] = 1;
+    import.insert(import.end(), imported.begin(), imported.end());
+  }
+
+  // A extends Object, B extends A (external class reference).
+  const uint8_t super_class[2] = {
+      (uint8_t)((packageID == PACKAGE_A) ? 0xFF : 0x80),
+      (uint8_t)((packageID == PACKAGE_A) ? 0xFF : 0x00)};
+  std::vector<uint8_t> claz = {
+      0x00,           // flags and interface count
+      super_class[0], // super class reference
+      super_class[1],
+      0x00, // declared instance size
+      0xFF, // first reference token
+      0x00, // reference count
+      0x00, // public method table base
+      0x01, // public method table count
+      0x00, // package method table base
+      0x01, // package method table count
+      0x00, // public method table
+      PUBLIC_METHOD_OFFSET,
+      0x00, // package method table
+      PACKAGE_METHOD_OFFSET};
+
+  if (packageID == PACKAGE_A) {
+    claz[9]++; // package method table count
+    claz.insert(claz.end(), {0x00, PACKAGE_METHOD_OFFSET});
+  }
+
+  // Method headers (nargs 1) followed by a return instruction.
+  const std::vector<uint8_t> method = {0x00, // exception handler count
+                                       0x00, 0x10, 0x7A, 0x00, 0x10, 0x7A};
+
+  addComponent(cap, 1, header);
+  addComponent(cap, 2, directory);
+  addComponent(cap, 4, import);
+  addComponent(cap, 5, {0x00, 0x00});
+  addComponent(cap, 6, claz);
+  addComponent(cap, 7, method);
+
+  return cap;
+}
+
+/**
+ * Install the test packages in the file system.
+ */
+static void setUp() {
+  const std::vector<uint8_t> packages(JCVM_MAX_PACKAGES / 8, 0);
+
+  FlashMemory_Cache::write(FlashMemory_Handler::getPackagesListTag(),
+                           packages.data(), packages.size());
+
+  for (const jpackage_ID_t packageID : {PACKAGE_A, PACKAGE_B}) {
+    const std::vector<uint8_t> cap = buildCap(packageID);
+
+    FlashMemory_Cache::write(FlashMemory_Handler::getCapTag(packageID),
+                             cap.data(), cap.size());
+    FlashMemory_Handler::enablePackage(packageID);
+  }
+}
+
+/**
+ * Get the class of a test package.
+ *
+ * @param[packageID] test package ID.
+ *
+ * @return the package and the class info of the class.
+ */
+static std::pair<Package, const jc_cap_class_info *>
+getClass(const jpackage_ID_t packageID) {
+  jc_cap_class_ref classref;
+  classref.internal_classref = 0;
+
+  return ConstantPool_Handler(Package(packageID)).classref2class(classref);
+}
+
+/**
+ * Get the method at an offset of the method component of a test package.
+ *
+ * @param[packageID] test package ID.
+ * @param[method_offset] method offset.
+ *
+ * @return the method.
+ */
+static const uint8_t *getMethod(const jpackage_ID_t packageID,
+                                const uint16_t method_offset) {
+  return Method_Handler::getMethod(Package(packageID), method_offset);
+}
+
+/**
+ * Build a virtual method reference to the class of a test package.
+ *
+ * @param[packageID] test package ID of the referenced class.
+ * @param[from] test package ID where the reference is resolved.
+ * @param[token] virtual method token.
+ *
+ * @return the virtual method reference.
+ */
+static jc_cap_virtual_method_ref_info
+getMethodRef(const jpackage_ID_t packageID, const jpackage_ID_t from,
+             const uint8_t token) {
+  jc_cap_virtual_method_ref_info method_ref;
+
+  if (packageID == from) {
+    method_ref.class_ref.internal_classref = 0;
+  } else {
+    method_ref.class_ref.external_classref = {0x80, 0x00};
+  }
+
+  method_ref.token = token;
+
+  return method_ref;
+}
+
+/**
+ * A subclass in another package inherits the public methods, and starts a
+ * package method table of its own.
+ */
+static bool testVTables() {
+  const auto &vtable_a = Class_Handler::getVTable(getClass(PACKAGE_A));
+  const auto &vtable_b = Class_Handler::getVTable(getClass(PACKAGE_B));
+
+  CHECK(vtable_a.package_methods.size() == 2);
+  CHECK(vtable_a.package_methods[0].method ==
+        getMethod(PACKAGE_A, PACKAGE_METHOD_OFFSET));
+
+  CHECK(vtable_b.public_methods.size() == 1);
+  CHECK(vtable_b.public_methods[0].packageID == PACKAGE_B);
+  CHECK(vtable_b.package_methods.size() == 1);
+  CHECK(vtable_b.package_methods[0].packageID == PACKAGE_B);
+  CHECK(vtable_b.package_methods[0].method ==
+        getMethod(PACKAGE_B, PACKAGE_METHOD_OFFSET));
+
+  return true;
+}
+
+/**
+ * A public method is resolved in the receiver class, a package method in
+ * the package of the referenced class.
+ */
+static bool testCrossPackageCalls() {
+  const auto receiver = getClass(PACKAGE_B);
+
+  // Calls from the package A, on A references.
+  Class_Handler handler_a((Package(PACKAGE_A)));
+  auto method = handler_a.getVirtualMethod(
+      receiver, getMethodRef(PACKAGE_A, PACKAGE_A, 0x00));
+
+  CHECK(method.first.getPackageID() == PACKAGE_B);
+  CHECK(method.second == getMethod(PACKAGE_B, PUBLIC_METHOD_OFFSET));
+
+  method = handler_a.getVirtualMethod(receiver,
+                                      getMethodRef(PACKAGE_A, PACKAGE_A, 0x80));
+
+  CHECK(method.first.getPackageID() == PACKAGE_A);
+  CHECK(method.second == getMethod(PACKAGE_A, PACKAGE_METHOD_OFFSET));
+
+  // Calls from the package B, on A and B references.
+  Class_Handler handler_b((Package(PACKAGE_B)));
+
+  method = handler_b.getVirtualMethod(receiver,
+                                      getMethodRef(PACKAGE_A, PACKAGE_B, 0x80));
+
+  CHECK(method.first.getPackageID() == PACKAGE_A);
+  CHECK(method.second == getMethod(PACKAGE_A, PACKAGE_METHOD_OFFSET));
+
+  method = handler_b.getVirtualMethod(receiver,
+                                      getMethodRef(PACKAGE_B, PACKAGE_B, 0x80));
+
+  CHECK(method.first.getPackageID() == PACKAGE_B);
+  CHECK(method.second == getMethod(PACKAGE_B, PACKAGE_METHOD_OFFSET));
+
+  // The package A tokens are not package B tokens.
+  CHECK_THROWS(handler_b.getVirtualMethod(
+                   receiver, getMethodRef(PACKAGE_B, PACKAGE_B, 0x81)),
+               Exceptions::SecurityException);
+
+  // A package B method is not found on a receiver of the package A.
+  CHECK_THROWS(handler_b.getVirtualMethod(
+                   getClass(PACKAGE_A),
+                   getMethodRef(PACKAGE_B, PACKAGE_B, 0x80)),
+               Exceptions::SecurityException);
+
+  return true;
+}
+
+int main() {
+  bool isPassed = true;
+
+  if (fs_init() != 0) {
+    return EXIT_FAILURE;
+  }
+
+  setUp();
+
+  RUN_TEST(testVTables, isPassed);
+  RUN_TEST(testCrossPackageCalls, isPassed);
+
+  return isPassed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
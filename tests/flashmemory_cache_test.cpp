@@ -0,0 +1,244 @@
+/*
+** The MIT License (MIT)
+**
+** Copyright (c) 2020, National Cybersecurity Agency of France (ANSSI)
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+** Author:
+**   - Guillaume Bouffard <guillaume.bouffard@ssi.gouv.fr>
+*/
+
+
+/*
+ * Flash memory cache tests, on the in-tree file system: the writes done while
+ * the journal is started do not reach the flash memory before the commit.
+ */
+
+#include "jc_handlers/flashmemory_cache.hpp"
+#include "exceptions.hpp"
+#include "ffi.h"
+#include "jc_handlers/native_fs.hpp"
+#include "test.hpp"
+
+#include <cstring>
+#include <vector>
+
+using namespace jcvm;
+
+/// Used flash memory length, defined by the PC target.
+uint32_t flash_length = 0;
+
+/// Flash memory content and file system writes at a point in time.
+struct FlashSnapshot {
+  std::vector<uint8_t> memory;
+  uint32_t writes;
+  uint32_t element_writes;
+
+  FlashSnapshot()
+      : memory(flash_pointer(), flash_pointer() + flash_length),
+        writes(Native_FS::getStats().writes),
+        element_writes(Native_FS::getStats().element_writes) {}
+
+  bool operator==(const FlashSnapshot &other) const {
+    return (this->memory == other.memory) && (this->writes == other.writes) &&
+           (this->element_writes == other.element_writes);
+  }
+};
+
+static const fs::Tag field_tag = Native_FS::getStaticFieldTag(1, 0);
+static const fs::Tag array_tag = Native_FS::getStaticFieldTag(1, 1);
+static const fs::Tag new_tag = Native_FS::getStaticFieldTag(1, 2);
+
+/// Array data length, written through by the cache.
+#define ARRAY_LENGTH (uint32_t)64
+
+/**
+ * Write the tag data used by the tests to the file system.
+ */
+static void setUp() {
+  const uint8_t field[2] = {0x11, 0x22};
+  uint8_t array[ARRAY_LENGTH];
+
+  for (uint32_t i = 0; i < ARRAY_LENGTH; i++) {
+    array[i] = (uint8_t)i;
+  }
+
+  FlashMemory_Cache::write(field_tag, field, sizeof(field));
+  FlashMemory_Cache::write(array_tag, array, sizeof(array));
+  FlashMemory_Cache::flush();
+}
+
+/**
+ * Writes of any size and more element writes than cache entries stay in RAM
+ * until the commit, then reach the file system in write order.
+ */
+static bool testCommit() {
+  setUp();
+
+  const FlashSnapshot before;
+  const uint8_t field[2] = {0x33, 0x44};
+  uint8_t data[ARRAY_LENGTH + 8] = {0};
+
+  FlashMemory_Cache::startJournal();
+  FlashMemory_Cache::write(field_tag, field, sizeof(field));
+  FlashMemory_Cache::write(new_tag, data, sizeof(data));
+  FlashMemory_Cache::write_4b_at(new_tag, 8, 0xA5A5A5A5);
+
+  for (uint32_t i = 0; i < 2 * JCVM_WRITE_BACK_CACHE_SIZE; i++) {
+    FlashMemory_Cache::write_1b_at(array_tag, i, (uint8_t)(0x80 + i));
+  }
+
+  FlashMemory_Cache::write_2b_at(array_tag, 1, 0x0F0F);
+
+  CHECK(FlashSnapshot() == before);
+
+  // Reads return the journal writes.
+  uint32_t length = 0;
+  const uint8_t *array = FlashMemory_Cache::readInPlace(array_tag, length);
+
+  CHECK(length == ARRAY_LENGTH);
+  CHECK((array[0] == 0x80) && (array[1] == 0x0F) && (array[2] == 0x0F));
+  CHECK(array[ARRAY_LENGTH - 1] == ARRAY_LENGTH - 1);
+  CHECK(FlashMemory_Cache::read_1b_at(array_tag, 3) == 0x83);
+  CHECK(FlashMemory_Cache::read_1b_at(array_tag, 2) == 0x0F);
+  CHECK(FlashMemory_Cache::length(new_tag) == sizeof(data));
+  CHECK(FlashMemory_Cache::read_4b_at(new_tag, 8) == 0xA5A5A5A5);
+  CHECK(std::memcmp(FlashMemory_Cache::readScalar(field_tag, length), field,
+                    sizeof(field)) == 0);
+
+  CHECK(FlashSnapshot() == before);
+
+  FlashMemory_Cache::commitJournal();
+
+  CHECK(!(FlashSnapshot() == before));
+
+  uint8_t read[ARRAY_LENGTH + 8];
+  const uint8_t *tag_value = &(new_tag.value[0]);
+
+  CHECK(fs_read(tag_value, new_tag.len, read, sizeof(read)) == 0);
+  CHECK(read[8] == 0xA5 && read[11] == 0xA5 && read[12] == 0);
+
+  tag_value = &(array_tag.value[0]);
+  CHECK(fs_read(tag_value, array_tag.len, read, ARRAY_LENGTH) == 0);
+  CHECK((read[0] == 0x80) && (read[1] == 0x0F) && (read[2] == 0x0F));
+  CHECK(read[3] == 0x83);
+
+  tag_value = &(field_tag.value[0]);
+  CHECK(fs_read(tag_value, field_tag.len, read, sizeof(field)) == 0);
+  CHECK(std::memcmp(read, field, sizeof(field)) == 0);
+
+  return true;
+}
+
+/**
+ * A rollback drops the journal writes without writing the file system.
+ */
+static bool testRollback() {
+  setUp();
+
+  const FlashSnapshot before;
+  const uint32_t rollbacks = FlashMemory_Cache::getRollbacks();
+  const uint8_t field[2] = {0x55, 0x66};
+
+  FlashMemory_Cache::startJournal();
+  FlashMemory_Cache::write(field_tag, field, sizeof(field));
+  FlashMemory_Cache::write_1b_at(array_tag, 0, 0xFF);
+  FlashMemory_Cache::rollbackJournal();
+
+  CHECK(FlashSnapshot() == before);
+  CHECK(FlashMemory_Cache::getRollbacks() == rollbacks + 1);
+  CHECK(FlashMemory_Cache::read_1b_at(array_tag, 0) == 0);
+  CHECK(FlashMemory_Cache::read_1b_at(field_tag, 0) == 0x11);
+
+  FlashMemory_Cache::flush();
+  CHECK(FlashSnapshot() == before);
+
+  return true;
+}
+
+/**
+ * A write which does not fit in the journal rolls it back, and the file
+ * system is not written.
+ */
+static bool testCapacity() {
+  setUp();
+
+  const FlashSnapshot before;
+  const std::vector<uint8_t> data(JCVM_TRANSACTION_CAPACITY, 0xEE);
+
+  FlashMemory_Cache::startJournal();
+  FlashMemory_Cache::write_1b_at(array_tag, 0, 0xFF);
+  CHECK(FlashMemory_Cache::getJournalBytes() == 1);
+  CHECK_THROWS(FlashMemory_Cache::write(new_tag, data.data(), data.size()),
+               Exceptions::TransactionException);
+
+  CHECK(!FlashMemory_Cache::isJournalInProgress());
+  CHECK(FlashMemory_Cache::getJournalBytes() == 0);
+  CHECK(FlashMemory_Cache::read_1b_at(array_tag, 0) == 0);
+
+  FlashMemory_Cache::flush();
+  CHECK(FlashSnapshot() == before);
+
+  return true;
+}
+
+/**
+ * A write left out of the journal is kept by a rollback, and not undone by a
+ * commit.
+ */
+static bool testSuspendedWrites() {
+  setUp();
+
+  FlashMemory_Cache::startJournal();
+  FlashMemory_Cache::write_2b_at(array_tag, 0, 0x1111);
+  FlashMemory_Cache::suspendJournal(true);
+  FlashMemory_Cache::write_1b_at(array_tag, 1, 0x22);
+  FlashMemory_Cache::suspendJournal(false);
+  FlashMemory_Cache::commitJournal();
+
+  CHECK(FlashMemory_Cache::read_1b_at(array_tag, 1) == 0x22);
+  CHECK(FlashMemory_Cache::read_1b_at(array_tag, 0) == 0x11);
+
+  FlashMemory_Cache::startJournal();
+  FlashMemory_Cache::write_1b_at(array_tag, 2, 0x33);
+  FlashMemory_Cache::suspendJournal(true);
+  FlashMemory_Cache::write_1b_at(array_tag, 3, 0x44);
+  FlashMemory_Cache::rollbackJournal();
+
+  CHECK(FlashMemory_Cache::read_1b_at(array_tag, 2) == 2);
+  CHECK(FlashMemory_Cache::read_1b_at(array_tag, 3) == 0x44);
+
+  return true;
+}
+
+int main() {
+  bool isPassed = true;
+
+  if (fs_init() != 0) {
+    return EXIT_FAILURE;
+  }
+
+  RUN_TEST(testCommit, isPassed);
+  RUN_TEST(testRollback, isPassed);
+  RUN_TEST(testCapacity, isPassed);
+  RUN_TEST(testSuspendedWrites, isPassed);
+
+  return isPassed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,168 @@
+/*
+** The MIT License (MIT)
+**
+** Copyright (c) 2020, National Cybersecurity Agency of France (ANSSI)
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+** Author:
+**   - Guillaume Bouffard <guillaume.bouffard@ssi.gouv.fr>
+*/
+
+
+/*
+ * Slab allocator tests, in the embedded configuration: the memory reserved
+ * for the heap objects, slabs and big blocks, never exceeds the heap size.
+ */
+
+#include "slab_allocator.hpp"
+#include "exceptions.hpp"
+#include "test.hpp"
+
+#include <vector>
+
+using namespace jcvm;
+
+/// Size of a block of the smallest size class
+#define SMALL_BLOCK_SIZE (size_t)8
+
+/**
+ * Is the reserved memory within the heap size?
+ *
+ * @return true if the reserved memory is bounded.
+ */
+static bool isReservedBounded() {
+  return Slab_Allocator::getStats().reserved_bytes <= JCVM_MAX_HEAP_SIZE;
+}
+
+/**
+ * The slabs of the embedded heap are sized from the heap, and the size
+ * classes bigger than a slab are not used.
+ */
+static bool testSlabSize() {
+  CHECK(JCVM_MAX_HEAP_SIZE == 256);
+  CHECK(SLAB_SIZE <= (JCVM_MAX_HEAP_SIZE >> 2));
+
+  // An APDU-sized buffer does not fit in the embedded heap.
+  CHECK_THROWS(Slab_Allocator::allocate(261),
+               Exceptions::FullMemoryException);
+  CHECK(Slab_Allocator::getStats().reserved_bytes == 0);
+
+  void *block = Slab_Allocator::allocate(200);
+
+  CHECK(Slab_Allocator::getStats().reserved_bytes == 200);
+  CHECK_THROWS(Slab_Allocator::allocate(SLAB_SIZE),
+               Exceptions::FullMemoryException);
+  CHECK(isReservedBounded());
+
+  Slab_Allocator::deallocate(block, 200);
+  CHECK(Slab_Allocator::getStats().reserved_bytes == 0);
+
+  return true;
+}
+
+/**
+ * Allocations stop when the reserved memory reaches the heap size, and the
+ * empty slabs are released.
+ */
+static bool testReservedBytes() {
+  std::vector<void *> blocks;
+
+  try {
+    for (;;) {
+      blocks.push_back(Slab_Allocator::allocate(SMALL_BLOCK_SIZE));
+      CHECK(isReservedBounded());
+    }
+  } catch (const Exceptions e) {
+    CHECK(e == Exceptions::FullMemoryException);
+  }
+
+  CHECK(blocks.size() == (JCVM_MAX_HEAP_SIZE / SMALL_BLOCK_SIZE));
+  CHECK(Slab_Allocator::getStats().size_classes[0].nb_slabs ==
+        (JCVM_MAX_HEAP_SIZE / SLAB_SIZE));
+
+  for (void *block : blocks) {
+    Slab_Allocator::deallocate(block, SMALL_BLOCK_SIZE);
+  }
+
+  CHECK(Slab_Allocator::getStats().used_bytes == 0);
+  CHECK(Slab_Allocator::getStats().reserved_bytes == JCVM_MAX_HEAP_SIZE);
+
+  Slab_Allocator::releaseEmptySlabs();
+
+  CHECK(Slab_Allocator::getStats().reserved_bytes == 0);
+  CHECK(Slab_Allocator::getStats().size_classes[0].nb_slabs == 0);
+
+  return true;
+}
+
+/**
+ * The empty slabs of a size class are released for the allocations of
+ * another size class, and the slabs with allocated blocks are kept.
+ */
+static bool testSlabReuse() {
+  std::vector<void *> blocks;
+
+  for (size_t index = 0; index < (JCVM_MAX_HEAP_SIZE / SMALL_BLOCK_SIZE);
+       index++) {
+    blocks.push_back(Slab_Allocator::allocate(SMALL_BLOCK_SIZE));
+  }
+
+  // The first slab keeps a block.
+  for (size_t index = 1; index < blocks.size(); index++) {
+    Slab_Allocator::deallocate(blocks[index], SMALL_BLOCK_SIZE);
+  }
+
+  void *big_block = Slab_Allocator::allocate(JCVM_MAX_HEAP_SIZE - SLAB_SIZE);
+
+  CHECK(Slab_Allocator::getStats().size_classes[0].nb_slabs == 1);
+  CHECK(Slab_Allocator::getStats().reserved_bytes == JCVM_MAX_HEAP_SIZE);
+
+  // The blocks of the kept slab are still allocated.
+  std::vector<void *> small_blocks;
+
+  for (size_t index = 1; index < (SLAB_SIZE / SMALL_BLOCK_SIZE); index++) {
+    small_blocks.push_back(Slab_Allocator::allocate(SMALL_BLOCK_SIZE));
+  }
+
+  CHECK_THROWS(Slab_Allocator::allocate(SMALL_BLOCK_SIZE),
+               Exceptions::FullMemoryException);
+
+  for (void *block : small_blocks) {
+    Slab_Allocator::deallocate(block, SMALL_BLOCK_SIZE);
+  }
+
+  Slab_Allocator::deallocate(blocks[0], SMALL_BLOCK_SIZE);
+  Slab_Allocator::deallocate(big_block, JCVM_MAX_HEAP_SIZE - SLAB_SIZE);
+  Slab_Allocator::releaseEmptySlabs();
+
+  CHECK(Slab_Allocator::getStats().reserved_bytes == 0);
+
+  return true;
+}
+
+int main() {
+  bool isPassed = true;
+
+  RUN_TEST(testSlabSize, isPassed);
+  RUN_TEST(testReservedBytes, isPassed);
+  RUN_TEST(testSlabReuse, isPassed);
+
+  return isPassed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
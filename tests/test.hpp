@@ -0,0 +1,70 @@
+/*
+** The MIT License (MIT)
+**
+** Copyright (c) 2020, National Cybersecurity Agency of France (ANSSI)
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+** Author:
+**   - Guillaume Bouffard <guillaume.bouffard@ssi.gouv.fr>
+*/
+
+
+#ifndef _TEST_HPP
+#define _TEST_HPP
+
+#include <cstdio>
+#include <cstdlib>
+
+/*
+ * Minimal checks of the unit tests: a test is a function returning true if
+ * all its checks pass. A failed check is reported and fails its test.
+ */
+
+/// Check a condition, and fail the running test if it is false.
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__,   \
+                   #condition);                                                \
+      return false;                                                            \
+    }                                                                          \
+  } while (0)
+
+/// Check that a statement throws a JCVM exception.
+#define CHECK_THROWS(statement, exception)                                     \
+  do {                                                                         \
+    bool isThrown = false;                                                     \
+    try {                                                                      \
+      statement;                                                               \
+    } catch (const jcvm::Exceptions e) {                                       \
+      isThrown = (e == (exception));                                           \
+    }                                                                          \
+    CHECK(isThrown && #statement);                                             \
+  } while (0)
+
+/// Run a test and report its result.
+#define RUN_TEST(test, isPassed)                                               \
+  do {                                                                         \
+    const bool isTestPassed = (test)();                                        \
+    std::printf("%s: %s\n", #test, isTestPassed ? "passed" : "FAILED");        \
+    (isPassed) = (isPassed) && isTestPassed;                                   \
+  } while (0)
+
+#endif /* _TEST_HPP */